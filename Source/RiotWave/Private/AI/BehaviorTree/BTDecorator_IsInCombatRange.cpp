@@ -0,0 +1,30 @@
+// BTDecorator_IsInCombatRange.cpp - Implements the observer based combat range check
+
+#include "AI/BehaviorTree/BTDecorator_IsInCombatRange.h"
+
+#include "AI/EnemyBlackboardKeys.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+
+
+UBTDecorator_IsInCombatRange::UBTDecorator_IsInCombatRange() {
+	NodeName = TEXT("Is In Combat Range");
+
+	BlackboardKey.AllowedTypes.Reset();
+	BlackboardKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_IsInCombatRange, BlackboardKey));
+	BlackboardKey.SelectedKeyName = EnemyBlackboardKeys::IsInCombatRange;
+
+	FlowAbortMode = EBTFlowAbortMode::Both;
+}
+
+
+bool UBTDecorator_IsInCombatRange::CalculateRawConditionValue( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) const {
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	return Blackboard && Blackboard->GetValue<UBlackboardKeyType_Bool>(GetSelectedBlackboardKey());
+}
+
+
+FString UBTDecorator_IsInCombatRange::GetStaticDescription() const {
+	return FString::Printf(TEXT("%s: %s is %s"), *Super::GetStaticDescription(), *BlackboardKey.SelectedKeyName.ToString(), IsInversed() ? TEXT("false") : TEXT("true"));
+}
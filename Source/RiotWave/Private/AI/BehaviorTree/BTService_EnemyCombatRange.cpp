@@ -0,0 +1,56 @@
+// BTService_EnemyCombatRange.cpp - Implements the interval based combat state check
+
+#include "AI/BehaviorTree/BTService_EnemyCombatRange.h"
+
+#include "AIController.h"
+#include "AI/EnemyBlackboardKeys.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+
+UBTService_EnemyCombatRange::UBTService_EnemyCombatRange() {
+	NodeName = TEXT("Enemy Combat Range");
+	Interval = 0.5f;
+	RandomDeviation = 0.1f;
+	bNotifyBecomeRelevant = false;
+	bNotifyCeaseRelevant = false;
+
+	TargetKey.SelectedKeyName = EnemyBlackboardKeys::Target;
+	TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_EnemyCombatRange, TargetKey), AActor::StaticClass());
+}
+
+
+void UBTService_EnemyCombatRange::InitializeFromAsset( UBehaviorTree& Asset ) {
+	Super::InitializeFromAsset(Asset);
+
+	if ( const UBlackboardData* BlackboardAsset = GetBlackboardAsset() ) {
+		TargetKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+
+void UBTService_EnemyCombatRange::TickNode( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const float DeltaSeconds ) {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UBTService_EnemyCombatRange::TickNode);
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	const AAIController* AIController = OwnerComp.GetAIOwner();
+	const APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+	if ( !Blackboard || !Pawn ) { return; }
+
+	const FBlackboard::FKey TargetKeyId = TargetKey.GetSelectedKeyID();
+	const AActor* Target = Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(TargetKeyId));
+	if ( !Target ) { return; }
+
+	// Combat range itself is left to the proximity channel; see the class comment
+	if ( FVector::DistSquared(Pawn->GetActorLocation(), Target->GetActorLocation()) > FMath::Square(LoseTargetDistance) ) {
+		Blackboard->ClearValue(TargetKeyId);
+	}
+}
+
+
+FString UBTService_EnemyCombatRange::GetStaticDescription() const {
+	return FString::Printf(TEXT("%s\nLose target beyond %.0f"), *Super::GetStaticDescription(), LoseTargetDistance);
+}
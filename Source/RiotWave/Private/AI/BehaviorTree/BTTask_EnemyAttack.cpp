@@ -0,0 +1,64 @@
+// BTTask_EnemyAttack.cpp - Implements the montage-driven attack task
+
+#include "AI/BehaviorTree/BTTask_EnemyAttack.h"
+
+#include "AIController.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimMontage.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Enemy/Enemy.h"
+
+
+UBTTask_EnemyAttack::UBTTask_EnemyAttack() {
+	NodeName = TEXT("Enemy Attack");
+	bNotifyTick = false;
+	bCreateNodeInstance = true;
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyAttack::ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	const AAIController* AIController = OwnerComp.GetAIOwner();
+	AEnemy* Enemy = AIController ? Cast<AEnemy>(AIController->GetPawn()) : nullptr;
+	if ( !Enemy || Enemy->IsDead() || !Enemy->PlayAttackMontage() ) { return EBTNodeResult::Failed; }
+
+	OwnerComponent = &OwnerComp;
+	AttackingEnemy = Enemy;
+
+	Enemy->GetMesh()->GetAnimInstance()->OnMontageEnded.AddUniqueDynamic(this, &UBTTask_EnemyAttack::OnMontageEnded);
+
+	return EBTNodeResult::InProgress;
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyAttack::AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	ClearMontageEndDelegate();
+
+	if ( AEnemy* Enemy = AttackingEnemy.Get() ) { Enemy->StopAttackMontage(AbortBlendOutTime); }
+
+	AttackingEnemy.Reset();
+	OwnerComponent = nullptr;
+	return EBTNodeResult::Aborted;
+}
+
+
+void UBTTask_EnemyAttack::OnMontageEnded( UAnimMontage* Montage, const bool bInterrupted ) {
+	// Other montages end on the same event, and a restarted attack reports its interrupted predecessor
+	const AEnemy* Enemy = AttackingEnemy.Get();
+	if ( Enemy && ( Montage != Enemy->GetAttackMontage() || Enemy->GetMesh()->GetAnimInstance()->Montage_IsPlaying(Montage) ) ) { return; }
+
+	ClearMontageEndDelegate();
+	UBehaviorTreeComponent* OwnerComp = OwnerComponent;
+	AttackingEnemy.Reset();
+	OwnerComponent = nullptr;
+
+	if ( OwnerComp ) { FinishLatentTask(*OwnerComp, bInterrupted ? EBTNodeResult::Failed : EBTNodeResult::Succeeded); }
+}
+
+
+void UBTTask_EnemyAttack::ClearMontageEndDelegate() {
+	const AEnemy* Enemy = AttackingEnemy.Get();
+	UAnimInstance* AnimInstance = Enemy ? Enemy->GetMesh()->GetAnimInstance() : nullptr;
+	if ( !AnimInstance ) { return; }
+
+	AnimInstance->OnMontageEnded.RemoveDynamic(this, &UBTTask_EnemyAttack::OnMontageEnded);
+}
@@ -0,0 +1,18 @@
+// BTTask_EnemyChase.cpp - Defaults for the enemy chase task
+
+#include "AI/BehaviorTree/BTTask_EnemyChase.h"
+
+#include "AI/EnemyBlackboardKeys.h"
+
+
+UBTTask_EnemyChase::UBTTask_EnemyChase( const FObjectInitializer& ObjectInitializer ) :
+	Super(ObjectInitializer) {
+	NodeName = TEXT("Enemy Chase");
+
+	BlackboardKey.AllowedTypes.Reset();
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyChase, BlackboardKey), AActor::StaticClass());
+	BlackboardKey.SelectedKeyName = EnemyBlackboardKeys::Target;
+
+	AcceptableRadius = 150.0f;
+	bAllowPartialPath = true;
+}
@@ -0,0 +1,95 @@
+// BTTask_EnemyFlowChase.cpp - Implements flow field steering with a pathfinding fallback
+
+#include "AI/BehaviorTree/BTTask_EnemyFlowChase.h"
+
+#include "AIController.h"
+#include "AI/EnemyBlackboardKeys.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "Navigation/FlowFieldSubsystem.h"
+
+
+UBTTask_EnemyFlowChase::UBTTask_EnemyFlowChase() {
+	NodeName = TEXT("Enemy Flow Chase");
+	bNotifyTick = true;
+
+	TargetKey.SelectedKeyName = EnemyBlackboardKeys::Target;
+	TargetKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyFlowChase, TargetKey), AActor::StaticClass());
+}
+
+
+void UBTTask_EnemyFlowChase::InitializeFromAsset( UBehaviorTree& Asset ) {
+	Super::InitializeFromAsset(Asset);
+
+	if ( const UBlackboardData* BlackboardAsset = GetBlackboardAsset() ) {
+		TargetKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+
+uint16 UBTTask_EnemyFlowChase::GetInstanceMemorySize() const {
+	return sizeof(FFlowChaseMemory);
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyFlowChase::ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	FFlowChaseMemory* Memory = CastInstanceNodeMemory<FFlowChaseMemory>(NodeMemory);
+	Memory->bPathfinding = false;
+	return UpdateChase(OwnerComp, *Memory);
+}
+
+
+void UBTTask_EnemyFlowChase::TickTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const float DeltaSeconds ) {
+	FFlowChaseMemory* Memory = CastInstanceNodeMemory<FFlowChaseMemory>(NodeMemory);
+
+	const EBTNodeResult::Type Result = UpdateChase(OwnerComp, *Memory);
+	if ( Result != EBTNodeResult::InProgress ) {
+		if ( Memory->bPathfinding ) {
+			OwnerComp.GetAIOwner()->StopMovement();
+			Memory->bPathfinding = false;
+		}
+		FinishLatentTask(OwnerComp, Result);
+	}
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyFlowChase::UpdateChase( UBehaviorTreeComponent& OwnerComp, FFlowChaseMemory& Memory ) const {
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	APawn* Pawn = AIController ? AIController->GetPawn() : nullptr;
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if ( !Pawn || !Blackboard ) { return EBTNodeResult::Failed; }
+
+	AActor* Target = Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(TargetKey.GetSelectedKeyID()));
+	if ( !Target ) { return EBTNodeResult::Failed; }
+
+	const FVector PawnLocation = Pawn->GetActorLocation();
+	if ( FVector::DistSquared2D(PawnLocation, Target->GetActorLocation()) <= FMath::Square(AcceptableRadius) ) {
+		return EBTNodeResult::Succeeded;
+	}
+
+	FVector Direction;
+	UFlowFieldSubsystem* FlowFields = Pawn->GetWorld()->GetSubsystem<UFlowFieldSubsystem>();
+	if ( FlowFields && FlowFields->SampleDirection(Target, PawnLocation, Direction) ) {
+		if ( Memory.bPathfinding ) {
+			AIController->StopMovement();
+			Memory.bPathfinding = false;
+		}
+		Pawn->AddMovementInput(Direction);
+		return EBTNodeResult::InProgress;
+	}
+
+	// Off the field: one MoveTo that follows the actor, kept until the enemy is back on the field
+	if ( !Memory.bPathfinding ) {
+		if ( AIController->MoveToActor(Target, AcceptableRadius) == EPathFollowingRequestResult::Failed ) { return EBTNodeResult::Failed; }
+		Memory.bPathfinding = true;
+	}
+	return EBTNodeResult::InProgress;
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyFlowChase::AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	if ( AAIController* AIController = OwnerComp.GetAIOwner() ) { AIController->StopMovement(); }
+	CastInstanceNodeMemory<FFlowChaseMemory>(NodeMemory)->bPathfinding = false;
+	return EBTNodeResult::Aborted;
+}
@@ -0,0 +1,130 @@
+// BTTask_EnemyPatrol.cpp - Implements the event-driven patrol task
+
+#include "AI/BehaviorTree/BTTask_EnemyPatrol.h"
+
+#include "AIController.h"
+#include "AI/EnemyBlackboardKeys.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Enemy/Enemy.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "Patrol/PatrolRouteSubsystem.h"
+
+
+UBTTask_EnemyPatrol::UBTTask_EnemyPatrol() {
+	NodeName = TEXT("Enemy Patrol");
+	bNotifyTick = false;
+
+	PatrolPointKey.SelectedKeyName = EnemyBlackboardKeys::PatrolPoint;
+	PatrolPointKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyPatrol, PatrolPointKey));
+
+	PatrolPoint2Key.SelectedKeyName = EnemyBlackboardKeys::PatrolPoint2;
+	PatrolPoint2Key.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyPatrol, PatrolPoint2Key));
+}
+
+
+void UBTTask_EnemyPatrol::InitializeFromAsset( UBehaviorTree& Asset ) {
+	Super::InitializeFromAsset(Asset);
+
+	if ( const UBlackboardData* BlackboardAsset = GetBlackboardAsset() ) {
+		PatrolPointKey.ResolveSelectedKey(*BlackboardAsset);
+		PatrolPoint2Key.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+
+uint16 UBTTask_EnemyPatrol::GetInstanceMemorySize() const {
+	return sizeof(FPatrolMemory);
+}
+
+
+void UBTTask_EnemyPatrol::InitializeMemory( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const EBTMemoryInit::Type InitType ) const {
+	InitializeNodeMemory<FPatrolMemory>(NodeMemory, InitType);
+}
+
+
+void UBTTask_EnemyPatrol::CleanupMemory( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const EBTMemoryClear::Type CleanupType ) const {
+	CleanupNodeMemory<FPatrolMemory>(NodeMemory, CleanupType);
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyPatrol::ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	const AEnemy* Enemy = AIController ? Cast<AEnemy>(AIController->GetPawn()) : nullptr;
+	UPatrolRouteSubsystem* PatrolRoutes = AIController ? AIController->GetWorld()->GetSubsystem<UPatrolRouteSubsystem>() : nullptr;
+	if ( !Enemy || !Blackboard || !PatrolRoutes ) { return EBTNodeResult::Failed; }
+
+	// Looked up per leg: the loose point cache may have evicted the route, and patrol points change when enemies are reused
+	const FPatrolRoutePath* Route = Enemy->GetPatrolRoute()
+		? PatrolRoutes->FindOrBuildRoute(Enemy->GetPatrolRoute())
+		: PatrolRoutes->FindOrBuildRoute({
+			Blackboard->GetValue<UBlackboardKeyType_Vector>(PatrolPointKey.GetSelectedKeyID()),
+			Blackboard->GetValue<UBlackboardKeyType_Vector>(PatrolPoint2Key.GetSelectedKeyID())
+		}, false);
+	if ( !Route ) { return EBTNodeResult::Failed; }
+
+	FPatrolMemory* Memory = CastInstanceNodeMemory<FPatrolMemory>(NodeMemory);
+	if ( !Route->Legs.IsValidIndex(Memory->LegIndex) ) {
+		return RejoinRoute(OwnerComp, *Memory, Route->GetLegStart(0), 0);
+	}
+
+	const int32 LegIndex = Memory->LegIndex;
+	const int32 NextLegIndex = Route->GetNextLeg(LegIndex);
+	if ( FVector::DistSquared2D(Enemy->GetActorLocation(), Route->GetLegStart(LegIndex)) > FMath::Square(RejoinDistance) ) {
+		return RejoinRoute(OwnerComp, *Memory, Route->GetLegEnd(LegIndex), NextLegIndex);
+	}
+
+	const FAIRequestID RequestID = PatrolRoutes->RequestLegMove(AIController, *Route, LegIndex, AcceptanceRadius);
+	if ( !RequestID.IsValid() ) {
+		// No cached path for this leg; walking it with a query is better than standing still
+		return RejoinRoute(OwnerComp, *Memory, Route->GetLegEnd(LegIndex), NextLegIndex);
+	}
+
+	Memory->PendingLegIndex = NextLegIndex;
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, RequestID);
+	return EBTNodeResult::InProgress;
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyPatrol::RejoinRoute( UBehaviorTreeComponent& OwnerComp, FPatrolMemory& Memory, const FVector& Goal, const int32 NextLegIndex ) const {
+	FAIMoveRequest MoveRequest(Goal);
+	MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
+
+	const FPathFollowingRequestResult Result = OwnerComp.GetAIOwner()->MoveTo(MoveRequest);
+	switch ( Result.Code ) {
+		case EPathFollowingRequestResult::AlreadyAtGoal:
+			Memory.LegIndex = NextLegIndex;
+			return EBTNodeResult::Succeeded;
+
+		case EPathFollowingRequestResult::RequestSuccessful:
+			Memory.PendingLegIndex = NextLegIndex;
+			WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, Result.MoveId);
+			return EBTNodeResult::InProgress;
+
+		default:
+			return EBTNodeResult::Failed;
+	}
+}
+
+
+void UBTTask_EnemyPatrol::OnMessage( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const FName Message, const int32 RequestID, const bool bSuccess ) {
+	if ( bSuccess && Message == UBrainComponent::AIMessage_MoveFinished ) {
+		FPatrolMemory* Memory = CastInstanceNodeMemory<FPatrolMemory>(NodeMemory);
+		Memory->LegIndex = Memory->PendingLegIndex;
+	}
+
+	Super::OnMessage(OwnerComp, NodeMemory, Message, RequestID, bSuccess);
+}
+
+
+EBTNodeResult::Type UBTTask_EnemyPatrol::AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) {
+	if ( AAIController* AIController = OwnerComp.GetAIOwner() ) { AIController->StopMovement(); }
+	return EBTNodeResult::Aborted;
+}
+
+
+FString UBTTask_EnemyPatrol::GetStaticDescription() const {
+	return FString::Printf(TEXT("%s: route or %s <-> %s"), *Super::GetStaticDescription(), *PatrolPointKey.SelectedKeyName.ToString(), *PatrolPoint2Key.SelectedKeyName.ToString());
+}
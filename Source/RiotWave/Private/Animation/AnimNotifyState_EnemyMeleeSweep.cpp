@@ -0,0 +1,25 @@
+// AnimNotifyState_EnemyMeleeSweep.cpp - Forwards the notify window to the enemy
+
+#include "Animation/AnimNotifyState_EnemyMeleeSweep.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Enemy/Enemy.h"
+
+
+void UAnimNotifyState_EnemyMeleeSweep::NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const float TotalDuration, const FAnimNotifyEventReference& EventReference ) {
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+
+	if ( AEnemy* Enemy = MeshComp ? Cast<AEnemy>(MeshComp->GetOwner()) : nullptr ) { Enemy->ActivateWeaponCollision(); }
+}
+
+
+void UAnimNotifyState_EnemyMeleeSweep::NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference ) {
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+
+	if ( AEnemy* Enemy = MeshComp ? Cast<AEnemy>(MeshComp->GetOwner()) : nullptr ) { Enemy->DeactivateWeaponCollision(); }
+}
+
+
+FString UAnimNotifyState_EnemyMeleeSweep::GetNotifyName_Implementation() const {
+	return TEXT("Enemy Melee Sweep");
+}
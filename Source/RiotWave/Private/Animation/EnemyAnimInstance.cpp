@@ -0,0 +1,65 @@
+// EnemyAnimInstance.cpp - Thread-safe state gathering and attack montage API for enemies
+
+#include "Animation/EnemyAnimInstance.h"
+
+#include "Enemy/Enemy.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+
+void UEnemyAnimInstance::NativeInitializeAnimation() {
+	Super::NativeInitializeAnimation();
+
+	Enemy = Cast<AEnemy>(TryGetPawnOwner());
+	MovementComponent = Enemy ? Enemy->GetCharacterMovement() : nullptr;
+
+	// The instance-wide event leaves each montage's own end delegate free for other listeners
+	OnMontageEnded.AddUniqueDynamic(this, &UEnemyAnimInstance::OnAttackMontageEnded);
+}
+
+
+void UEnemyAnimInstance::NativeUpdateAnimation( const float DeltaSeconds ) {
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	// Plain copies only; this runs on the game thread for every enemy
+	if ( !Enemy || !MovementComponent ) { return; }
+
+	GameThreadVelocity = MovementComponent->Velocity;
+	bGameThreadInAttackRange = Enemy->IsInAttackRange();
+	bGameThreadDead = Enemy->IsDead();
+}
+
+
+void UEnemyAnimInstance::NativeThreadSafeUpdateAnimation( const float DeltaSeconds ) {
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	Speed = GameThreadVelocity.Size2D();
+	bIsInCombatRange = bGameThreadInAttackRange;
+	bIsDead = bGameThreadDead;
+	bIsAttacking = bGameThreadAttacking;
+}
+
+
+float UEnemyAnimInstance::PlayAttackMontage( UAnimMontage* Montage, const float PlayRate ) {
+	if ( !Montage ) { return 0.0f; }
+
+	const float Length = Montage_Play(Montage, PlayRate);
+	if ( Length <= 0.0f ) { return 0.0f; }
+
+	ActiveAttackMontage = Montage;
+	bGameThreadAttacking = true;
+	return Length;
+}
+
+
+void UEnemyAnimInstance::StopAttackMontage( const float BlendOutTime ) {
+	if ( ActiveAttackMontage ) { Montage_Stop(BlendOutTime, ActiveAttackMontage); }
+}
+
+
+void UEnemyAnimInstance::OnAttackMontageEnded( UAnimMontage* Montage, const bool bInterrupted ) {
+	// Back to back attacks restart the montage; the interrupted instance must not clear the new one
+	if ( Montage != ActiveAttackMontage || Montage_IsPlaying(Montage) ) { return; }
+
+	ActiveAttackMontage = nullptr;
+	bGameThreadAttacking = false;
+}
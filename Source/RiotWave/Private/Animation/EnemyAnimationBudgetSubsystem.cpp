@@ -0,0 +1,226 @@
+// EnemyAnimationBudgetSubsystem.cpp - Implements enemy mesh significance and rate tier counters
+
+#include "Animation/EnemyAnimationBudgetSubsystem.h"
+
+#include "AnimationBudgetAllocatorParameters.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "IAnimationBudgetAllocator.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+#include "SkeletalMeshComponentBudgeted.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Meshes At Full Rate"), STAT_EnemyMeshesFullRate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Meshes At Half Rate"), STAT_EnemyMeshesHalfRate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Meshes At Quarter Rate"), STAT_EnemyMeshesQuarterRate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Meshes At Low Rate"), STAT_EnemyMeshesLowRate, STATGROUP_Game);
+
+static int32 GAnimBudgetEnabled = 1;
+static FAutoConsoleVariableRef CVarAnimBudgetEnabled(
+	TEXT("RiotWave.AnimBudget.Enabled"),
+	GAnimBudgetEnabled,
+	TEXT("1 = enemy meshes are budgeted by the Animation Budget Allocator, 0 = plain update rate optimizations."),
+	ECVF_Default
+);
+
+static float GAnimBudgetMs = 0.0f;
+static FAutoConsoleVariableRef CVarAnimBudgetMs(
+	TEXT("RiotWave.AnimBudget.BudgetMs"),
+	GAnimBudgetMs,
+	TEXT("Milliseconds per frame the allocator may spend on enemy meshes. 0 = use BudgetMs from the game config."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GAnimBudgetStatsCommand(
+	TEXT("RiotWave.AnimBudget.Stats"),
+	TEXT("Prints how many enemy meshes were evaluated at each update rate tier during the last frame."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UEnemyAnimationBudgetSubsystem* AnimBudget = World ? World->GetSubsystem<UEnemyAnimationBudgetSubsystem>() : nullptr ) { AnimBudget->LogStats(); }
+	})
+);
+
+namespace {
+	void GatherPlayerLocations( const UWorld* World, TArray<FVector>& OutLocations ) {
+		for ( FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It ) {
+			if ( const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr ) { OutLocations.Add(Pawn->GetActorLocation()); }
+		}
+	}
+}
+
+
+bool UEnemyAnimationBudgetSubsystem::IsBudgetEnabled() {
+	return GAnimBudgetEnabled != 0;
+}
+
+
+bool UEnemyAnimationBudgetSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UEnemyAnimationBudgetSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::OnWorldBeginPlay( UWorld& InWorld ) {
+	Super::OnWorldBeginPlay(InWorld);
+	ApplyAllocatorSettings();
+}
+
+
+void UEnemyAnimationBudgetSubsystem::RegisterEnemy( AEnemy* Enemy ) {
+	if ( Enemy ) { Enemies.AddUnique(Enemy); }
+}
+
+
+void UEnemyAnimationBudgetSubsystem::UnregisterEnemy( AEnemy* Enemy ) {
+	Enemies.RemoveSwap(Enemy, EAllowShrinking::No);
+
+	// A mesh about to be destroyed unregisters itself; it must not be handed back on ResumeEnemy
+	SuspendedEnemies.RemoveSwap(Enemy, EAllowShrinking::No);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::RefreshEnemy( AEnemy* Enemy ) {
+	if ( !Enemy ) { return; }
+
+	TArray<FVector> PlayerLocations;
+	GatherPlayerLocations(GetWorld(), PlayerLocations);
+	ApplySignificance(*Enemy, PlayerLocations);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::SuspendEnemy( AEnemy* Enemy ) {
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Enemy ? Cast<USkeletalMeshComponentBudgeted>(Enemy->GetMesh()) : nullptr;
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if ( !BudgetedMesh || !Allocator || BudgetedMesh->GetAnimationBudgetHandle() == INDEX_NONE ) { return; }
+
+	Allocator->UnregisterComponent(BudgetedMesh);
+	SuspendedEnemies.AddUnique(Enemy);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::ResumeEnemy( AEnemy* Enemy ) {
+	if ( !Enemy || SuspendedEnemies.RemoveSwap(Enemy, EAllowShrinking::No) == 0 ) { return; }
+
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Enemy->GetMesh());
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if ( !BudgetedMesh || !Allocator || BudgetedMesh->GetAnimationBudgetHandle() != INDEX_NONE ) { return; }
+
+	Allocator->RegisterComponent(BudgetedMesh);
+	RefreshEnemy(Enemy);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::ApplyAllocatorSettings() {
+	IAnimationBudgetAllocator* Allocator = IAnimationBudgetAllocator::Get(GetWorld());
+	if ( !Allocator ) { return; }
+
+	const float DesiredBudgetMs = GAnimBudgetMs > 0.0f ? GAnimBudgetMs : BudgetMs;
+	if ( DesiredBudgetMs != AppliedBudgetMs ) {
+		FAnimationBudgetAllocatorParameters Parameters;
+		Parameters.BudgetInMs = DesiredBudgetMs;
+		Allocator->SetParameters(Parameters);
+		AppliedBudgetMs = DesiredBudgetMs;
+	}
+
+	if ( AppliedEnabled != GAnimBudgetEnabled ) {
+		Allocator->SetEnabled(IsBudgetEnabled());
+		AppliedEnabled = GAnimBudgetEnabled;
+	}
+}
+
+
+void UEnemyAnimationBudgetSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UEnemyAnimationBudgetSubsystem::Tick);
+
+	ApplyAllocatorSettings();
+
+	TArray<FVector> PlayerLocations;
+	GatherPlayerLocations(GetWorld(), PlayerLocations);
+
+	FMemory::Memzero(TierCounts);
+	InactiveCount = 0;
+
+	for ( int32 Index = Enemies.Num() - 1; Index >= 0; --Index ) {
+		AEnemy* Enemy = Enemies[Index].Get();
+		if ( !Enemy ) {
+			Enemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// Parked pool members and enemies following a shared leader pose do not evaluate their own mesh
+		if ( Enemy->IsHidden() || ( Enemy->GetMesh() && Enemy->GetMesh()->LeaderPoseComponent.IsValid() ) ) {
+			++InactiveCount;
+			continue;
+		}
+
+		// The rate read here is the one the allocator picked during the previous frame
+		const int32 UpdateRate = GetUpdateRate(*Enemy);
+		const EAnimRateTier Tier = UpdateRate <= 1 ? EAnimRateTier::Full
+			: UpdateRate == 2 ? EAnimRateTier::Half
+			: UpdateRate <= 4 ? EAnimRateTier::Quarter
+			: EAnimRateTier::Low;
+		++TierCounts[static_cast<int32>(Tier)];
+
+		ApplySignificance(*Enemy, PlayerLocations);
+	}
+
+	SET_DWORD_STAT(STAT_EnemyMeshesFullRate, TierCounts[static_cast<int32>(EAnimRateTier::Full)]);
+	SET_DWORD_STAT(STAT_EnemyMeshesHalfRate, TierCounts[static_cast<int32>(EAnimRateTier::Half)]);
+	SET_DWORD_STAT(STAT_EnemyMeshesQuarterRate, TierCounts[static_cast<int32>(EAnimRateTier::Quarter)]);
+	SET_DWORD_STAT(STAT_EnemyMeshesLowRate, TierCounts[static_cast<int32>(EAnimRateTier::Low)]);
+}
+
+
+void UEnemyAnimationBudgetSubsystem::ApplySignificance( AEnemy& Enemy, const TArray<FVector>& PlayerLocations ) const {
+	USkeletalMeshComponent* Mesh = Enemy.GetMesh();
+	if ( !Mesh ) { return; }
+
+	// The hit box rides on the weapon socket, so a swinging enemy needs its pose every frame, seen or not
+	const bool bIsAttacking = Enemy.IsWeaponCollisionActive();
+
+	USkeletalMeshComponentBudgeted* BudgetedMesh = Cast<USkeletalMeshComponentBudgeted>(Mesh);
+	if ( !IsBudgetEnabled() || !BudgetedMesh || BudgetedMesh->GetAnimationBudgetHandle() == INDEX_NONE ) {
+		Mesh->bEnableUpdateRateOptimizations = !bIsAttacking;
+		return;
+	}
+
+	// The allocator drives the tick rate itself; update rate optimizations would fight it
+	Mesh->bEnableUpdateRateOptimizations = false;
+
+	float ClosestDistSquared = MAX_flt;
+	const FVector Location = Enemy.GetActorLocation();
+	for ( const FVector& PlayerLocation : PlayerLocations ) {
+		ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(Location, PlayerLocation));
+	}
+
+	float Significance = 1.0f - FMath::Clamp(FMath::Sqrt(ClosestDistSquared) / MaxSignificanceDistance, 0.0f, 1.0f);
+	if ( !Mesh->WasRecentlyRendered(RecentlyRenderedTolerance) ) { Significance *= OffscreenSignificanceScale; }
+
+	BudgetedMesh->SetComponentSignificance(bIsAttacking ? 1.0f : Significance, bIsAttacking, bIsAttacking);
+}
+
+
+int32 UEnemyAnimationBudgetSubsystem::GetUpdateRate( const AEnemy& Enemy ) {
+	const USkeletalMeshComponent* Mesh = Enemy.GetMesh();
+	if ( !Mesh ) { return 1; }
+
+	if ( Mesh->IsUsingExternalTickRateControl() ) { return FMath::Max<int32>(Mesh->GetExternalTickRate(), 1); }
+	if ( Mesh->bEnableUpdateRateOptimizations && Mesh->AnimUpdateRateParams ) { return FMath::Max(Mesh->AnimUpdateRateParams->UpdateRate, 1); }
+	return 1;
+}
+
+
+void UEnemyAnimationBudgetSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("AnimBudget: Enabled=%d BudgetMs=%.2f Enemies=%d Full=%d Half=%d Quarter=%d Low=%d Inactive=%d"),
+		GAnimBudgetEnabled, AppliedBudgetMs, Enemies.Num(),
+		TierCounts[static_cast<int32>(EAnimRateTier::Full)], TierCounts[static_cast<int32>(EAnimRateTier::Half)],
+		TierCounts[static_cast<int32>(EAnimRateTier::Quarter)], TierCounts[static_cast<int32>(EAnimRateTier::Low)], InactiveCount);
+}
@@ -0,0 +1,225 @@
+// EnemyPoseSharingSubsystem.cpp - Implements leader creation and follower switching
+//
+// A follower's mesh component stops ticking and reads its bone transforms from the leader,
+// which is a hidden mesh in single-node mode looping one sequence. Switching is a pointer
+// change on both sides, so it is cheap enough to re-decide for every enemy each frame.
+// Followers also leave the animation budget allocator, which would otherwise keep toggling
+// the tick of a mesh that has nothing of its own to evaluate.
+
+#include "Animation/EnemyPoseSharingSubsystem.h"
+
+#include "Animation/EnemyAnimationBudgetSubsystem.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimSequenceBase.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Controller/EnemyController/EnemyController.h"
+#include "Enemy/Enemy.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Pose Sharing Update"), STAT_EnemyPoseSharingUpdate, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Pose Followers"), STAT_EnemyPoseFollowers, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Bones Evaluated"), STAT_EnemyBonesEvaluated, STATGROUP_Game);
+
+static int32 GPoseSharingEnabled = 1;
+static FAutoConsoleVariableRef CVarPoseSharingEnabled(
+	TEXT("RiotWave.PoseSharing.Enabled"),
+	GPoseSharingEnabled,
+	TEXT("1 = distant enemies copy their pose from shared leader meshes, 0 = every enemy evaluates its own anim graph."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GPoseSharingStatsCommand(
+	TEXT("RiotWave.PoseSharing.Stats"),
+	TEXT("Prints leader, follower and locally animated enemy counts and the bones evaluated per frame."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UEnemyPoseSharingSubsystem* PoseSharing = World ? World->GetSubsystem<UEnemyPoseSharingSubsystem>() : nullptr ) { PoseSharing->LogStats(); }
+	})
+);
+
+
+bool UEnemyPoseSharingSubsystem::IsPoseSharingEnabled() {
+	return GPoseSharingEnabled != 0;
+}
+
+
+bool UEnemyPoseSharingSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UEnemyPoseSharingSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyPoseSharingSubsystem, STATGROUP_Tickables);
+}
+
+
+void UEnemyPoseSharingSubsystem::Deinitialize() {
+	if ( LeaderActor ) { LeaderActor->Destroy(); }
+	LeaderActor = nullptr;
+	Leaders.Reset();
+
+	Super::Deinitialize();
+}
+
+
+void UEnemyPoseSharingSubsystem::RegisterEnemy( AEnemy* Enemy ) {
+	if ( !Enemy || Enemies.ContainsByPredicate([Enemy]( const FSharedEnemy& Shared ) { return Shared.Enemy == Enemy; }) ) { return; }
+	Enemies.AddDefaulted_GetRef().Enemy = Enemy;
+}
+
+
+void UEnemyPoseSharingSubsystem::UnregisterEnemy( AEnemy* Enemy ) {
+	const int32 Index = Enemies.IndexOfByPredicate([Enemy]( const FSharedEnemy& Shared ) { return Shared.Enemy == Enemy; });
+	if ( Index == INDEX_NONE ) { return; }
+
+	StopFollowing(Enemies[Index]);
+	Enemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+
+void UEnemyPoseSharingSubsystem::StopSharing( AEnemy* Enemy ) {
+	FSharedEnemy* Shared = Enemies.FindByPredicate([Enemy]( const FSharedEnemy& Candidate ) { return Candidate.Enemy == Enemy; });
+	if ( Shared && Shared->Leader.IsValid() ) { StopFollowing(*Shared); }
+}
+
+
+void UEnemyPoseSharingSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_EnemyPoseSharingUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UEnemyPoseSharingSubsystem::Tick);
+
+	TArray<FVector> PlayerLocations;
+	for ( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It ) {
+		if ( const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr ) { PlayerLocations.Add(Pawn->GetActorLocation()); }
+	}
+
+	FollowerCount = 0;
+	LocalCount = 0;
+	EvaluatedBones = 0;
+
+	for ( int32 Index = Enemies.Num() - 1; Index >= 0; --Index ) {
+		FSharedEnemy& Shared = Enemies[Index];
+		AEnemy* Enemy = Shared.Enemy.Get();
+		if ( !Enemy ) {
+			Enemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		float ClosestDistSquared = MAX_flt;
+		for ( const FVector& PlayerLocation : PlayerLocations ) {
+			ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(Enemy->GetActorLocation(), PlayerLocation));
+		}
+
+		USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+		USkeletalMesh* SkeletalMesh = Mesh ? Mesh->GetSkeletalMeshAsset() : nullptr;
+		UAnimSequenceBase* Animation = SkeletalMesh ? SelectSharedAnimation(*Enemy, ClosestDistSquared, Shared.Leader.IsValid()) : nullptr;
+
+		if ( Animation ) {
+			USkeletalMeshComponent* Leader = FindOrAddLeader(SkeletalMesh, Animation);
+			if ( Shared.Leader.Get() != Leader ) { Follow(Shared, Leader); }
+			++FollowerCount;
+		} else {
+			if ( Shared.Leader.IsValid() ) { StopFollowing(Shared); }
+			if ( !Enemy->IsHidden() && Mesh ) {
+				++LocalCount;
+				EvaluatedBones += Mesh->GetNumBones();
+			}
+		}
+	}
+
+	for ( const TPair<FLeaderKey, TObjectPtr<USkeletalMeshComponent>>& Leader : Leaders ) {
+		if ( Leader.Value ) { EvaluatedBones += Leader.Value->GetNumBones(); }
+	}
+
+	SET_DWORD_STAT(STAT_EnemyPoseFollowers, FollowerCount);
+	SET_DWORD_STAT(STAT_EnemyBonesEvaluated, EvaluatedBones);
+}
+
+
+UAnimSequenceBase* UEnemyPoseSharingSubsystem::SelectSharedAnimation( const AEnemy& Enemy, const float ClosestDistSquared, const bool bIsSharing ) const {
+	if ( !IsPoseSharingEnabled() || Enemy.IsHidden() || Enemy.IsDead() || Enemy.IsWeaponCollisionActive() ) { return nullptr; }
+
+	const float Threshold = bIsSharing ? UnshareDistance : ShareDistance;
+	if ( ClosestDistSquared < FMath::Square(Threshold) ) { return nullptr; }
+
+	// Montages (attacks, hit reactions) only advance on the enemy's own anim instance
+	const UAnimInstance* AnimInstance = Enemy.GetMesh()->GetAnimInstance();
+	if ( AnimInstance && AnimInstance->IsAnyMontagePlaying() ) { return nullptr; }
+
+	const AEnemyController* EnemyController = Cast<AEnemyController>(Enemy.GetController());
+	if ( EnemyController && EnemyController->GetTargetActor() ) { return Enemy.GetSharedChaseAnimation(); }
+	if ( Enemy.GetVelocity().SizeSquared2D() < FMath::Square(IdleSpeedThreshold) ) { return Enemy.GetSharedIdleAnimation(); }
+	return Enemy.GetSharedPatrolAnimation();
+}
+
+
+USkeletalMeshComponent* UEnemyPoseSharingSubsystem::FindOrAddLeader( USkeletalMesh* Mesh, UAnimSequenceBase* Animation ) {
+	const FLeaderKey Key{ Mesh, Animation };
+	if ( const TObjectPtr<USkeletalMeshComponent>* Existing = Leaders.Find(Key) ) { return *Existing; }
+
+	if ( !LeaderActor ) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		LeaderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// Hidden and never culled, so the leader keeps animating even though nobody sees it directly
+	USkeletalMeshComponent* Leader = NewObject<USkeletalMeshComponent>(LeaderActor);
+	Leader->SetSkeletalMesh(Mesh);
+	Leader->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Leader->SetGenerateOverlapEvents(false);
+	Leader->SetHiddenInGame(true);
+	Leader->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	if ( !LeaderActor->GetRootComponent() ) { LeaderActor->SetRootComponent(Leader); }
+	Leader->RegisterComponent();
+	LeaderActor->AddInstanceComponent(Leader);
+
+	Leader->SetAnimationMode(EAnimationMode::AnimationSingleNode);
+	Leader->PlayAnimation(Animation, true);
+
+	Leaders.Add(Key, Leader);
+	return Leader;
+}
+
+
+void UEnemyPoseSharingSubsystem::Follow( FSharedEnemy& Shared, USkeletalMeshComponent* Leader ) {
+	// Unregistered first, so disabling the tick goes to the component and not to the allocator's bookkeeping
+	if ( UEnemyAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UEnemyAnimationBudgetSubsystem>() ) {
+		AnimBudget->SuspendEnemy(Shared.Enemy.Get());
+	}
+
+	USkeletalMeshComponent* Mesh = Shared.Enemy->GetMesh();
+	Mesh->SetLeaderPoseComponent(Leader);
+	Mesh->SetComponentTickEnabled(false);
+	Shared.Leader = Leader;
+}
+
+
+void UEnemyPoseSharingSubsystem::StopFollowing( FSharedEnemy& Shared ) {
+	Shared.Leader.Reset();
+
+	AEnemy* Enemy = Shared.Enemy.Get();
+	USkeletalMeshComponent* Mesh = Enemy ? Enemy->GetMesh() : nullptr;
+	if ( !Mesh ) { return; }
+
+	Mesh->SetLeaderPoseComponent(nullptr);
+
+	if ( UEnemyAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UEnemyAnimationBudgetSubsystem>() ) {
+		AnimBudget->ResumeEnemy(Enemy);
+	}
+
+	// Parked enemies keep their mesh off; OnAcquiredFromPool turns it back on
+	if ( !Enemy->IsHidden() ) { Mesh->SetComponentTickEnabled(true); }
+}
+
+
+void UEnemyPoseSharingSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("PoseSharing: Enabled=%d Leaders=%d Followers=%d LocallyAnimated=%d EvaluatedBones=%d"),
+		GPoseSharingEnabled, Leaders.Num(), FollowerCount, LocalCount, EvaluatedBones);
+}
@@ -0,0 +1,60 @@
+// FirstPersonAnimInstance.cpp - Thread-safe state gathering and fire montage API for the player's arms
+
+#include "Animation/FirstPersonAnimInstance.h"
+
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Player/PlayerCharacter.h"
+
+
+void UFirstPersonAnimInstance::NativeInitializeAnimation() {
+	Super::NativeInitializeAnimation();
+
+	Player = Cast<APlayerCharacter>(GetOwningActor());
+	MovementComponent = Player ? Player->GetCharacterMovement() : nullptr;
+
+	// The instance-wide event leaves each montage's own end delegate free for other listeners
+	OnMontageEnded.AddUniqueDynamic(this, &UFirstPersonAnimInstance::OnFireMontageEnded);
+}
+
+
+void UFirstPersonAnimInstance::NativeUpdateAnimation( const float DeltaSeconds ) {
+	Super::NativeUpdateAnimation(DeltaSeconds);
+
+	// Game thread: the only place the player and its movement component are read
+	if ( !Player || !MovementComponent ) { return; }
+
+	GameThreadVelocity = MovementComponent->Velocity;
+	bGameThreadFalling = MovementComponent->IsFalling();
+	bGameThreadDead = Player->IsDead();
+}
+
+
+void UFirstPersonAnimInstance::NativeThreadSafeUpdateAnimation( const float DeltaSeconds ) {
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	Speed = GameThreadVelocity.Size2D();
+	bIsFalling = bGameThreadFalling;
+	bIsDead = bGameThreadDead;
+	bIsFiring = bGameThreadFiring;
+}
+
+
+float UFirstPersonAnimInstance::PlayFireMontage( UAnimMontage* Montage, const float PlayRate ) {
+	if ( !Montage ) { return 0.0f; }
+
+	const float Length = Montage_Play(Montage, PlayRate);
+	if ( Length <= 0.0f ) { return 0.0f; }
+
+	ActiveFireMontage = Montage;
+	bGameThreadFiring = true;
+	return Length;
+}
+
+
+void UFirstPersonAnimInstance::OnFireMontageEnded( UAnimMontage* Montage, const bool bInterrupted ) {
+	// Rapid fire restarts the montage; the interrupted instance must not clear the new one
+	if ( Montage != ActiveFireMontage || Montage_IsPlaying(Montage) ) { return; }
+
+	ActiveFireMontage = nullptr;
+	bGameThreadFiring = false;
+}
@@ -0,0 +1,207 @@
+// AudioEventSubsystem.cpp - Implements event merging, rate limits and the voice pool
+
+#include "Audio/AudioEventSubsystem.h"
+
+#include "Components/AudioComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "RiotWave.h"
+#include "Sound/SoundBase.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Events Submitted"), STAT_AudioEventsSubmitted, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Events Merged"), STAT_AudioEventsMerged, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Audio Events Dropped"), STAT_AudioEventsDropped, STATGROUP_Game);
+
+namespace RiotWaveSoundTags {
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Weapon_Fire, "Sound.Weapon.Fire", "Weapon fire, one event per trigger pull");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Weapon_Pickup, "Sound.Weapon.Pickup", "Weapon picked up from the world");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Enemy_Impact, "Sound.Enemy.Impact", "Bullet hitting an enemy");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Enemy_Attack, "Sound.Enemy.Attack", "Enemy melee connecting with a player");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Player_Impact, "Sound.Player.Impact", "Player taking damage");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Player_Death, "Sound.Player.Death", "Player dying");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Item_Pickup, "Sound.Item.Pickup", "Item collected");
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Item_Drop, "Sound.Item.Drop", "Item dropped into the world");
+}
+
+static int32 GAudioRouterEnabled = 1;
+static FAutoConsoleVariableRef CVarAudioRouterEnabled(
+	TEXT("RiotWave.Audio.Router"),
+	GAudioRouterEnabled,
+	TEXT("1 = one-shot sounds are merged, limited per category and played on pooled components, 0 = every sound plays through PlaySoundAtLocation."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GAudioStatsCommand(
+	TEXT("RiotWave.Audio.Stats"),
+	TEXT("Prints sound events submitted, merged, dropped and played, voices stolen and the pool size."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UAudioEventSubsystem* AudioEvents = World ? World->GetSubsystem<UAudioEventSubsystem>() : nullptr ) { AudioEvents->LogStats(); }
+	})
+);
+
+
+bool UAudioEventSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UAudioEventSubsystem::Deinitialize() {
+	if ( AudioActor ) { AudioActor->Destroy(); }
+	AudioActor = nullptr;
+	Voices.Reset();
+
+	Super::Deinitialize();
+}
+
+
+void UAudioEventSubsystem::PostSound( const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, const FGameplayTag Event ) {
+	if ( !Sound || !WorldContextObject ) { return; }
+
+	const UWorld* World = WorldContextObject->GetWorld();
+	if ( UAudioEventSubsystem* AudioEvents = World ? World->GetSubsystem<UAudioEventSubsystem>() : nullptr ) {
+		AudioEvents->PostSoundEvent(Sound, Location, Event);
+	} else {
+		UGameplayStatics::PlaySoundAtLocation(WorldContextObject, Sound, Location);
+	}
+}
+
+
+bool UAudioEventSubsystem::PostSoundEvent( USoundBase* Sound, const FVector& Location, const FGameplayTag Event ) {
+	if ( !Sound ) { return false; }
+
+	++TotalSubmitted;
+	INC_DWORD_STAT(STAT_AudioEventsSubmitted);
+
+	if ( GAudioRouterEnabled == 0 ) {
+		UGameplayStatics::PlaySoundAtLocation(this, Sound, Location);
+		++TotalPlayed;
+		return true;
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const FAudioCategoryLimits* Limits = FindLimits(Event);
+	const FGameplayTag Category = Limits ? Limits->Category : Event;
+
+	if ( MergeEvent(Sound, Location, Now) ) {
+		++TotalMerged;
+		INC_DWORD_STAT(STAT_AudioEventsMerged);
+		return false;
+	}
+
+	if ( Limits && Limits->MaxPerSecond > 0.0f && !ConsumeRateToken(Category, Limits->MaxPerSecond, Now) ) {
+		++TotalDropped;
+		INC_DWORD_STAT(STAT_AudioEventsDropped);
+		return false;
+	}
+
+	UAudioComponent* Component = AcquireVoice(Category, Limits ? Limits->MaxConcurrent : 0);
+	Component->SetSound(Sound);
+	Component->SetWorldLocation(Location);
+	Component->Play();
+	++TotalPlayed;
+
+	if ( Limits && Limits->MergeWindow > 0.0f ) {
+		RecentEvents.Add({ Sound, Location, Now, Limits->MergeWindow, Limits->MergeRadius });
+	}
+	return true;
+}
+
+
+const FAudioCategoryLimits* UAudioEventSubsystem::FindLimits( const FGameplayTag& Event ) const {
+	return Categories.FindByPredicate([&Event]( const FAudioCategoryLimits& Limits ) { return Event.MatchesTag(Limits.Category); });
+}
+
+
+bool UAudioEventSubsystem::MergeEvent( USoundBase* Sound, const FVector& Location, const double Now ) {
+	RecentEvents.RemoveAllSwap([Now]( const FRecentEvent& Recent ) { return Now - Recent.Time > Recent.MergeWindow; }, EAllowShrinking::No);
+
+	const TObjectKey<USoundBase> Key(Sound);
+	return RecentEvents.ContainsByPredicate([&]( const FRecentEvent& Recent ) {
+		return Recent.Sound == Key && FVector::DistSquared(Recent.Location, Location) <= FMath::Square(Recent.MergeRadius);
+	});
+}
+
+
+bool UAudioEventSubsystem::ConsumeRateToken( const FGameplayTag& Category, const float MaxPerSecond, const double Now ) {
+	FCategoryState& State = CategoryStates.FindOrAdd(Category);
+
+	// A full bucket allows one second's worth of events in a burst
+	if ( State.LastRefillTime < 0.0 ) { State.Tokens = MaxPerSecond; }
+	else { State.Tokens = FMath::Min(MaxPerSecond, State.Tokens + static_cast<float>(( Now - State.LastRefillTime ) * MaxPerSecond)); }
+	State.LastRefillTime = Now;
+
+	if ( State.Tokens < 1.0f ) { return false; }
+	State.Tokens -= 1.0f;
+	return true;
+}
+
+
+UAudioComponent* UAudioEventSubsystem::AcquireVoice( const FGameplayTag& Category, const int32 MaxConcurrent ) {
+	int32 FreeIndex = INDEX_NONE;
+	int32 OldestIndex = INDEX_NONE;
+	int32 OldestInCategoryIndex = INDEX_NONE;
+	int32 CategoryVoices = 0;
+
+	for ( int32 Index = 0; Index < Voices.Num(); ++Index ) {
+		const FVoice& Voice = Voices[Index];
+		if ( !Voice.Component->IsPlaying() ) {
+			if ( FreeIndex == INDEX_NONE ) { FreeIndex = Index; }
+			continue;
+		}
+
+		if ( OldestIndex == INDEX_NONE || Voice.StartTime < Voices[OldestIndex].StartTime ) { OldestIndex = Index; }
+		if ( Voice.Category == Category ) {
+			++CategoryVoices;
+			if ( OldestInCategoryIndex == INDEX_NONE || Voice.StartTime < Voices[OldestInCategoryIndex].StartTime ) { OldestInCategoryIndex = Index; }
+		}
+	}
+
+	int32 VoiceIndex = FreeIndex;
+	if ( MaxConcurrent > 0 && CategoryVoices >= MaxConcurrent ) {
+		VoiceIndex = OldestInCategoryIndex;
+	} else if ( VoiceIndex == INDEX_NONE && Voices.Num() < MaxVoices ) {
+		VoiceIndex = Voices.Add({ CreateVoice() });
+	} else if ( VoiceIndex == INDEX_NONE ) {
+		VoiceIndex = OldestIndex;
+	}
+
+	FVoice& Voice = Voices[VoiceIndex];
+	if ( Voice.Component->IsPlaying() ) {
+		Voice.Component->Stop();
+		++TotalStolen;
+	}
+	Voice.Category = Category;
+	Voice.StartTime = GetWorld()->GetTimeSeconds();
+	return Voice.Component;
+}
+
+
+UAudioComponent* UAudioEventSubsystem::CreateVoice() {
+	if ( !AudioActor ) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		AudioActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	UAudioComponent* Component = NewObject<UAudioComponent>(AudioActor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->bAllowSpatialization = true;
+	Component->SetUsingAbsoluteLocation(true);
+	if ( !AudioActor->GetRootComponent() ) { AudioActor->SetRootComponent(Component); }
+	Component->RegisterComponent();
+	AudioActor->AddInstanceComponent(Component);
+	return Component;
+}
+
+
+void UAudioEventSubsystem::LogStats() const {
+	int32 NumPlaying = 0;
+	for ( const FVoice& Voice : Voices ) {
+		if ( Voice.Component && Voice.Component->IsPlaying() ) { ++NumPlaying; }
+	}
+
+	UE_LOG(LogRiotWave, Display, TEXT("Audio: Router=%d Submitted=%d Merged=%d Dropped=%d Stolen=%d Played=%d Voices=%d Playing=%d"),
+		GAudioRouterEnabled, TotalSubmitted, TotalMerged, TotalDropped, TotalStolen, TotalPlayed, Voices.Num(), NumPlaying);
+}
@@ -0,0 +1,193 @@
+// DamageQueueSubsystem.cpp - Implements damage queueing, per-target coalescing and zone tables
+
+#include "Combat/DamageQueueSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/DamageEvents.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Profiling/ShotLatency.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Apply Queued Damage"), STAT_ApplyQueuedDamage, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Damage Events Queued"), STAT_DamageEventsQueued, STATGROUP_Game);
+
+static int32 GDamageBatchingEnabled = 1;
+static FAutoConsoleVariableRef CVarDamageBatchingEnabled(
+	TEXT("RiotWave.Damage.Batching"),
+	GDamageBatchingEnabled,
+	TEXT("1 = hits are queued and applied once per actor per frame, 0 = every hit is applied immediately."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GDamageQueueStatsCommand(
+	TEXT("RiotWave.Damage.Stats"),
+	TEXT("Prints queued and applied damage events, how many were coalesced, and head and limb hit counts."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr ) { DamageQueue->LogStats(); }
+	})
+);
+
+
+bool UDamageQueueSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UDamageQueueSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDamageQueueSubsystem, STATGROUP_Tickables);
+}
+
+
+void UDamageQueueSubsystem::QueueHit( const UObject* WorldContextObject, const FHitResult& HitResult, const float Damage, const float HeadshotMultiplier, AController* EventInstigator, AActor* DamageCauser ) {
+	AActor* Target = HitResult.GetActor();
+	if ( !Target || !WorldContextObject ) { return; }
+
+	const UWorld* World = WorldContextObject->GetWorld();
+	UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr;
+	if ( !DamageQueue ) {
+		UGameplayStatics::ApplyDamage(Target, Damage, EventInstigator, DamageCauser, UDamageType::StaticClass());
+		return;
+	}
+
+	FQueuedDamage Event;
+	Event.Target = Target;
+	Event.EventInstigator = EventInstigator;
+	Event.DamageCauser = DamageCauser;
+
+	// For skeletal meshes the hit item is the physics body, which already knows its bone index
+	const USkeletalMeshComponent* Mesh = Cast<USkeletalMeshComponent>(HitResult.GetComponent());
+	if ( Mesh && Mesh->Bodies.IsValidIndex(HitResult.Item) && Mesh->Bodies[HitResult.Item] ) {
+		Event.BoneIndex = Mesh->Bodies[HitResult.Item]->InstanceBoneIndex;
+		Event.Zone = DamageQueue->GetDamageZone(Mesh->GetSkeletalMeshAsset(), Event.BoneIndex);
+	}
+	Event.Damage = Damage * DamageQueue->GetZoneMultiplier(Event.Zone, HeadshotMultiplier);
+
+	DamageQueue->Enqueue(Event);
+}
+
+
+void UDamageQueueSubsystem::QueueDamage( const UObject* WorldContextObject, AActor* Target, const float Damage, AController* EventInstigator, AActor* DamageCauser ) {
+	if ( !Target || !WorldContextObject ) { return; }
+
+	const UWorld* World = WorldContextObject->GetWorld();
+	UDamageQueueSubsystem* DamageQueue = World ? World->GetSubsystem<UDamageQueueSubsystem>() : nullptr;
+	if ( !DamageQueue ) {
+		UGameplayStatics::ApplyDamage(Target, Damage, EventInstigator, DamageCauser, UDamageType::StaticClass());
+		return;
+	}
+
+	FQueuedDamage Event;
+	Event.Target = Target;
+	Event.EventInstigator = EventInstigator;
+	Event.DamageCauser = DamageCauser;
+	Event.Damage = Damage;
+	DamageQueue->Enqueue(Event);
+}
+
+
+void UDamageQueueSubsystem::Enqueue( const FQueuedDamage& Event ) {
+	++TotalQueued;
+	INC_DWORD_STAT(STAT_DamageEventsQueued);
+	if ( Event.Zone == EDamageZone::Head ) { ++TotalHeadHits; }
+	if ( Event.Zone == EDamageZone::Limb ) { ++TotalLimbHits; }
+
+	if ( GDamageBatchingEnabled == 0 ) {
+		ApplyEvent(Event);
+		return;
+	}
+	QueuedEvents.Add(Event);
+}
+
+
+void UDamageQueueSubsystem::ApplyEvent( const FQueuedDamage& Event ) {
+	// Same checks as UGameplayStatics::ApplyDamage
+	AActor* Target = Event.Target.Get();
+	if ( !Target || !Target->CanBeDamaged() || Event.Damage == 0.0f ) { return; }
+
+	Target->TakeDamage(Event.Damage, FDamageEvent(UDamageType::StaticClass()), Event.EventInstigator.Get(), Event.DamageCauser.Get());
+	FShotLatency::MarkStage(EShotLatencyStage::Damage, Event.DamageCauser.Get());
+	++TotalApplied;
+}
+
+
+float UDamageQueueSubsystem::GetZoneMultiplier( const EDamageZone Zone, const float HeadshotMultiplier ) const {
+	switch ( Zone ) {
+		case EDamageZone::Head: return HeadshotMultiplier;
+		case EDamageZone::Limb: return LimbMultiplier;
+		default: return 1.0f;
+	}
+}
+
+
+EDamageZone UDamageQueueSubsystem::GetDamageZone( const USkeletalMesh* Mesh, const int32 BoneIndex ) {
+	if ( !Mesh || BoneIndex == INDEX_NONE ) { return EDamageZone::Body; }
+
+	const TArray<EDamageZone>* Zones = ZoneTables.Find(Mesh);
+	if ( !Zones ) {
+		const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+		TArray<EDamageZone>& NewZones = ZoneTables.Add(Mesh);
+		NewZones.SetNumUninitialized(RefSkeleton.GetNum());
+
+		// Parents always come before their children in a reference skeleton, so one pass propagates zones down
+		for ( int32 Bone = 0; Bone < RefSkeleton.GetNum(); ++Bone ) {
+			const FName BoneName = RefSkeleton.GetBoneName(Bone);
+			const int32 ParentBone = RefSkeleton.GetParentIndex(Bone);
+			if ( HeadBones.Contains(BoneName) ) {
+				NewZones[Bone] = EDamageZone::Head;
+			} else if ( LimbBones.Contains(BoneName) ) {
+				NewZones[Bone] = EDamageZone::Limb;
+			} else {
+				NewZones[Bone] = ParentBone == INDEX_NONE ? EDamageZone::Body : NewZones[ParentBone];
+			}
+		}
+		Zones = &NewZones;
+	}
+
+	return Zones->IsValidIndex(BoneIndex) ? ( *Zones )[BoneIndex] : EDamageZone::Body;
+}
+
+
+void UDamageQueueSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	if ( QueuedEvents.Num() > 0 ) { ApplyQueuedDamage(); }
+}
+
+
+void UDamageQueueSubsystem::ApplyQueuedDamage() {
+	SCOPE_CYCLE_COUNTER(STAT_ApplyQueuedDamage);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UDamageQueueSubsystem::ApplyQueuedDamage);
+
+	TargetIndices.Reset();
+	AppliedEvents.Reset();
+	for ( const FQueuedDamage& Event : QueuedEvents ) {
+		if ( !Event.Target.IsValid() ) { continue; }
+
+		if ( const int32* Index = TargetIndices.Find(Event.Target.Get()) ) {
+			FQueuedDamage& Applied = AppliedEvents[*Index];
+			Applied.Damage += Event.Damage;
+			Applied.EventInstigator = Event.EventInstigator;
+			Applied.DamageCauser = Event.DamageCauser;
+		} else {
+			TargetIndices.Add(Event.Target.Get(), AppliedEvents.Add(Event));
+		}
+	}
+
+	// Cleared before applying, since TakeDamage may queue more damage, e.g. through a death explosion
+	QueuedEvents.Reset();
+
+	for ( const FQueuedDamage& Applied : AppliedEvents ) { ApplyEvent(Applied); }
+}
+
+
+void UDamageQueueSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("Damage: Batching=%d Queued=%d Applied=%d Coalesced=%d HeadHits=%d LimbHits=%d ZoneTables=%d"),
+		GDamageBatchingEnabled, TotalQueued, TotalApplied, TotalQueued - TotalApplied, TotalHeadHits, TotalLimbHits, ZoneTables.Num());
+}
@@ -0,0 +1,213 @@
+// LagCompensationSubsystem.cpp - Implements the hitbox ring buffers and shot rewinding
+
+#include "Combat/LagCompensationSubsystem.h"
+
+#include "Algo/AnyOf.h"
+#include "Components/CapsuleComponent.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Rewind"), STAT_LagCompensationRewind, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Lag Compensated Enemies"), STAT_LagCompensatedEnemies, STATGROUP_Game);
+DECLARE_MEMORY_STAT(TEXT("Hitbox History Memory"), STAT_HitboxHistoryMemory, STATGROUP_Game);
+
+static FAutoConsoleCommandWithWorld GLagCompensationStatsCommand(
+	TEXT("RiotWave.LagCompensation.Stats"),
+	TEXT("Prints hitbox history memory per enemy and in total, and the enemies rewound and time spent per confirmed shot."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const ULagCompensationSubsystem* LagCompensation = World ? World->GetSubsystem<ULagCompensationSubsystem>() : nullptr ) { LagCompensation->LogStats(); }
+	})
+);
+
+
+/**
+* Enemy state reaches a client half a round trip after the server simulated it, and the
+* client then draws it ClientInterpolationDelay late, so that is how far back it aims.
+*/
+double ULagCompensationSubsystem::GetClientViewTime( const APlayerController* PlayerController ) {
+	const UWorld* World = PlayerController ? PlayerController->GetWorld() : nullptr;
+	if ( !World ) { return 0.0; }
+	if ( World->GetNetMode() != NM_Client ) { return World->GetTimeSeconds(); }
+
+	const AGameStateBase* GameState = World->GetGameState();
+	const double ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+	const APlayerState* PlayerState = PlayerController->PlayerState;
+	const double HalfRoundTrip = PlayerState ? PlayerState->GetPingInMilliseconds() * 0.0005 : 0.0;
+	const ULagCompensationSubsystem* LagCompensation = World->GetSubsystem<ULagCompensationSubsystem>();
+	const double InterpolationDelay = LagCompensation ? LagCompensation->ClientInterpolationDelay : 0.0;
+
+	return ServerTime - HalfRoundTrip - InterpolationDelay;
+}
+
+
+bool ULagCompensationSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId ULagCompensationSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+
+int32 ULagCompensationSubsystem::GetCapacity() const {
+	// One extra slot so a full HistorySeconds is always covered by two snapshots
+	return FMath::Max(FMath::CeilToInt32(HistorySeconds * RecordRate) + 1, 2);
+}
+
+
+void ULagCompensationSubsystem::RegisterEnemy( AEnemy* Enemy ) {
+	if ( !Enemy || Histories.ContainsByPredicate([Enemy]( const FHitboxHistory& History ) { return History.Enemy == Enemy; }) ) { return; }
+
+	FHitboxHistory& History = Histories.AddDefaulted_GetRef();
+	History.Enemy = Enemy;
+	History.Snapshots.SetNum(GetCapacity());
+	INC_MEMORY_STAT_BY(STAT_HitboxHistoryMemory, History.Snapshots.GetAllocatedSize());
+}
+
+
+void ULagCompensationSubsystem::UnregisterEnemy( AEnemy* Enemy ) {
+	const int32 Index = Histories.IndexOfByPredicate([Enemy]( const FHitboxHistory& History ) { return History.Enemy == Enemy; });
+	if ( Index == INDEX_NONE ) { return; }
+
+	DEC_MEMORY_STAT_BY(STAT_HitboxHistoryMemory, Histories[Index].Snapshots.GetAllocatedSize());
+	Histories.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+
+void ULagCompensationSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	TRACE_CPUPROFILER_EVENT_SCOPE(ULagCompensationSubsystem::Tick);
+
+	if ( GetWorld()->GetNetMode() == NM_Client ) { return; }
+
+	TimeSinceRecord += DeltaTime;
+	if ( TimeSinceRecord < 1.0f / RecordRate ) { return; }
+	TimeSinceRecord = 0.0f;
+
+	const double Time = GetWorld()->GetTimeSeconds();
+	for ( int32 Index = Histories.Num() - 1; Index >= 0; --Index ) {
+		FHitboxHistory& History = Histories[Index];
+		const AEnemy* Enemy = History.Enemy.Get();
+		if ( !Enemy ) {
+			DEC_MEMORY_STAT_BY(STAT_HitboxHistoryMemory, History.Snapshots.GetAllocatedSize());
+			Histories.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		// A parked enemy's history would interpolate across the pool teleport once it respawns
+		if ( Enemy->IsHidden() ) {
+			History.Num = 0;
+			continue;
+		}
+		Record(History, Time);
+	}
+}
+
+
+void ULagCompensationSubsystem::Record( FHitboxHistory& History, const double Time ) const {
+	FHitboxSnapshot& Snapshot = History.Snapshots[History.Head];
+	Snapshot.Time = Time;
+	Snapshot.Location = History.Enemy->GetActorLocation();
+	Snapshot.Rotation = History.Enemy->GetActorQuat();
+
+	History.Head = ( History.Head + 1 ) % History.Snapshots.Num();
+	History.Num = FMath::Min(History.Num + 1, History.Snapshots.Num());
+}
+
+
+bool ULagCompensationSubsystem::SampleHistory( const FHitboxHistory& History, const double Time, FVector& OutLocation, FQuat& OutRotation ) const {
+	if ( History.Num == 0 ) { return false; }
+
+	const int32 Capacity = History.Snapshots.Num();
+
+	// Walk from the newest snapshot back until one is at or before Time
+	const FHitboxSnapshot* Newer = nullptr;
+	for ( int32 Offset = 1; Offset <= History.Num; ++Offset ) {
+		const FHitboxSnapshot& Older = History.Snapshots[( History.Head - Offset + Capacity ) % Capacity];
+		if ( Older.Time <= Time ) {
+			if ( !Newer ) {
+				OutLocation = Older.Location;
+				OutRotation = Older.Rotation;
+				return true;
+			}
+
+			const float Alpha = static_cast<float>(( Time - Older.Time ) / FMath::Max(Newer->Time - Older.Time, UE_SMALL_NUMBER));
+			OutLocation = FMath::Lerp(Older.Location, Newer->Location, Alpha);
+			OutRotation = FQuat::Slerp(Older.Rotation, Newer->Rotation, Alpha);
+			return true;
+		}
+		Newer = &Older;
+	}
+
+	// Older than the whole history: clamp to the oldest snapshot
+	OutLocation = Newer->Location;
+	OutRotation = Newer->Rotation;
+	return true;
+}
+
+
+void ULagCompensationSubsystem::ConfirmShot( const FVector& Start, const TConstArrayView<FVector> Ends, const double ShotTime, const AActor* Shooter, TArray<FHitResult>& OutHits ) {
+	SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind);
+	TRACE_CPUPROFILER_EVENT_SCOPE(ULagCompensationSubsystem::ConfirmShot);
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	// Never rewind into the future, a client clock running ahead would otherwise extrapolate
+	const double Time = FMath::Min(ShotTime, GetWorld()->GetTimeSeconds());
+
+	TArray<FRewoundEnemy, TInlineAllocator<16>> Rewound;
+	for ( const FHitboxHistory& History : Histories ) {
+		AEnemy* Enemy = History.Enemy.Get();
+		if ( !Enemy || Enemy->IsHidden() || Enemy->IsDead() ) { continue; }
+
+		FVector Location;
+		FQuat Rotation;
+		if ( !SampleHistory(History, Time, Location, Rotation) ) { continue; }
+
+		const float CandidateRadius = Enemy->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + CandidateMargin;
+		const bool bIsNearShot = Algo::AnyOf(Ends, [&]( const FVector& End ) {
+			return FMath::PointDistToSegmentSquared(Location, Start, End) <= FMath::Square(CandidateRadius);
+		});
+		if ( !bIsNearShot ) { continue; }
+
+		Rewound.Add({ Enemy, Enemy->GetActorTransform() });
+		Enemy->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LagCompensatedShot), false, Shooter);
+	OutHits.Reset(Ends.Num());
+	for ( const FVector& End : Ends ) {
+		FHitResult& Hit = OutHits.AddDefaulted_GetRef();
+		GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECollisionChannel::ECC_Visibility, QueryParams);
+	}
+
+	for ( const FRewoundEnemy& Entry : Rewound ) {
+		Entry.Enemy->SetActorLocationAndRotation(Entry.RestoreTransform.GetLocation(), Entry.RestoreTransform.GetRotation(), false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+	++TotalShots;
+	TotalRewoundEnemies += Rewound.Num();
+	MaxRewoundEnemies = FMath::Max(MaxRewoundEnemies, Rewound.Num());
+	TotalRewindSeconds += ElapsedSeconds;
+	MaxRewindSeconds = FMath::Max(MaxRewindSeconds, ElapsedSeconds);
+	SET_DWORD_STAT(STAT_LagCompensatedEnemies, Rewound.Num());
+}
+
+
+void ULagCompensationSubsystem::LogStats() const {
+	const int32 BytesPerEnemy = GetCapacity() * sizeof(FHitboxSnapshot);
+	const int32 SafeShots = FMath::Max(TotalShots, 1);
+	UE_LOG(LogRiotWave, Display, TEXT("LagCompensation: Enemies=%d Snapshots=%d BytesPerEnemy=%d TotalBytes=%d Shots=%d AvgRewound=%.2f MaxRewound=%d AvgRewindUs=%.1f MaxRewindUs=%.1f"),
+		Histories.Num(), GetCapacity(), BytesPerEnemy, BytesPerEnemy * Histories.Num(), TotalShots,
+		static_cast<float>(TotalRewoundEnemies) / SafeShots, MaxRewoundEnemies,
+		TotalRewindSeconds * 1e6 / SafeShots, MaxRewindSeconds * 1e6);
+}
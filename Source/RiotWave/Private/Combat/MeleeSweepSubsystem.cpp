@@ -0,0 +1,132 @@
+// MeleeSweepSubsystem.cpp - Implements the batched weapon sweeps
+
+#include "Combat/MeleeSweepSubsystem.h"
+
+#include "Components/BoxComponent.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Sweeps"), STAT_MeleeSweeps, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Active Melee Swings"), STAT_ActiveMeleeSwings, STATGROUP_Game);
+
+static FAutoConsoleCommandWithWorld GMeleeStatsCommand(
+	TEXT("RiotWave.Melee.Stats"),
+	TEXT("Prints active melee swings and swing, sweep and hit totals."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UMeleeSweepSubsystem* MeleeSweeps = World ? World->GetSubsystem<UMeleeSweepSubsystem>() : nullptr ) { MeleeSweeps->LogStats(); }
+	})
+);
+
+
+bool UMeleeSweepSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UMeleeSweepSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeSweepSubsystem, STATGROUP_Tickables);
+}
+
+
+void UMeleeSweepSubsystem::BeginSwing( AEnemy* Enemy ) {
+	if ( !Enemy || !Enemy->GetDamageCollision() ) { return; }
+
+	// A montage restarted mid swing begins a new swing, which may hit the same player again
+	FMeleeSwing* Swing = Swings.FindByPredicate([Enemy]( const FMeleeSwing& Candidate ) { return Candidate.Enemy == Enemy; });
+	if ( !Swing ) {
+		Swing = &Swings.AddDefaulted_GetRef();
+		Swing->Enemy = Enemy;
+	}
+
+	Swing->PreviousTransform = Enemy->GetDamageCollision()->GetComponentTransform();
+	Swing->HitActors.Reset();
+	++TotalSwings;
+}
+
+
+void UMeleeSweepSubsystem::EndSwing( AEnemy* Enemy ) {
+	const int32 Index = Swings.IndexOfByPredicate([Enemy]( const FMeleeSwing& Candidate ) { return Candidate.Enemy == Enemy; });
+	if ( Index != INDEX_NONE ) { Swings.RemoveAtSwap(Index, 1, EAllowShrinking::No); }
+}
+
+
+void UMeleeSweepSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SET_DWORD_STAT(STAT_ActiveMeleeSwings, Swings.Num());
+	if ( Swings.Num() == 0 ) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_MeleeSweeps);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UMeleeSweepSubsystem::Tick);
+
+	// Damage may end a swing (e.g. by killing the last player), so walk backwards over a stable range
+	for ( int32 Index = Swings.Num() - 1; Index >= 0; --Index ) {
+		if ( !Swings.IsValidIndex(Index) ) { continue; }
+
+		if ( !Swings[Index].Enemy.IsValid() || Swings[Index].Enemy->IsDead() ) {
+			Swings.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+		SweepSwing(Swings[Index]);
+	}
+}
+
+
+void UMeleeSweepSubsystem::SweepSwing( FMeleeSwing& Swing ) {
+	AEnemy* Enemy = Swing.Enemy.Get();
+	const UBoxComponent* DamageCollision = Enemy->GetDamageCollision();
+	const FTransform CurrentTransform = DamageCollision->GetComponentTransform();
+	const FCollisionShape Shape = FCollisionShape::MakeBox(DamageCollision->GetScaledBoxExtent());
+
+	const FVector Start = Swing.PreviousTransform.GetLocation();
+	const FVector End = CurrentTransform.GetLocation();
+	const FQuat StartRotation = Swing.PreviousTransform.GetRotation();
+	const FQuat EndRotation = CurrentTransform.GetRotation();
+
+	const float AngleDegrees = FMath::RadiansToDegrees(StartRotation.AngularDistance(EndRotation));
+	const int32 NumSubsteps = FMath::Clamp(
+		FMath::CeilToInt32(FMath::Max(FVector::Dist(Start, End) / MaxSubstepDistance, AngleDegrees / MaxSubstepAngle)), 1, MaxSubsteps);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MeleeSweep), false, Enemy);
+	const FCollisionObjectQueryParams ObjectParams(ECC_Pawn);
+
+	TArray<FHitResult> Hits;
+	TArray<AActor*, TInlineAllocator<4>> NewHits;
+	FVector StepStart = Start;
+
+	for ( int32 Step = 1; Step <= NumSubsteps; ++Step ) {
+		const float Alpha = static_cast<float>(Step) / NumSubsteps;
+		const FVector StepEnd = FMath::Lerp(Start, End, Alpha);
+		const FQuat StepRotation = FQuat::Slerp(StartRotation, EndRotation, Alpha);
+
+		Hits.Reset();
+		GetWorld()->SweepMultiByObjectType(Hits, StepStart, StepEnd, StepRotation, ObjectParams, Shape, QueryParams);
+		++TotalSweeps;
+
+		for ( const FHitResult& Hit : Hits ) {
+			AActor* HitActor = Hit.GetActor();
+			if ( !HitActor || Swing.HitActors.Contains(HitActor) ) { continue; }
+
+			Swing.HitActors.Add(HitActor);
+			NewHits.Add(HitActor);
+		}
+		StepStart = StepEnd;
+	}
+
+	Swing.PreviousTransform = CurrentTransform;
+
+	// Damage last, since it can run arbitrary gameplay code that touches Swings
+	for ( AActor* HitActor : NewHits ) {
+		Enemy->DoDamage(HitActor);
+		++TotalHits;
+	}
+}
+
+
+void UMeleeSweepSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("Melee: ActiveSwings=%d Swings=%d Sweeps=%d Hits=%d"), Swings.Num(), TotalSwings, TotalSweeps, TotalHits);
+}
@@ -0,0 +1,174 @@
+// ProjectileSubsystem.cpp - Implements the projectile arrays, integration and segment sweeps
+
+#include "Combat/ProjectileSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+#include "Weapon/DamageInterface.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Step"), STAT_ProjectileStep, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Live Projectiles"), STAT_LiveProjectiles, STATGROUP_Game);
+
+static int32 GProjectileParallelSweeps = 1;
+static FAutoConsoleVariableRef CVarProjectileParallelSweeps(
+	TEXT("RiotWave.Projectiles.ParallelSweeps"),
+	GProjectileParallelSweeps,
+	TEXT("1 = projectile segment traces run on worker threads, 0 = on the game thread."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GProjectileStatsCommand(
+	TEXT("RiotWave.Projectiles.Stats"),
+	TEXT("Prints live and peak projectile counts, the last and worst step time against the budget, and spawn and hit totals."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UProjectileSubsystem* Projectiles = World ? World->GetSubsystem<UProjectileSubsystem>() : nullptr ) { Projectiles->LogStats(); }
+	})
+);
+
+bool UProjectileSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UProjectileSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+
+bool UProjectileSubsystem::SpawnProjectile( const FVector& Location, const FVector& Velocity, const float GravityScale, const float Lifetime, const float Damage, const float HeadshotMultiplier, AActor* Owner ) {
+	if ( Positions.Num() >= MaxProjectiles ) {
+		++TotalRejected;
+		return false;
+	}
+
+	Positions.Add(Location);
+	Velocities.Add(Velocity);
+	GravityZ.Add(GetWorld()->GetGravityZ() * GravityScale);
+	Lifetimes.Add(Lifetime);
+	Damages.Add(Damage);
+	HeadshotMultipliers.Add(HeadshotMultiplier);
+	Owners.Add(Owner);
+
+	++TotalSpawned;
+	PeakProjectiles = FMath::Max(PeakProjectiles, Positions.Num());
+	return true;
+}
+
+
+void UProjectileSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SET_DWORD_STAT(STAT_LiveProjectiles, Positions.Num());
+	if ( Positions.Num() == 0 ) {
+		LastStepMs = 0.0;
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileStep);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProjectileSubsystem::Tick);
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	Integrate(DeltaTime);
+	SweepSegments();
+	ResolveAndCompact();
+
+	LastStepMs = ( FPlatformTime::Seconds() - StartSeconds ) * 1000.0;
+	MaxStepMs = FMath::Max(MaxStepMs, LastStepMs);
+}
+
+
+void UProjectileSubsystem::Integrate( const float DeltaTime ) {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProjectileSubsystem::Integrate);
+
+	const int32 Num = Positions.Num();
+	NextPositions.SetNumUninitialized(Num, EAllowShrinking::No);
+
+	// Semi-implicit Euler: velocity first, which stays stable through the long steps of a hitch
+	for ( int32 Index = 0; Index < Num; ++Index ) {
+		Velocities[Index].Z += GravityZ[Index] * DeltaTime;
+		NextPositions[Index] = Positions[Index] + Velocities[Index] * DeltaTime;
+		Lifetimes[Index] -= DeltaTime;
+	}
+}
+
+
+void UProjectileSubsystem::SweepSegments() {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProjectileSubsystem::SweepSegments);
+
+	const int32 Num = Positions.Num();
+	Hits.SetNum(Num, EAllowShrinking::No);
+	bHasHit.SetNumUninitialized(Num, EAllowShrinking::No);
+
+	const UWorld* World = GetWorld();
+	const int32 NumBatches = FMath::DivideAndRoundUp(Num, FMath::Max(SweepBatchSize, 1));
+
+	// Scene queries are read only, so batches can trace concurrently; nothing is applied until all are done
+	ParallelFor(NumBatches, [this, World, Num]( const int32 Batch ) {
+		const int32 First = Batch * FMath::Max(SweepBatchSize, 1);
+		const int32 Last = FMath::Min(First + FMath::Max(SweepBatchSize, 1), Num);
+
+		for ( int32 Index = First; Index < Last; ++Index ) {
+			FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileSweep), false, Owners[Index].Get());
+			Hits[Index] = FHitResult();
+			bHasHit[Index] = World->LineTraceSingleByChannel(Hits[Index], Positions[Index], NextPositions[Index], ECC_Projectile, QueryParams);
+		}
+	}, GProjectileParallelSweeps == 0 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
+
+
+void UProjectileSubsystem::ResolveAndCompact() {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProjectileSubsystem::ResolveAndCompact);
+
+	// Backwards, so swap-removal only moves bullets that were already handled
+	for ( int32 Index = Positions.Num() - 1; Index >= 0; --Index ) {
+		if ( !bHasHit[Index] ) {
+			if ( Lifetimes[Index] <= 0.0f ) {
+				RemoveProjectile(Index);
+			} else {
+				Positions[Index] = NextPositions[Index];
+			}
+			continue;
+		}
+
+		const FHitResult& Hit = Hits[Index];
+		if ( IDamageInterface* DamageInterface = Cast<IDamageInterface>(Hit.GetActor()) ) {
+			DamageInterface->BulletHit(Hit);
+
+			if ( Cast<AEnemy>(Hit.GetActor()) ) {
+				AActor* Owner = Owners[Index].Get();
+				const APawn* OwnerPawn = Cast<APawn>(Owner);
+				UDamageQueueSubsystem::QueueHit(this, Hit, Damages[Index], HeadshotMultipliers[Index], OwnerPawn ? OwnerPawn->GetController() : nullptr, Owner);
+			}
+		}
+		++TotalHits;
+		RemoveProjectile(Index);
+	}
+}
+
+
+void UProjectileSubsystem::RemoveProjectile( const int32 Index ) {
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	GravityZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Lifetimes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Damages.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	HeadshotMultipliers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Owners.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	NextPositions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Hits.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	bHasHit.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+
+void UProjectileSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("Projectiles: Live=%d Peak=%d Max=%d StepMs=%.3f MaxStepMs=%.3f BudgetMs=%.2f Spawned=%d Rejected=%d Hits=%d Parallel=%d"),
+		Positions.Num(), PeakProjectiles, MaxProjectiles, LastStepMs, MaxStepMs, BudgetMs, TotalSpawned, TotalRejected, TotalHits, GProjectileParallelSweeps);
+}
@@ -3,16 +3,23 @@
 
 #include "Controller/EnemyController/EnemyController.h"
 
+#include "AI/EnemyBlackboardKeys.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "Enemy/Enemy.h"
+#include "Patrol/PatrolRouteSubsystem.h"
+#include "Profiling/TickAudit.h"
 
 
 // Sets default values
 AEnemyController::AEnemyController() {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	// AAIController::Tick only updates control rotation, which is idle until there is something to face
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
@@ -24,8 +31,42 @@ void AEnemyController::BeginPlay() {
 	
 }
 
-// Called every frame
-void AEnemyController::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
+void AEnemyController::Tick( float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+}
+
+
+void AEnemyController::SetFocus( AActor* NewFocus, const EAIFocusPriority::Type InPriority ) {
+	Super::SetFocus(NewFocus, InPriority);
+	RefreshTickEnabled();
+}
+
+
+void AEnemyController::SetFocalPoint( const FVector NewFocus, const EAIFocusPriority::Type InPriority ) {
+	Super::SetFocalPoint(NewFocus, InPriority);
+	RefreshTickEnabled();
+}
+
+
+void AEnemyController::ClearFocus( const EAIFocusPriority::Type InPriority ) {
+	Super::ClearFocus(InPriority);
+	RefreshTickEnabled();
+}
+
+
+void AEnemyController::RefreshTickEnabled() {
+	const bool bNeedsTick = GetTargetActor() != nullptr || FAISystem::IsValidLocation(GetFocalPoint());
+	if (bNeedsTick != IsActorTickEnabled()) {
+		SetActorTickEnabled(bNeedsTick);
+	}
+}
+
+
+EBlackboardNotificationResult AEnemyController::OnTargetKeyChanged( const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID ) {
+	RefreshTickEnabled();
+	return EBlackboardNotificationResult::ContinueObserving;
+}
 
 
 void AEnemyController::OnPossess( APawn* InPawn ) {
@@ -37,8 +78,60 @@ void AEnemyController::OnPossess( APawn* InPawn ) {
 	if (AEnemy* Enemy = Cast<AEnemy>( InPawn )) {
 		if (Enemy->GetBehaviorTree()) {
 			BlackboardComponent->InitializeBlackboard(*Enemy->GetBehaviorTree()->BlackboardAsset);
-			
+			CacheBlackboardKeys();
+
+			// Possessing again re-initializes the blackboard, so the observer is re-registered rather than stacked
+			BlackboardComponent->UnregisterObserversFrom(this);
+			if (TargetKey != FBlackboard::InvalidKey) {
+				BlackboardComponent->RegisterObserver(TargetKey, this, FOnBlackboardChangeNotification::CreateUObject(this, &AEnemyController::OnTargetKeyChanged));
+			}
 		}
 	}
 }
 
+
+void AEnemyController::CacheBlackboardKeys() {
+	TargetKey = BlackboardComponent->GetKeyID(EnemyBlackboardKeys::Target);
+	PatrolPointKey = BlackboardComponent->GetKeyID(EnemyBlackboardKeys::PatrolPoint);
+	PatrolPoint2Key = BlackboardComponent->GetKeyID(EnemyBlackboardKeys::PatrolPoint2);
+	IsInCombatRangeKey = BlackboardComponent->GetKeyID(EnemyBlackboardKeys::IsInCombatRange);
+}
+
+
+void AEnemyController::SetTargetActor( AActor* Target ) {
+	if (TargetKey != FBlackboard::InvalidKey) {
+		BlackboardComponent->SetValue<UBlackboardKeyType_Object>(TargetKey, Target);
+	}
+}
+
+
+void AEnemyController::SetPatrolPoints( const FVector& InPatrolPoint, const FVector& InPatrolPoint2 ) {
+	if (PatrolPointKey != FBlackboard::InvalidKey) {
+		BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(PatrolPointKey, InPatrolPoint);
+	}
+	if (PatrolPoint2Key != FBlackboard::InvalidKey) {
+		BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(PatrolPoint2Key, InPatrolPoint2);
+	}
+}
+
+
+void AEnemyController::SetInCombatRange( const bool bInCombatRange ) {
+	if (IsInCombatRangeKey != FBlackboard::InvalidKey) {
+		BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(IsInCombatRangeKey, bInCombatRange);
+	}
+}
+
+
+AActor* AEnemyController::GetTargetActor() const {
+	if (TargetKey == FBlackboard::InvalidKey) { return nullptr; }
+	return Cast<AActor>(BlackboardComponent->GetValue<UBlackboardKeyType_Object>(TargetKey));
+}
+
+
+void AEnemyController::FindPathForMoveRequest( const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath ) const {
+	Super::FindPathForMoveRequest(MoveRequest, Query, OutPath);
+
+	if (UPatrolRouteSubsystem* PatrolRoutes = GetWorld()->GetSubsystem<UPatrolRouteSubsystem>()) {
+		PatrolRoutes->RecordPathQuery();
+	}
+}
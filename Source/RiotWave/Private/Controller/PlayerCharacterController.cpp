@@ -5,35 +5,47 @@
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "InputActionValue.h"
+#include "Profiling/ShotLatency.h"
 #include "Weapon/WeaponHandlingComponent.h"
 
+void APlayerCharacterController::SetupInputComponent() {
+    Super::SetupInputComponent();
+
+    // Verify we're using Enhanced Input system - crash if not since this controller requires it
+    UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(InputComponent);
+    checkf(EnhancedInputComponent, TEXT("Enhanced Input system not valid"))
+
+    // Using Triggered for continuous actions (move/look) and Started/Completed for discrete actions (jump, trigger)
+    EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &APlayerCharacterController::HandleMoveAction);
+    EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &APlayerCharacterController::HandleLookAction);
+    EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &APlayerCharacterController::HandleJumpAction);
+    EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &APlayerCharacterController::HandleStopJumpAction);
+
+    // Weapon actions only fire once WeaponHandlingMappingContext is added on pickup
+    EnhancedInputComponent->BindAction(WeaponFireAction, ETriggerEvent::Started, this, &APlayerCharacterController::HandleWeaponFireStarted);
+    EnhancedInputComponent->BindAction(WeaponFireAction, ETriggerEvent::Completed, this, &APlayerCharacterController::HandleWeaponFireCompleted);
+    EnhancedInputComponent->BindAction(WeaponFireAction, ETriggerEvent::Canceled, this, &APlayerCharacterController::HandleWeaponFireCompleted);
+    EnhancedInputComponent->BindAction(SwitchWeaponAction, ETriggerEvent::Started, this, &APlayerCharacterController::HandleSwitchWeaponAction);
+}
+
 void APlayerCharacterController::OnPossess(APawn* aPawn) {
     // Always call parent implementation first to ensure proper initialization chain
     Super::OnPossess(aPawn);
 
     // Cache the controlled character for performance and type safety
     FPSCharacter = Cast<APlayerCharacter>(aPawn);
-    if (FPSCharacter) {
-        // Verify we're using Enhanced Input system - crash if not since this controller requires it
-        UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(InputComponent);
-        checkf(EnhancedInputComponent, TEXT("Enhanced Input system not valid"))
-
+    if (FPSCharacter && GetLocalPlayer()) {
         // Set up basic movement controls at priority 0 (base level)
         // Movement mapping is added first since it's our core control scheme
         if (UEnhancedInputLocalPlayerSubsystem* Subsystem = GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>()) {
             Subsystem->AddMappingContext(TraversalMappingContext, 0);
         }
-
-        // Bind all movement-related actions
-        // Using Triggered for continuous actions (move/look) and Started/Completed for discrete actions (jump)
-        EnhancedInputComponent->BindAction(MoveAction, ETriggerEvent::Triggered, this, &APlayerCharacterController::HandleMoveAction);
-        EnhancedInputComponent->BindAction(LookAction, ETriggerEvent::Triggered, this, &APlayerCharacterController::HandleLookAction);
-        EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Started, this, &APlayerCharacterController::HandleJumpAction);
-        EnhancedInputComponent->BindAction(JumpAction, ETriggerEvent::Completed, this, &APlayerCharacterController::HandleStopJumpAction);
     }
 }
 
 void APlayerCharacterController::HandleMoveAction(const FInputActionValue& Value) {
+    if (!FPSCharacter) { return; }
+
     // Extract 2D movement value - X for right/left, Y for forward/backward
     const FVector2D MovementValue = Value.Get<FVector2D>();
 
@@ -44,6 +56,8 @@ void APlayerCharacterController::HandleMoveAction(const FInputActionValue& Value
 }
 
 void APlayerCharacterController::HandleLookAction(const FInputActionValue& Value) {
+    if (!FPSCharacter) { return; }
+
     // Extract 2D look value - X for yaw (left/right), Y for pitch (up/down)
     const FVector2D LookAxisValue = Value.Get<FVector2D>();
 
@@ -55,35 +69,40 @@ void APlayerCharacterController::HandleLookAction(const FInputActionValue& Value
 
 void APlayerCharacterController::HandleJumpAction() {
     // Delegate to character's jump system which handles actual jump mechanics
-    FPSCharacter->Jump();
+    if (FPSCharacter) { FPSCharacter->Jump(); }
 }
 
 void APlayerCharacterController::HandleStopJumpAction() {
     // Stop jumping when button is released - enables variable jump heights
-    FPSCharacter->StopJumping();
+    if (FPSCharacter) { FPSCharacter->StopJumping(); }
 }
 
-void APlayerCharacterController::HandleWeapWeaponFireAction() {
+void APlayerCharacterController::HandleWeaponFireStarted() {
+    // Latency of the resulting shot is measured from here
+    FShotLatency::MarkInput(FPSCharacter);
+
     // Delegate weapon firing to the dedicated weapon handling component
-    FPSCharacter->GetWeaponHandlingComponent()->FIreWeapon();
+    if (FPSCharacter) { FPSCharacter->GetWeaponHandlingComponent()->StartFiring(); }
+}
+
+void APlayerCharacterController::HandleWeaponFireCompleted() {
+    if (FPSCharacter) { FPSCharacter->GetWeaponHandlingComponent()->StopFiring(); }
+}
+
+void APlayerCharacterController::HandleSwitchWeaponAction() {
+    if (FPSCharacter) { FPSCharacter->GetWeaponHandlingComponent()->EquipNextSlot(); }
 }
 
 void APlayerCharacterController::OnWeaponPicked(AActor* OwningActor) {
     // Verify the weapon was picked up by our controlled character
     if (FPSCharacter == Cast<APlayerCharacter>(OwningActor)) {
-        if (FPSCharacter) {
-            // Re-verify Enhanced Input system is still valid
-            UEnhancedInputComponent* EnhancedInputComponent = Cast<UEnhancedInputComponent>(InputComponent);
-            checkf(EnhancedInputComponent, TEXT("Enhanced Input system not valid"))
-
+        if (FPSCharacter && GetLocalPlayer()) {
             // Add weapon controls at same priority as movement
-            // This ensures consistent input handling between systems
-            if (UEnhancedInputLocalPlayerSubsystem* Subsystem = GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>()) {
+            // This ensures consistent input handling between systems. The fire action itself was bound in SetupInputComponent
+            UEnhancedInputLocalPlayerSubsystem* Subsystem = GetLocalPlayer()->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>();
+            if (Subsystem && !Subsystem->HasMappingContext(WeaponHandlingMappingContext)) {
                 Subsystem->AddMappingContext(WeaponHandlingMappingContext, 0);
             }
-
-            // Bind weapon firing - uses Triggered for continuous firing support
-            EnhancedInputComponent->BindAction(WeaponFireAction, ETriggerEvent::Triggered, this, &APlayerCharacterController::HandleWeapWeaponFireAction);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+// EffectPoolSubsystem.cpp - Implements effect pools, impact culling and merging
+
+#include "Effects/EffectPoolSubsystem.h"
+
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "RiotWave.h"
+
+// An accumulator keeps its value across frames; a counter is cleared every frame and would only show the frames that grew a pool
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Effect Components"), STAT_PooledEffectComponents, STATGROUP_Game);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Effects Culled Or Merged"), STAT_EffectsSkipped, STATGROUP_Game);
+
+static int32 GEffectPoolingEnabled = 1;
+static FAutoConsoleVariableRef CVarEffectPoolingEnabled(
+	TEXT("RiotWave.FX.Pooling"),
+	GEffectPoolingEnabled,
+	TEXT("1 = weapon and hit effects play from pooled components with caps, culling and merging, 0 = every effect spawns its own emitter."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GEffectPoolStatsCommand(
+	TEXT("RiotWave.FX.Stats"),
+	TEXT("Prints effect pool sizes and how many effects were played, reused, culled and merged."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UEffectPoolSubsystem* EffectPool = World ? World->GetSubsystem<UEffectPoolSubsystem>() : nullptr ) { EffectPool->LogStats(); }
+	})
+);
+
+
+bool UEffectPoolSubsystem::IsPoolingEnabled() {
+	return GEffectPoolingEnabled != 0;
+}
+
+
+bool UEffectPoolSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UEffectPoolSubsystem::Deinitialize() {
+	if ( EffectActor ) { EffectActor->Destroy(); }
+	EffectActor = nullptr;
+	Pools.Reset();
+
+	Super::Deinitialize();
+}
+
+
+int32 UEffectPoolSubsystem::GetCap( const EPooledEffectType Type ) const {
+	switch ( Type ) {
+		case EPooledEffectType::MuzzleFlash: return FMath::Max(MaxMuzzleFlashes, 1);
+		case EPooledEffectType::Impact: return FMath::Max(MaxImpacts, 1);
+		case EPooledEffectType::Beam: return FMath::Max(MaxBeams, 1);
+		default: return 1;
+	}
+}
+
+
+void UEffectPoolSubsystem::PrewarmEffect( UParticleSystem* Template, const EPooledEffectType Type ) {
+	if ( !Template || !IsPoolingEnabled() ) { return; }
+
+	FEffectPool& Pool = FindOrAddPool(Template, Type);
+	while ( Pool.Components.Num() < FMath::Min(PrewarmCount, Pool.Cap) ) { Pool.Components.Add(CreateComponent(Template)); }
+}
+
+
+UParticleSystemComponent* UEffectPoolSubsystem::PlayEffect( UParticleSystem* Template, const FVector& Location, const FRotator& Rotation, const EPooledEffectType Type ) {
+	if ( !Template ) { return nullptr; }
+
+	if ( !IsPoolingEnabled() ) { return UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), Template, Location, Rotation, true); }
+
+	if ( Type == EPooledEffectType::Impact ) {
+		if ( !IsImpactVisible(Location) ) {
+			++TotalCulled;
+			INC_DWORD_STAT(STAT_EffectsSkipped);
+			return nullptr;
+		}
+		if ( MergeImpact(Template, Location) ) {
+			++TotalMerged;
+			INC_DWORD_STAT(STAT_EffectsSkipped);
+			return nullptr;
+		}
+	}
+
+	UParticleSystemComponent* Component = AcquireComponent(FindOrAddPool(Template, Type), Template);
+	Component->SetWorldLocationAndRotation(Location, Rotation);
+	Component->ActivateSystem(true);
+	++TotalPlayed;
+	return Component;
+}
+
+
+UEffectPoolSubsystem::FEffectPool& UEffectPoolSubsystem::FindOrAddPool( UParticleSystem* Template, const EPooledEffectType Type ) {
+	FEffectPool& Pool = Pools.FindOrAdd(Template);
+	Pool.Cap = FMath::Max(Pool.Cap, GetCap(Type));
+	return Pool;
+}
+
+
+UParticleSystemComponent* UEffectPoolSubsystem::AcquireComponent( FEffectPool& Pool, UParticleSystem* Template ) {
+	for ( const TObjectPtr<UParticleSystemComponent>& Component : Pool.Components ) {
+		if ( Component && !Component->IsActive() ) { return Component; }
+	}
+
+	if ( Pool.Components.Num() < Pool.Cap ) { return Pool.Components.Add_GetRef(CreateComponent(Template)); }
+
+	// Every component is playing; restart the one that started longest ago
+	UParticleSystemComponent* Component = Pool.Components[Pool.NextReuse];
+	Pool.NextReuse = ( Pool.NextReuse + 1 ) % Pool.Components.Num();
+	++TotalStolen;
+	return Component;
+}
+
+
+UParticleSystemComponent* UEffectPoolSubsystem::CreateComponent( UParticleSystem* Template ) {
+	if ( !EffectActor ) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		EffectActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// Absolute transforms, so moving a component never drags the others or the host along
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(EffectActor);
+	Component->bAutoActivate = false;
+	Component->bAutoDestroy = false;
+	Component->SetUsingAbsoluteLocation(true);
+	Component->SetUsingAbsoluteRotation(true);
+	Component->SetUsingAbsoluteScale(true);
+	Component->SetTemplate(Template);
+	if ( !EffectActor->GetRootComponent() ) { EffectActor->SetRootComponent(Component); }
+	Component->RegisterComponent();
+	EffectActor->AddInstanceComponent(Component);
+
+	++TotalCreated;
+	SET_DWORD_STAT(STAT_PooledEffectComponents, TotalCreated);
+	return Component;
+}
+
+
+bool UEffectPoolSubsystem::IsImpactVisible( const FVector& Location ) const {
+	const float MinViewDot = FMath::Cos(FMath::DegreesToRadians(ImpactViewAngle));
+
+	for ( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It ) {
+		const APlayerController* PlayerController = It->Get();
+		if ( !PlayerController || !PlayerController->IsLocalController() ) { continue; }
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+		const FVector ToImpact = Location - ViewLocation;
+		if ( ToImpact.SizeSquared() > FMath::Square(MaxImpactDistance) ) { continue; }
+
+		// Impacts right at the camera count as visible whatever the view direction
+		const FVector Direction = ToImpact.GetSafeNormal();
+		if ( Direction.IsZero() || FVector::DotProduct(Direction, ViewRotation.Vector()) >= MinViewDot ) { return true; }
+	}
+	return false;
+}
+
+
+bool UEffectPoolSubsystem::MergeImpact( UParticleSystem* Template, const FVector& Location ) {
+	if ( FrameImpactsFrame != GFrameCounter ) {
+		FrameImpacts.Reset();
+		FrameImpactsFrame = GFrameCounter;
+	}
+
+	const TObjectKey<UParticleSystem> Key(Template);
+	const float MergeRadiusSquared = FMath::Square(MergeRadius);
+	const bool bMerged = FrameImpacts.ContainsByPredicate([&]( const TPair<TObjectKey<UParticleSystem>, FVector>& Impact ) {
+		return Impact.Key == Key && FVector::DistSquared(Impact.Value, Location) <= MergeRadiusSquared;
+	});
+
+	if ( !bMerged ) { FrameImpacts.Emplace(Key, Location); }
+	return bMerged;
+}
+
+
+void UEffectPoolSubsystem::LogStats() const {
+	int32 NumComponents = 0;
+	int32 NumActive = 0;
+	for ( const TPair<TObjectKey<UParticleSystem>, FEffectPool>& Pool : Pools ) {
+		for ( const TObjectPtr<UParticleSystemComponent>& Component : Pool.Value.Components ) {
+			++NumComponents;
+			if ( Component && Component->IsActive() ) { ++NumActive; }
+		}
+	}
+
+	UE_LOG(LogRiotWave, Display, TEXT("FX: Pooling=%d Pools=%d Components=%d Active=%d Played=%d Created=%d Stolen=%d Culled=%d Merged=%d"),
+		GEffectPoolingEnabled, Pools.Num(), NumComponents, NumActive, TotalPlayed, TotalCreated, TotalStolen, TotalCulled, TotalMerged);
+}
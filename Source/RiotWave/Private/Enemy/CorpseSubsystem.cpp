@@ -0,0 +1,205 @@
+// CorpseSubsystem.cpp - Implements the ragdoll budget, freezing and corpse recycling
+
+#include "Enemy/CorpseSubsystem.h"
+
+#include "Components/SkeletalMeshComponent.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Corpse Update"), STAT_CorpseUpdate, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Corpse Ragdoll Work"), STAT_CorpseRagdollWork, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulating Corpses"), STAT_SimulatingCorpses, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corpse Bodies Simulated"), STAT_CorpseBodiesSimulated, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Corpse Bodies Awake"), STAT_CorpseBodiesAwake, STATGROUP_Game);
+
+static int32 GCorpseRagdolls = 1;
+static FAutoConsoleVariableRef CVarCorpseRagdolls(
+	TEXT("RiotWave.Corpse.Ragdolls"),
+	GCorpseRagdolls,
+	TEXT("1 = dead enemies fall as ragdolls within the body budget, 0 = every corpse is frozen in its death pose."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GCorpseStatsCommand(
+	TEXT("RiotWave.Corpse.Stats"),
+	TEXT("Prints simulating and frozen corpses, the ragdoll bodies they keep simulating and the game thread time spent on them."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UCorpseSubsystem* Corpses = World ? World->GetSubsystem<UCorpseSubsystem>() : nullptr ) { Corpses->LogStats(); }
+	})
+);
+
+namespace {
+	/** Adds the enclosing ragdoll work to a cycle total; paired with SCOPE_CYCLE_COUNTER(STAT_CorpseRagdollWork) */
+	struct FRagdollWorkScope {
+		explicit FRagdollWorkScope( uint64& InCycles )
+			: Cycles(InCycles), StartCycles(FPlatformTime::Cycles64()) {}
+
+		~FRagdollWorkScope() { Cycles += FPlatformTime::Cycles64() - StartCycles; }
+
+	private:
+		uint64& Cycles;
+
+		uint64 StartCycles;
+	};
+}
+
+
+bool UCorpseSubsystem::AreRagdollsEnabled() {
+	return GCorpseRagdolls != 0;
+}
+
+
+bool UCorpseSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UCorpseSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCorpseSubsystem, STATGROUP_Tickables);
+}
+
+
+void UCorpseSubsystem::AddCorpse( AEnemy* Enemy ) {
+	if ( !Enemy ) { return; }
+
+	Enemy->EnterCorpseState();
+
+	FCorpse& Corpse = Corpses.AddDefaulted_GetRef();
+	Corpse.Enemy = Enemy;
+	Corpse.DeathTime = GetWorld()->GetTimeSeconds();
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CorpseRagdollWork);
+		const FRagdollWorkScope RagdollWork(RagdollWorkCycles);
+		if ( !TryStartRagdoll(Corpse) ) {
+			++Stats.RagdollsDenied;
+			FreezeCorpse(Corpse);
+		}
+	}
+
+	while ( Corpses.Num() > MaxCorpses ) {
+		const FCorpse Oldest = Corpses[0];
+		Corpses.RemoveAt(0, 1, EAllowShrinking::No);
+		SimulatedBodies -= Oldest.SimulatedBodies;
+		RecycleCorpse(Oldest);
+	}
+}
+
+
+bool UCorpseSubsystem::TryStartRagdoll( FCorpse& Corpse ) {
+	USkeletalMeshComponent* Mesh = Corpse.Enemy->GetMesh();
+	const int32 NumBodies = Mesh ? Mesh->Bodies.Num() : 0;
+	if ( !AreRagdollsEnabled() || NumBodies == 0 || NumBodies > MaxSimulatedBodies ) { return false; }
+
+	// Older ragdolls have mostly settled; freeze them before refusing a fresh one
+	for ( FCorpse& Older : Corpses ) {
+		if ( SimulatedBodies + NumBodies <= MaxSimulatedBodies ) { break; }
+		if ( &Older != &Corpse && Older.SimulatedBodies > 0 ) { FreezeCorpse(Older); }
+	}
+
+	Mesh->SetCollisionProfileName(RagdollCollisionProfile);
+	Mesh->SetAllBodiesSimulatePhysics(true);
+	Mesh->SetSimulatePhysics(true);
+	Mesh->WakeAllRigidBodies();
+	Mesh->bBlendPhysics = true;
+
+	Corpse.SimulatedBodies = NumBodies;
+	SimulatedBodies += NumBodies;
+	return true;
+}
+
+
+void UCorpseSubsystem::FreezeCorpse( FCorpse& Corpse ) {
+	SimulatedBodies -= Corpse.SimulatedBodies;
+	Corpse.SimulatedBodies = 0;
+
+	USkeletalMeshComponent* Mesh = Corpse.Enemy.IsValid() ? Corpse.Enemy->GetMesh() : nullptr;
+	if ( !Mesh ) { return; }
+
+	// Without a tick the mesh keeps the last pose it computed instead of blending back to animation
+	Mesh->SetComponentTickEnabled(false);
+	Mesh->bPauseAnims = true;
+	Mesh->SetSimulatePhysics(false);
+	Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+
+void UCorpseSubsystem::RecycleCorpse( const FCorpse& Corpse ) {
+	AEnemy* Enemy = Corpse.Enemy.Get();
+	if ( !Enemy ) { return; }
+
+	++Stats.Recycled;
+	if ( UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>() ) {
+		EnemyPool->ReleaseEnemy(Enemy);
+	} else {
+		Enemy->Destroy();
+	}
+}
+
+
+void UCorpseSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CorpseUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCorpseSubsystem::Tick);
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	Stats.SimulatingCorpses = 0;
+	Stats.FrozenCorpses = 0;
+	Stats.AwakeBodies = 0;
+
+	for ( int32 Index = 0; Index < Corpses.Num(); ) {
+		FCorpse& Corpse = Corpses[Index];
+		const AEnemy* Enemy = Corpse.Enemy.Get();
+
+		// Gone, recycled by someone else, or already revived by the pool
+		if ( !Enemy || !Enemy->IsDead() || WorldTime - Corpse.DeathTime > CorpseLifetime ) {
+			const FCorpse Removed = Corpse;
+			Corpses.RemoveAt(Index, 1, EAllowShrinking::No);
+			SimulatedBodies -= Removed.SimulatedBodies;
+			if ( Enemy && Enemy->IsDead() ) { RecycleCorpse(Removed); }
+			continue;
+		}
+
+		if ( Corpse.SimulatedBodies > 0 ) {
+			SCOPE_CYCLE_COUNTER(STAT_CorpseRagdollWork);
+			const FRagdollWorkScope RagdollWork(RagdollWorkCycles);
+
+			int32 AwakeBodies = 0;
+			for ( const FBodyInstance* Body : Enemy->GetMesh()->Bodies ) {
+				if ( Body && Body->IsInstanceAwake() ) { ++AwakeBodies; }
+			}
+
+			if ( AwakeBodies == 0 || WorldTime - Corpse.DeathTime > MaxSimulationTime ) {
+				FreezeCorpse(Corpse);
+			} else {
+				Stats.AwakeBodies += AwakeBodies;
+			}
+		}
+
+		++( Corpse.SimulatedBodies > 0 ? Stats.SimulatingCorpses : Stats.FrozenCorpses );
+		++Index;
+	}
+
+	Stats.SimulatedBodies = SimulatedBodies;
+	Stats.RagdollWorkMs = FPlatformTime::ToMilliseconds64(RagdollWorkCycles);
+	Stats.MaxRagdollWorkMs = FMath::Max(Stats.MaxRagdollWorkMs, Stats.RagdollWorkMs);
+	RagdollWorkCycles = 0;
+	SET_DWORD_STAT(STAT_SimulatingCorpses, Stats.SimulatingCorpses);
+	SET_DWORD_STAT(STAT_CorpseBodiesSimulated, Stats.SimulatedBodies);
+	SET_DWORD_STAT(STAT_CorpseBodiesAwake, Stats.AwakeBodies);
+}
+
+
+void UCorpseSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("Corpse: Simulating=%d Frozen=%d SimulatedBodies=%d/%d AwakeBodies=%d RagdollWorkMs=%.3f MaxRagdollWorkMs=%.3f RagdollsDenied=%d Recycled=%d"),
+		Stats.SimulatingCorpses, Stats.FrozenCorpses, Stats.SimulatedBodies, MaxSimulatedBodies, Stats.AwakeBodies,
+		Stats.RagdollWorkMs, Stats.MaxRagdollWorkMs, Stats.RagdollsDenied, Stats.Recycled);
+}
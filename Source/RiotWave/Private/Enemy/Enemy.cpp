@@ -3,21 +3,45 @@
 
 #include "Enemy/Enemy.h"
 
-#include "BehaviorTree/BlackboardComponent.h"
+#include "Animation/EnemyAnimationBudgetSubsystem.h"
+#include "Animation/EnemyAnimInstance.h"
+#include "Animation/EnemyPoseSharingSubsystem.h"
+#include "Audio/AudioEventSubsystem.h"
+#include "BrainComponent.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Combat/LagCompensationSubsystem.h"
+#include "Combat/MeleeSweepSubsystem.h"
+#include "Combat/ProjectileSubsystem.h"
+#include "Components/CapsuleComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
 #include "Controller/EnemyController/EnemyController.h"
+#include "Effects/EffectPoolSubsystem.h"
+#include "Enemy/CorpseSubsystem.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Item/ItemBase.h"
-#include "Kismet/GameplayStatics.h"
+#include "Item/ItemDropSubsystem.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Player/PlayerCharacter.h"
+#include "Proximity/ProximitySubsystem.h"
+#include "SkeletalMeshComponentBudgeted.h"
 
 
 // Sets default values
-AEnemy::AEnemy() :
-	MaxHealth(500), Health(MaxHealth) {
-	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+AEnemy::AEnemy( const FObjectInitializer& ObjectInitializer ) :
+	// Budgeted so UEnemyAnimationBudgetSubsystem can throttle distant and off screen meshes
+	Super(ObjectInitializer.SetDefaultSubobjectClass<USkeletalMeshComponentBudgeted>(ACharacter::MeshComponentName)),
+	MaxHealth(500), Health(MaxHealth), bIsDead(false) {
+	// Nothing runs per frame on the actor itself; movement, animation and AI tick through their own components
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Pooled and wave-spawned enemies need a controller too, not only the ones placed in the level
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+	AIControllerClass = AEnemyController::StaticClass();
+
+	// Bullets pass the capsule and hit the mesh bodies, so the damage queue gets a bone for its zone multipliers
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Projectile, ECR_Ignore);
 
 	AgroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AgroSphere"));
 	AgroSphere->SetupAttachment(RootComponent);
@@ -36,54 +60,92 @@ AEnemy::AEnemy() :
 void AEnemy::BeginPlay() {
 	Super::BeginPlay();
 
-	GetMesh()->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	// Remembered so a ragdolled corpse can be put back together when the pool reuses it
+	DefaultMeshRelativeTransform = GetMesh()->GetRelativeTransform();
+	DefaultMeshCollisionProfile = GetMesh()->GetCollisionProfileName();
+	DefaultCapsuleCollision = GetCapsuleComponent()->GetCollisionEnabled();
 
-	GetMesh()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore );
+	InitMeshCollision();
 
 	InitPatrolPoint();
 
 	InitOverlapEvents();
 
+	InitProximityEvents();
+
+	if (UEnemyAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UEnemyAnimationBudgetSubsystem>()) {
+		AnimBudget->RegisterEnemy(this);
+	}
+
+	if (UEnemyPoseSharingSubsystem* PoseSharing = GetWorld()->GetSubsystem<UEnemyPoseSharingSubsystem>()) {
+		PoseSharing->RegisterEnemy(this);
+	}
+
+	if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>()) {
+		LagCompensation->RegisterEnemy(this);
+	}
+
+	if (UEffectPoolSubsystem* EffectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>()) {
+		EffectPool->PrewarmEffect(ImpactParticle, EPooledEffectType::Impact);
+	}
+
+	// Only the shape and socket are used; UMeleeSweepSubsystem sweeps it during swings
 	DamageCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	DamageCollision->SetCollisionObjectType(ECollisionChannel::ECC_WorldDynamic);
-	DamageCollision->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
-	DamageCollision->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECR_Overlap);
+	DamageCollision->SetGenerateOverlapEvents(false);
+}
+
+
+void AEnemy::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->UnregisterAgent(this);
+	}
+
+	if (UEnemyAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UEnemyAnimationBudgetSubsystem>()) {
+		AnimBudget->UnregisterEnemy(this);
+	}
+
+	if (UEnemyPoseSharingSubsystem* PoseSharing = GetWorld()->GetSubsystem<UEnemyPoseSharingSubsystem>()) {
+		PoseSharing->UnregisterEnemy(this);
+	}
+
+	if (ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>()) {
+		LagCompensation->UnregisterEnemy(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 
 void AEnemy::InitPatrolPoint() {
 	EnemyController = Cast<AEnemyController>(GetController());
 	
-	const FVector WorldSpacePatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint);
+	WorldPatrolPoint = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint);
 
-	const FVector WorldSpacePatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
+	WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
 
 	if (EnemyController) {
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint"), WorldSpacePatrolPoint);
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(TEXT("PatrolPoint2"), WorldSpacePatrolPoint2);
+		EnemyController->SetPatrolPoints(WorldPatrolPoint, WorldPatrolPoint2);
 
 		EnemyController->RunBehaviorTree(BehaviorTree);
 	}
 }
 
 
-// Called every frame
-void AEnemy::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
-
-
-void AEnemy::BulletHit( const FHitResult HitResult ) {	
+void AEnemy::BulletHit( const FHitResult& HitResult ) {	
 	if ( ImpactSound ) {
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), ImpactSound, HitResult.ImpactPoint);
+		UAudioEventSubsystem::PostSound(this, ImpactSound, HitResult.ImpactPoint, RiotWaveSoundTags::Enemy_Impact);
 	}
 	
-	if ( ImpactParticle ) {
-	UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, HitResult.ImpactPoint, HitResult.ImpactNormal.Rotation(), true);
+	UEffectPoolSubsystem* EffectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if ( ImpactParticle && EffectPool ) {
+		EffectPool->PlayEffect(ImpactParticle, HitResult.ImpactPoint, HitResult.ImpactNormal.Rotation(), EPooledEffectType::Impact);
 	}
 	
 }
 
 
 float AEnemy::TakeDamage( float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser ) {
+	if (bIsDead) { return 0.0f; }
 	Super::TakeDamage(DamageAmount, DamageEvent, EventInstigator, DamageCauser);
 	if (Health - DamageAmount <= 0) {
 		Health = 0;
@@ -96,6 +158,9 @@ float AEnemy::TakeDamage( float DamageAmount, FDamageEvent const& DamageEvent, A
 
 
 void AEnemy::Death() {
+	if (bIsDead) { return; }
+	bIsDead = true;
+
 	if (ItemToSpawnOnDeath) {
 		const FVector SpawnLocation = GetActorLocation();
 		const FVector SpawnScale = FVector(1.0f, 1.0f, 1.0f);
@@ -103,29 +168,194 @@ void AEnemy::Death() {
 
 		const FTransform SpawnTransform = FTransform(SpawnRotation, SpawnLocation, SpawnScale);
 
-		GetWorld()->SpawnActor<AItemBase>(ItemToSpawnOnDeath, SpawnTransform);
+		UItemDropSubsystem::SpawnItem(this, ItemToSpawnOnDeath, SpawnTransform);
 	}
 
-	Destroy();
+	OnEnemyDied.Broadcast(this);
+
+	// The corpse stays in the world for a while and goes back to the pool from there
+	if (UCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UCorpseSubsystem>()) {
+		Corpses->AddCorpse(this);
+		return;
+	}
+
+	// Hand the actor back to the pool so the next wave can reuse it instead of spawning
+	if (UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>()) {
+		EnemyPool->ReleaseEnemy(this);
+	} else {
+		Destroy();
+	}
+}
+
+
+void AEnemy::OnAcquiredFromPool( const FTransform& SpawnTransform ) {
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	Health = MaxHealth;
+	bIsDead = false;
+	bIsInAttackRange = false;
+
+	ResetCorpseState();
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	GetMesh()->SetComponentTickEnabled(true);
+
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->SetAgentEnabled(this, true);
+	}
+
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	// Patrol points are relative to the actor, so they have to be recomputed at the new location.
+	// This also restarts the behavior tree that was stopped when the enemy was parked.
+	InitPatrolPoint();
+}
+
+
+void AEnemy::ApplyHordeState( const float InHealth, const FVector& InWorldPatrolPoint, const FVector& InWorldPatrolPoint2 ) {
+	Health = FMath::Clamp(InHealth, 0.0f, MaxHealth);
+	WorldPatrolPoint = InWorldPatrolPoint;
+	WorldPatrolPoint2 = InWorldPatrolPoint2;
+
+	if (EnemyController) {
+		EnemyController->SetPatrolPoints(WorldPatrolPoint, WorldPatrolPoint2);
+	}
+}
+
+
+void AEnemy::OnReturnedToPool( const FVector& ParkLocation ) {
+	StopActing();
+
+	GetMesh()->SetComponentTickEnabled(false);
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorLocation(ParkLocation, false, nullptr, ETeleportType::ResetPhysics);
 }
 
+
+void AEnemy::EnterCorpseState() {
+	StopActing();
+
+	// A ragdoll or frozen pose needs the mesh's own bones, not a shared leader's
+	if (UEnemyPoseSharingSubsystem* PoseSharing = GetWorld()->GetSubsystem<UEnemyPoseSharingSubsystem>()) {
+		PoseSharing->StopSharing(this);
+	}
+
+	// The capsule would hold the ragdoll up and block the living
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
+
+
+void AEnemy::ResetCorpseState() {
+	USkeletalMeshComponent* MeshComponent = GetMesh();
+	MeshComponent->SetSimulatePhysics(false);
+	MeshComponent->SetAllBodiesSimulatePhysics(false);
+	MeshComponent->bBlendPhysics = false;
+	MeshComponent->bPauseAnims = false;
+	MeshComponent->AttachToComponent(GetCapsuleComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+	MeshComponent->SetRelativeTransform(DefaultMeshRelativeTransform);
+	MeshComponent->SetCollisionProfileName(DefaultMeshCollisionProfile);
+	InitMeshCollision();
+
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultCapsuleCollision);
+}
+
+
+void AEnemy::StopActing() {
+	EnemyController = Cast<AEnemyController>(GetController());
+	if (EnemyController) {
+		if (UBrainComponent* Brain = EnemyController->GetBrainComponent()) {
+			Brain->StopLogic(TEXT("Stopped acting"));
+		}
+		EnemyController->StopMovement();
+		EnemyController->SetTargetActor(nullptr);
+		EnemyController->SetInCombatRange(false);
+	}
+
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->SetAgentEnabled(this, false);
+	}
+
+	DeactivateWeaponCollision();
+	bIsInAttackRange = false;
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+}
+
+
+void AEnemy::InitMeshCollision() {
+	GetMesh()->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+
+	GetMesh()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore );
+
+	// Set here rather than in the constructor, since the corpse reset restores the mesh's collision profile
+	GetMesh()->SetCollisionResponseToChannel(ECC_Projectile, ECR_Block);
+}
+
+
 void AEnemy::InitOverlapEvents() {
 	AgroSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AgroSphereOnOverlapBegin);
 	AgroSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::AgroSphereOnOverlapEnd);
 
 	CombatRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::CombatRangeSphereOnOverlapBegin);
 	CombatRangeSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::CombatRangeSphereOnOverlapEnd);
+}
+
+
+void AEnemy::InitProximityEvents() {
+	UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>();
+	if (!Proximity || !UProximitySubsystem::IsGridEnabled()) { return; }
+
+	// Radii stay on the spheres so they remain editable and visible in the editor
+	Proximity->RegisterAgent(this, EProximityChannel::Aggro, AgroSphere->GetScaledSphereRadius());
+	Proximity->RegisterAgent(this, EProximityChannel::CombatRange, CombatRangeSphere->GetScaledSphereRadius());
+
+	AgroSphere->SetGenerateOverlapEvents(false);
+	AgroSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	CombatRangeSphere->SetGenerateOverlapEvents(false);
+	CombatRangeSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+}
 
-	DamageCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::DamageCollisionOnOverlapBegin);
-	DamageCollision->OnComponentEndOverlap.AddDynamic(this, &AEnemy::DamageCollisionOnOverlapEnd);
+
+void AEnemy::OnProximityBegin( const EProximityChannel Channel, AActor* Target ) {
+	const FHitResult NoSweepResult;
+	switch (Channel) {
+		case EProximityChannel::Aggro:
+			AgroSphereOnOverlapBegin(AgroSphere, Target, nullptr, INDEX_NONE, false, NoSweepResult);
+			break;
+		case EProximityChannel::CombatRange:
+			CombatRangeSphereOnOverlapBegin(CombatRangeSphere, Target, nullptr, INDEX_NONE, false, NoSweepResult);
+			break;
+		default:
+			break;
+	}
+}
+
+
+void AEnemy::OnProximityEnd( const EProximityChannel Channel, AActor* Target ) {
+	switch (Channel) {
+		case EProximityChannel::Aggro:
+			AgroSphereOnOverlapEnd(AgroSphere, Target, nullptr, INDEX_NONE);
+			break;
+		case EProximityChannel::CombatRange:
+			CombatRangeSphereOnOverlapEnd(CombatRangeSphere, Target, nullptr, INDEX_NONE);
+			break;
+		default:
+			break;
+	}
 }
 
 
 void AEnemy::AgroSphereOnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) {
 	if (!OtherActor) { return; }
 	auto* Character = Cast<APlayerCharacter>(OtherActor);
-	if (!Character) { return; }
-	EnemyController->GetBlackboardComponent()->SetValueAsObject(TEXT("Target"), Character);
+	if (!Character || !EnemyController) { return; }
+	EnemyController->SetTargetActor(Character);
 }
 
 void AEnemy::AgroSphereOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex ) {}
@@ -134,8 +364,8 @@ void AEnemy::AgroSphereOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, A
 void AEnemy::CombatRangeSphereOnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) {
 	if (!OtherActor) { return; }
 	auto* Character = Cast<APlayerCharacter>(OtherActor);
-	if (!Character) { return; }
-	EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("IsInCombatRange"), true);
+	if (!Character || !EnemyController) { return; }
+	EnemyController->SetInCombatRange(true);
 	bIsInAttackRange = true;
 }
 
@@ -143,40 +373,64 @@ void AEnemy::CombatRangeSphereOnOverlapBegin( UPrimitiveComponent* OverlappedCom
 void AEnemy::CombatRangeSphereOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex ) {
 	if(!OtherActor) { return; }
 	auto* Character = Cast<APlayerCharacter>(OtherActor);
-	if (Character) {
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(TEXT("IsInCombatRange"), false);
+	if (Character && EnemyController) {
+		EnemyController->SetInCombatRange(false);
 		bIsInAttackRange = false;
 	}
 	
 }
 
-void AEnemy::PlayAttackMontage() {
-	GetMesh()->GetAnimInstance()->Montage_Play(AttackMontage, 1.0f);
-}
+bool AEnemy::PlayAttackMontage() {
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!AnimInstance || !AttackMontage) { return false; }
 
-void AEnemy::DamageCollisionOnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) {
-	DoDamage(OtherActor);
+	// Anim Blueprints not yet reparented to UEnemyAnimInstance still get the plain montage call
+	if (UEnemyAnimInstance* EnemyAnimInstance = Cast<UEnemyAnimInstance>(AnimInstance)) {
+		return EnemyAnimInstance->PlayAttackMontage(AttackMontage) > 0.0f;
+	}
+	return AnimInstance->Montage_Play(AttackMontage, 1.0f) > 0.0f;
 }
 
-void AEnemy::DamageCollisionOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex ) {
-	
+void AEnemy::StopAttackMontage( const float BlendOutTime ) {
+	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+	if (!AnimInstance) { return; }
+
+	// Same split as PlayAttackMontage, so the typed instance clears its attacking state
+	if (UEnemyAnimInstance* EnemyAnimInstance = Cast<UEnemyAnimInstance>(AnimInstance)) {
+		EnemyAnimInstance->StopAttackMontage(BlendOutTime);
+		return;
+	}
+	AnimInstance->Montage_Stop(BlendOutTime, AttackMontage);
 }
 
 void AEnemy::ActivateWeaponCollision() {
-	DamageCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	bIsWeaponCollisionActive = true;
+	if (UMeleeSweepSubsystem* MeleeSweeps = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>()) {
+		MeleeSweeps->BeginSwing(this);
+	}
+
+	// Full rate from this frame on, not only from the budget's next update
+	if (UEnemyAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UEnemyAnimationBudgetSubsystem>()) {
+		AnimBudget->RefreshEnemy(this);
+	}
 }
 
 
 void AEnemy::DeactivateWeaponCollision() {
-	DamageCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (!bIsWeaponCollisionActive) { return; }
+
+	bIsWeaponCollisionActive = false;
+	if (UMeleeSweepSubsystem* MeleeSweeps = GetWorld()->GetSubsystem<UMeleeSweepSubsystem>()) {
+		MeleeSweeps->EndSwing(this);
+	}
 }
 
 void AEnemy::DoDamage( AActor* OtherActor ) {
 	if (!OtherActor) { return; }
 	auto* Character = Cast<APlayerCharacter>(OtherActor);
 	if (!Character) { return; }
-	UGameplayStatics::ApplyDamage(Character, 1500, EnemyController, this, UDamageType::StaticClass());
+	UDamageQueueSubsystem::QueueDamage(this, Character, 1500, EnemyController, this);
 	if (AttackSound) {
-		UGameplayStatics::PlaySoundAtLocation(GetWorld(), AttackSound, GetActorLocation());
+		UAudioEventSubsystem::PostSound(this, AttackSound, GetActorLocation(), RiotWaveSoundTags::Enemy_Attack);
 	}
 }
@@ -0,0 +1,138 @@
+// EnemyPoolSubsystem.cpp - Implements enemy pooling, pre-warming and pool statistics
+//
+// Enemies are reset through AEnemy::OnAcquiredFromPool / OnReturnedToPool so the enemy
+// class stays the single owner of its own gameplay state.
+
+#include "Enemy/EnemyPoolSubsystem.h"
+
+#include "Enemy/Enemy.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "RiotWave.h"
+
+static FAutoConsoleCommandWithWorld GEnemyPoolStatsCommand(
+	TEXT("RiotWave.EnemyPool.Stats"),
+	TEXT("Prints enemy pool hits, misses, releases and free counts for every pooled enemy class."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UEnemyPoolSubsystem* Pool = World ? World->GetSubsystem<UEnemyPoolSubsystem>() : nullptr ) { Pool->LogPoolStats(); }
+	})
+);
+
+
+bool UEnemyPoolSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+/**
+* Pre-warming happens here rather than Initialize because actors
+* can only be spawned once the world has begun play.
+*/
+void UEnemyPoolSubsystem::OnWorldBeginPlay( UWorld& InWorld ) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	for ( const FEnemyPoolPrewarmEntry& Entry : PrewarmEntries ) {
+		if ( const TSubclassOf<AEnemy> EnemyClass = Entry.EnemyClass.LoadSynchronous() ) {
+			PrewarmPool(EnemyClass, Entry.Count);
+		}
+	}
+}
+
+
+void UEnemyPoolSubsystem::Deinitialize() {
+	for ( TPair<TObjectPtr<UClass>, FEnemyPoolBucket>& Pair : Buckets ) {
+		for ( AEnemy* Enemy : Pair.Value.FreeEnemies ) {
+			if ( IsValid(Enemy) ) { Enemy->Destroy(); }
+		}
+	}
+	Buckets.Empty();
+
+	Super::Deinitialize();
+}
+
+
+AEnemy* UEnemyPoolSubsystem::TryAcquireEnemy( const TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform ) {
+	if ( !EnemyClass ) { return nullptr; }
+
+	FEnemyPoolBucket& Bucket = Buckets.FindOrAdd(EnemyClass.Get());
+
+	// Parked enemies can be destroyed externally (level streaming, editor), so skip stale entries
+	while ( Bucket.FreeEnemies.Num() > 0 ) {
+		AEnemy* Enemy = Bucket.FreeEnemies.Pop(EAllowShrinking::No);
+		if ( IsValid(Enemy) ) {
+			++Bucket.Stats.Hits;
+			Enemy->OnAcquiredFromPool(SpawnTransform);
+			return Enemy;
+		}
+	}
+
+	++Bucket.Stats.Misses;
+	return nullptr;
+}
+
+
+AEnemy* UEnemyPoolSubsystem::AcquireEnemy( const TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform ) {
+	if ( AEnemy* Enemy = TryAcquireEnemy(EnemyClass, SpawnTransform) ) { return Enemy; }
+	if ( !EnemyClass ) { return nullptr; }
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	return GetWorld()->SpawnActor<AEnemy>(EnemyClass, SpawnTransform, SpawnParams);
+}
+
+
+void UEnemyPoolSubsystem::ReleaseEnemy( AEnemy* Enemy ) {
+	if ( !IsValid(Enemy) ) { return; }
+
+	FEnemyPoolBucket& Bucket = Buckets.FindOrAdd(Enemy->GetClass());
+	if ( Bucket.FreeEnemies.Num() >= MaxPooledPerClass ) {
+		Enemy->Destroy();
+		return;
+	}
+
+	++Bucket.Stats.Releases;
+	Enemy->OnReturnedToPool(ParkLocation);
+	Bucket.FreeEnemies.Add(Enemy);
+}
+
+
+void UEnemyPoolSubsystem::PrewarmPool( const TSubclassOf<AEnemy> EnemyClass, const int32 Count ) {
+	if ( !EnemyClass || Count <= 0 ) { return; }
+
+	FEnemyPoolBucket& Bucket = Buckets.FindOrAdd(EnemyClass.Get());
+	const int32 NumToSpawn = FMath::Min(Count, MaxPooledPerClass - Bucket.FreeEnemies.Num());
+	Bucket.FreeEnemies.Reserve(Bucket.FreeEnemies.Num() + FMath::Max(NumToSpawn, 0));
+
+	for ( int32 Index = 0; Index < NumToSpawn; ++Index ) {
+		if ( AEnemy* Enemy = SpawnParkedEnemy(EnemyClass) ) {
+			Enemy->OnReturnedToPool(ParkLocation);
+			Bucket.FreeEnemies.Add(Enemy);
+			++Bucket.Stats.Prewarmed;
+		}
+	}
+}
+
+
+FEnemyPoolStats UEnemyPoolSubsystem::GetPoolStats( const TSubclassOf<AEnemy> EnemyClass ) const {
+	const FEnemyPoolBucket* Bucket = Buckets.Find(EnemyClass.Get());
+	return Bucket ? Bucket->Stats : FEnemyPoolStats();
+}
+
+
+void UEnemyPoolSubsystem::LogPoolStats() const {
+	for ( const TPair<TObjectPtr<UClass>, FEnemyPoolBucket>& Pair : Buckets ) {
+		const FEnemyPoolStats& Stats = Pair.Value.Stats;
+		const int32 Requests = Stats.Hits + Stats.Misses;
+		const float HitRate = Requests > 0 ? 100.0f * Stats.Hits / Requests : 0.0f;
+
+		UE_LOG(LogRiotWave, Display, TEXT("EnemyPool %s: Free=%d Hits=%d Misses=%d (%.1f%% hit rate) Releases=%d Prewarmed=%d"),
+			*GetNameSafe(Pair.Key), Pair.Value.FreeEnemies.Num(), Stats.Hits, Stats.Misses, HitRate, Stats.Releases, Stats.Prewarmed);
+	}
+}
+
+
+AEnemy* UEnemyPoolSubsystem::SpawnParkedEnemy( const TSubclassOf<AEnemy> EnemyClass ) {
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AEnemy>(EnemyClass, FTransform(ParkLocation), SpawnParams);
+}
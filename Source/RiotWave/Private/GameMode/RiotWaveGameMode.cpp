@@ -0,0 +1,45 @@
+// RiotWaveGameMode.cpp - Starts the wave director with the configured waves
+
+#include "GameMode/RiotWaveGameMode.h"
+
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/World.h"
+
+
+void ARiotWaveGameMode::StartPlay() {
+	Super::StartPlay();
+
+	if ( bPrewarmEnemyPool ) { PrewarmEnemyPool(); }
+
+	if ( bStartWavesOnPlay ) {
+		if ( UWaveDirectorSubsystem* Director = GetWorld()->GetSubsystem<UWaveDirectorSubsystem>() ) {
+			Director->StartWaves(Waves);
+		}
+	}
+}
+
+
+void ARiotWaveGameMode::PrewarmEnemyPool() const {
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if ( !EnemyPool ) { return; }
+
+	// Enemies from earlier waves are back in the pool by the time a later wave starts,
+	// so the peak of a single wave is enough rather than the sum over all waves
+	TMap<UClass*, int32> PeakCounts;
+	for ( const FWaveDefinition& Wave : Waves ) {
+		TMap<UClass*, int32> WaveCounts;
+		for ( const FWaveSpawnGroup& Group : Wave.SpawnGroups ) {
+			if ( Group.EnemyClass ) { WaveCounts.FindOrAdd(Group.EnemyClass.Get()) += Group.Count; }
+		}
+		for ( const TPair<UClass*, int32>& Pair : WaveCounts ) {
+			int32& Peak = PeakCounts.FindOrAdd(Pair.Key);
+			Peak = FMath::Max(Peak, Pair.Value);
+		}
+	}
+
+	for ( const TPair<UClass*, int32>& Pair : PeakCounts ) {
+		const FEnemyPoolStats Stats = EnemyPool->GetPoolStats(Pair.Key);
+		EnemyPool->PrewarmPool(Pair.Key, Pair.Value - Stats.Prewarmed);
+	}
+}
@@ -0,0 +1,402 @@
+// HordeSubsystem.cpp - Implements proxy simulation, instanced rendering and promotion/demotion
+//
+// Proxies only do what is visible from far away: walk their patrol legs or head towards
+// the nearest player. Combat, hits and behavior trees only exist once promoted. Each step
+// is kept on the navmesh with one projection; chasers borrow the flow field's direction.
+
+#include "Horde/HordeSubsystem.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Navigation/FlowFieldSubsystem.h"
+#include "NavigationSystem.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Horde Proxy Update"), STAT_HordeProxyUpdate, STATGROUP_Game);
+
+static int32 GHordeEnabled = 1;
+static FAutoConsoleVariableRef CVarHordeEnabled(
+	TEXT("RiotWave.Horde.Enabled"),
+	GHordeEnabled,
+	TEXT("1 = enemies spawned far from every player start as lightweight horde proxies."),
+	ECVF_Default
+);
+
+static int32 GHordeMaxPromotionsPerTick = 4;
+static FAutoConsoleVariableRef CVarHordeMaxPromotionsPerTick(
+	TEXT("RiotWave.Horde.MaxPromotionsPerTick"),
+	GHordeMaxPromotionsPerTick,
+	TEXT("Upper bound of proxies promoted to full enemies in a single frame, to avoid promotion spikes."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GHordeStatsCommand(
+	TEXT("RiotWave.Horde.Stats"),
+	TEXT("Prints horde proxy counts and promotion/demotion totals."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UHordeSubsystem* Horde = World ? World->GetSubsystem<UHordeSubsystem>() : nullptr ) { Horde->LogStats(); }
+	})
+);
+
+
+int32 FHordeFragments::Add() {
+	Positions.AddDefaulted();
+	Health.AddDefaulted();
+	PatrolPoints.AddDefaulted();
+	PatrolPoints2.AddDefaulted();
+	PatrolLegs.AddDefaulted();
+	Archetypes.AddDefaulted();
+	return Instances.AddDefaulted();
+}
+
+
+void FHordeFragments::RemoveAtSwap( const int32 Index ) {
+	Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Health.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PatrolPoints.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PatrolPoints2.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	PatrolLegs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Archetypes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Instances.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+
+bool UHordeSubsystem::IsHordeEnabled() {
+	return GHordeEnabled != 0;
+}
+
+
+bool UHordeSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UHordeSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHordeSubsystem, STATGROUP_Tickables);
+}
+
+
+void UHordeSubsystem::Deinitialize() {
+	if ( RenderActor ) { RenderActor->Destroy(); }
+	RenderActor = nullptr;
+
+	Super::Deinitialize();
+}
+
+
+bool UHordeSubsystem::ShouldSpawnAsProxy( const TSubclassOf<AEnemy> EnemyClass, const FVector& Location ) const {
+	if ( !IsHordeEnabled() || !EnemyClass || !EnemyClass->GetDefaultObject<AEnemy>()->GetHordeProxyMesh() ) { return false; }
+
+	TArray<FVector> PlayerLocations;
+	for ( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It ) {
+		if ( const APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr ) { PlayerLocations.Add(Pawn->GetActorLocation()); }
+	}
+	return ClosestPlayerDistSquared(Location, PlayerLocations) > FMath::Square(PromoteRadius);
+}
+
+
+void UHordeSubsystem::AddProxy( const TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform ) {
+	const int32 ArchetypeIndex = FindOrAddArchetype(EnemyClass);
+	if ( ArchetypeIndex == INDEX_NONE ) { return; }
+
+	const AEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AEnemy>();
+
+	// Same resolution AEnemy::InitPatrolPoint does, done once up front
+	const int32 ProxyIndex = Fragments.Add();
+	Fragments.Positions[ProxyIndex] = SpawnTransform.GetLocation();
+	Fragments.Health[ProxyIndex] = EnemyDefaults->GetMaxHealth();
+	Fragments.PatrolPoints[ProxyIndex] = SpawnTransform.TransformPosition(EnemyDefaults->GetPatrolPoint());
+	Fragments.PatrolPoints2[ProxyIndex] = SpawnTransform.TransformPosition(EnemyDefaults->GetPatrolPoint2());
+	Fragments.PatrolLegs[ProxyIndex] = 0;
+	Fragments.Archetypes[ProxyIndex] = ArchetypeIndex;
+	Fragments.Instances[ProxyIndex] = AcquireInstance(ArchetypeIndex, SpawnTransform);
+}
+
+
+void UHordeSubsystem::ClearProxies() {
+	for ( int32 Index = Fragments.Num() - 1; Index >= 0; --Index ) { RemoveProxyAt(Index); }
+	PromotedEnemies.Reset();
+}
+
+
+int32 UHordeSubsystem::FindOrAddArchetype( const TSubclassOf<AEnemy> EnemyClass ) {
+	if ( !EnemyClass ) { return INDEX_NONE; }
+
+	for ( int32 Index = 0; Index < Archetypes.Num(); ++Index ) {
+		if ( Archetypes[Index].EnemyClass == EnemyClass ) { return Index; }
+	}
+
+	const AEnemy* EnemyDefaults = EnemyClass->GetDefaultObject<AEnemy>();
+	UStaticMesh* ProxyMesh = EnemyDefaults->GetHordeProxyMesh();
+	if ( !ProxyMesh ) { return INDEX_NONE; }
+
+	if ( !RenderActor ) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		RenderActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	UInstancedStaticMeshComponent* InstancedMesh = NewObject<UInstancedStaticMeshComponent>(RenderActor);
+	InstancedMesh->SetMobility(EComponentMobility::Movable);
+	InstancedMesh->SetStaticMesh(ProxyMesh);
+	InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	InstancedMesh->SetGenerateOverlapEvents(false);
+	if ( !RenderActor->GetRootComponent() ) { RenderActor->SetRootComponent(InstancedMesh); }
+	InstancedMesh->RegisterComponent();
+	RenderActor->AddInstanceComponent(InstancedMesh);
+
+	FHordeArchetype& Archetype = Archetypes.AddDefaulted_GetRef();
+	Archetype.EnemyClass = EnemyClass;
+	Archetype.InstancedMesh = InstancedMesh;
+	Archetype.MoveSpeed = EnemyDefaults->GetCharacterMovement()->MaxWalkSpeed;
+	Archetype.MeshHeightOffset = EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+	Archetype.CapsuleRadius = EnemyDefaults->GetCapsuleComponent()->GetScaledCapsuleRadius();
+	return Archetypes.Num() - 1;
+}
+
+
+int32 UHordeSubsystem::AcquireInstance( const int32 ArchetypeIndex, const FTransform& Transform ) {
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh.Get();
+	if ( !InstancedMesh ) { return INDEX_NONE; }
+
+	FTransform InstanceTransform = Transform;
+	InstanceTransform.AddToTranslation(FVector(0.0f, 0.0f, -Archetype.MeshHeightOffset));
+
+	if ( Archetype.FreeInstances.Num() > 0 ) {
+		const int32 InstanceIndex = Archetype.FreeInstances.Pop(EAllowShrinking::No);
+		InstancedMesh->UpdateInstanceTransform(InstanceIndex, InstanceTransform, true, true, true);
+		return InstanceIndex;
+	}
+	return InstancedMesh->AddInstance(InstanceTransform, true);
+}
+
+
+void UHordeSubsystem::ReleaseInstance( const int32 ArchetypeIndex, const int32 InstanceIndex ) {
+	FHordeArchetype& Archetype = Archetypes[ArchetypeIndex];
+	UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh.Get();
+	if ( !InstancedMesh || InstanceIndex == INDEX_NONE ) { return; }
+
+	// Zero scale hides the slot without shifting the indices of other proxies
+	InstancedMesh->UpdateInstanceTransform(InstanceIndex, FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), true, true, true);
+	Archetype.FreeInstances.Add(InstanceIndex);
+}
+
+
+void UHordeSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_HordeProxyUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UHordeSubsystem::Tick);
+
+	if ( Fragments.Num() == 0 && PromotedEnemies.Num() == 0 ) { return; }
+
+	TArray<AActor*> Players;
+	TArray<FVector> PlayerLocations;
+	for ( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It ) {
+		if ( APawn* Pawn = It->Get() ? It->Get()->GetPawn() : nullptr ) {
+			Players.Add(Pawn);
+			PlayerLocations.Add(Pawn->GetActorLocation());
+		}
+	}
+
+	SimulateProxies(DeltaTime, Players, PlayerLocations);
+	UpdateRepresentations(PlayerLocations);
+}
+
+
+void UHordeSubsystem::SimulateProxies( const float DeltaTime, const TArray<AActor*>& Players, const TArray<FVector>& PlayerLocations ) {
+	constexpr float ArrivalDistance = 50.0f;
+	const float ChaseRadiusSquared = FMath::Square(ChaseRadius);
+	UFlowFieldSubsystem* FlowFields = GetWorld()->GetSubsystem<UFlowFieldSubsystem>();
+
+	for ( int32 Index = 0; Index < Fragments.Num(); ++Index ) {
+		FVector& Position = Fragments.Positions[Index];
+
+		int32 PlayerIndex = INDEX_NONE;
+		const bool bChasing = ClosestPlayerDistSquared(Position, PlayerLocations, &PlayerIndex) <= ChaseRadiusSquared;
+
+		FVector Destination;
+		if ( bChasing ) {
+			Destination = PlayerLocations[PlayerIndex];
+		} else {
+			Destination = Fragments.PatrolLegs[Index] == 0 ? Fragments.PatrolPoints[Index] : Fragments.PatrolPoints2[Index];
+		}
+
+		FVector ToDestination = Destination - Position;
+		ToDestination.Z = 0.0f;
+		const float Distance = ToDestination.Size();
+
+		if ( Distance <= ArrivalDistance ) {
+			if ( !bChasing ) { Fragments.PatrolLegs[Index] ^= 1; }
+			continue;
+		}
+
+		// The flow field routes around walls; outside of it the proxy heads straight for the player
+		FVector Direction = ToDestination / Distance;
+		if ( bChasing && FlowFields ) {
+			FVector FlowDirection;
+			if ( FlowFields->SampleDirection(Players[PlayerIndex], Position, FlowDirection) ) { Direction = FlowDirection; }
+		}
+
+		FHordeArchetype& Archetype = Archetypes[Fragments.Archetypes[Index]];
+		FVector NextPosition;
+		if ( !ProjectToNavMesh(Archetype, Position + Direction * FMath::Min(Archetype.MoveSpeed * DeltaTime, Distance), StepProjectionExtent, NextPosition) ) {
+			// Walked into a wall or off the navmesh; a patrolling proxy turns around instead of standing there
+			if ( !bChasing ) { Fragments.PatrolLegs[Index] ^= 1; }
+			continue;
+		}
+		Position = NextPosition;
+
+		if ( UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh.Get() ) {
+			const FTransform InstanceTransform(FRotator(0.0f, Direction.Rotation().Yaw, 0.0f), Position - FVector(0.0f, 0.0f, Archetype.MeshHeightOffset));
+			InstancedMesh->UpdateInstanceTransform(Fragments.Instances[Index], InstanceTransform, true, false, false);
+			Archetype.bInstancesDirty = true;
+		}
+	}
+
+	// One render state update per mesh that moved instead of one per moved instance
+	for ( FHordeArchetype& Archetype : Archetypes ) {
+		UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh.Get();
+		if ( InstancedMesh && Archetype.bInstancesDirty ) { InstancedMesh->MarkRenderStateDirty(); }
+		Archetype.bInstancesDirty = false;
+	}
+}
+
+
+bool UHordeSubsystem::ProjectToNavMesh( const FHordeArchetype& Archetype, const FVector& Location, const float HorizontalExtent, FVector& OutLocation ) const {
+	// Levels without a navmesh keep the plain straight-line movement rather than freezing every proxy
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if ( !NavSys || !NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) ) {
+		OutLocation = Location;
+		return true;
+	}
+
+	// Reaches from the capsule center down past the feet, so steps down a ledge stay on the floor below
+	FNavLocation NavLocation;
+	const FVector Extent(HorizontalExtent, HorizontalExtent, Archetype.MeshHeightOffset * 2.0f);
+	if ( !NavSys->ProjectPointToNavigation(Location, NavLocation, Extent) ) { return false; }
+
+	OutLocation = NavLocation.Location + FVector(0.0f, 0.0f, Archetype.MeshHeightOffset);
+	return true;
+}
+
+
+void UHordeSubsystem::UpdateRepresentations( const TArray<FVector>& PlayerLocations ) {
+	const float PromoteRadiusSquared = FMath::Square(PromoteRadius);
+	const float DemoteRadiusSquared = FMath::Square(FMath::Max(DemoteRadius, PromoteRadius));
+
+	int32 PromotionsLeft = GHordeMaxPromotionsPerTick;
+	for ( int32 Index = Fragments.Num() - 1; Index >= 0 && PromotionsLeft > 0; --Index ) {
+		if ( ClosestPlayerDistSquared(Fragments.Positions[Index], PlayerLocations) <= PromoteRadiusSquared ) {
+			PromoteProxy(Index);
+			--PromotionsLeft;
+		}
+	}
+
+	for ( int32 Index = PromotedEnemies.Num() - 1; Index >= 0; --Index ) {
+		AEnemy* Enemy = PromotedEnemies[Index].Get();
+		if ( !Enemy || Enemy->IsDead() ) {
+			PromotedEnemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		if ( ClosestPlayerDistSquared(Enemy->GetActorLocation(), PlayerLocations) > DemoteRadiusSquared ) {
+			PromotedEnemies.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			DemoteEnemy(Enemy);
+		}
+	}
+}
+
+
+void UHordeSubsystem::PromoteProxy( const int32 ProxyIndex ) {
+	const FHordeArchetype& Archetype = Archetypes[Fragments.Archetypes[ProxyIndex]];
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	if ( !EnemyPool ) { return; }
+
+	// The proxy stays alive and retries on a later tick when there is no room for the full enemy here
+	FVector Position;
+	if ( !ProjectToNavMesh(Archetype, Fragments.Positions[ProxyIndex], PromoteProjectionExtent, Position) ) { return; }
+
+	// Slightly smaller than the capsule and lifted off the floor, so only walls and ceilings count as encroaching
+	constexpr float FloorClearance = 5.0f;
+	const FCollisionShape Capsule = FCollisionShape::MakeCapsule(Archetype.CapsuleRadius * 0.9f, Archetype.MeshHeightOffset - FloorClearance);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(HordePromotion), false);
+	if ( GetWorld()->OverlapAnyTestByObjectType(Position + FVector(0.0f, 0.0f, FloorClearance), FQuat::Identity, FCollisionObjectQueryParams(ECC_WorldStatic), Capsule, QueryParams) ) { return; }
+
+	const FVector Heading = ( Fragments.PatrolLegs[ProxyIndex] == 0 ? Fragments.PatrolPoints[ProxyIndex] : Fragments.PatrolPoints2[ProxyIndex] ) - Position;
+	const FTransform SpawnTransform(FRotator(0.0f, Heading.Rotation().Yaw, 0.0f), Position);
+
+	AEnemy* Enemy = EnemyPool->AcquireEnemy(Archetype.EnemyClass, SpawnTransform);
+	if ( !Enemy ) { return; }
+
+	Enemy->ApplyHordeState(Fragments.Health[ProxyIndex], Fragments.PatrolPoints[ProxyIndex], Fragments.PatrolPoints2[ProxyIndex]);
+	RemoveProxyAt(ProxyIndex);
+
+	PromotedEnemies.Add(Enemy);
+	++TotalPromotions;
+	OnEnemyPromoted.Broadcast(Enemy);
+}
+
+
+void UHordeSubsystem::DemoteEnemy( AEnemy* Enemy ) {
+	const int32 ArchetypeIndex = FindOrAddArchetype(Enemy->GetClass());
+	if ( ArchetypeIndex == INDEX_NONE ) { return; }
+
+	OnEnemyDemoted.Broadcast(Enemy);
+
+	const int32 ProxyIndex = Fragments.Add();
+	Fragments.Positions[ProxyIndex] = Enemy->GetActorLocation();
+	Fragments.Health[ProxyIndex] = Enemy->GetHealth();
+	Fragments.PatrolPoints[ProxyIndex] = Enemy->GetWorldPatrolPoint();
+	Fragments.PatrolPoints2[ProxyIndex] = Enemy->GetWorldPatrolPoint2();
+	Fragments.PatrolLegs[ProxyIndex] = 0;
+	Fragments.Archetypes[ProxyIndex] = ArchetypeIndex;
+	Fragments.Instances[ProxyIndex] = AcquireInstance(ArchetypeIndex, Enemy->GetActorTransform());
+	++TotalDemotions;
+
+	if ( UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>() ) {
+		EnemyPool->ReleaseEnemy(Enemy);
+	} else {
+		Enemy->Destroy();
+	}
+}
+
+
+void UHordeSubsystem::RemoveProxyAt( const int32 ProxyIndex ) {
+	ReleaseInstance(Fragments.Archetypes[ProxyIndex], Fragments.Instances[ProxyIndex]);
+	Fragments.RemoveAtSwap(ProxyIndex);
+}
+
+
+float UHordeSubsystem::ClosestPlayerDistSquared( const FVector& Location, const TArray<FVector>& PlayerLocations, int32* OutPlayerIndex ) {
+	float ClosestDistSquared = MAX_flt;
+	for ( int32 Index = 0; Index < PlayerLocations.Num(); ++Index ) {
+		const float DistSquared = FVector::DistSquared(Location, PlayerLocations[Index]);
+		if ( DistSquared < ClosestDistSquared ) {
+			ClosestDistSquared = DistSquared;
+			if ( OutPlayerIndex ) { *OutPlayerIndex = Index; }
+		}
+	}
+	return ClosestDistSquared;
+}
+
+
+void UHordeSubsystem::LogStats() const {
+	UE_LOG(LogRiotWave, Display, TEXT("Horde: Proxies=%d Promoted=%d TotalPromotions=%d TotalDemotions=%d"),
+		Fragments.Num(), PromotedEnemies.Num(), TotalPromotions, TotalDemotions);
+
+	for ( const FHordeArchetype& Archetype : Archetypes ) {
+		const UInstancedStaticMeshComponent* InstancedMesh = Archetype.InstancedMesh.Get();
+		UE_LOG(LogRiotWave, Display, TEXT("  %s: Instances=%d FreeSlots=%d"),
+			*GetNameSafe(Archetype.EnemyClass), InstancedMesh ? InstancedMesh->GetInstanceCount() : 0, Archetype.FreeInstances.Num());
+	}
+}
@@ -0,0 +1,7 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interface/Proximity/ProximityListenerInterface.h"
+
+
+// Add default functionality here for any IProximityListenerInterface functions that are not pure virtual.
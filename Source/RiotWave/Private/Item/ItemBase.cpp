@@ -3,15 +3,17 @@
 
 #include "Item/ItemBase.h"
 
+#include "Audio/AudioEventSubsystem.h"
 #include "Components/SphereComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "Item/ItemDropSubsystem.h"
 #include "Player/PlayerCharacter.h"
+#include "Proximity/ProximitySubsystem.h"
 
 
 // Sets default values
 AItemBase::AItemBase() {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// Items only react to drops and pickups, never per frame
+	PrimaryActorTick.bCanEverTick = false;
 
 	DefaultRootScene = CreateDefaultSubobject<USceneComponent>("Root Component");
 	SetRootComponent(DefaultRootScene);
@@ -27,14 +29,27 @@ AItemBase::AItemBase() {
 void AItemBase::BeginPlay() {
 	Super::BeginPlay();
 
-	CollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AItemBase::OnOverlapBegin);
-	CollisionSphere->OnComponentEndOverlap.AddDynamic(this, &AItemBase::OnOverlapEnd);
+	// The sphere follows the simulated mesh, so the grid tracks the sphere rather than the root
+	UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>();
+	if (Proximity && UProximitySubsystem::IsGridEnabled()) {
+		Proximity->RegisterAgent(this, EProximityChannel::Pickup, CollisionSphere->GetScaledSphereRadius(), CollisionSphere);
+		CollisionSphere->SetGenerateOverlapEvents(false);
+		CollisionSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	} else {
+		CollisionSphere->OnComponentBeginOverlap.AddDynamic(this, &AItemBase::OnOverlapBegin);
+		CollisionSphere->OnComponentEndOverlap.AddDynamic(this, &AItemBase::OnOverlapEnd);
+	}
 
 	DropItem();	
 }
 
-// Called every frame
-void AItemBase::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
+void AItemBase::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->UnregisterAgent(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
 
 /**
@@ -50,17 +65,27 @@ void AItemBase::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
  * @param SweepResult The result of the sweep, if applicable.
  */
 void AItemBase::OnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult ) {
-	// Check if the overlapping actor is a player character
-	if ( Cast<APlayerCharacter>(OtherActor) ) {
+	// Check if the overlapping actor is a player character. Parked items ignore late pickup events
+	if ( Cast<APlayerCharacter>(OtherActor) && !IsHidden() ) {
 		// Call the ItemPicked event
 		void ItemPicked();
 
 		// Play the pickup sound at the item's location
 		if (PickupSound) {
-			UGameplayStatics::PlaySoundAtLocation(this, PickupSound, GetActorLocation());
+			UAudioEventSubsystem::PostSound(this, PickupSound, GetActorLocation(), RiotWaveSoundTags::Item_Pickup);
+		}
+		// Park the item for the next drop, or destroy it when there is no pool
+		if (UItemDropSubsystem* ItemDrops = GetWorld()->GetSubsystem<UItemDropSubsystem>()) {
+			ItemDrops->ReleaseItem(this);
+		} else {
+			Destroy();
 		}
-		// Destroy the item
-		Destroy();
+	}
+}
+
+void AItemBase::OnProximityBegin( const EProximityChannel Channel, AActor* Target ) {
+	if (Channel == EProximityChannel::Pickup) {
+		OnOverlapBegin(CollisionSphere, Target, nullptr, INDEX_NONE, false, FHitResult());
 	}
 }
 
@@ -70,7 +95,13 @@ void AItemBase::OnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor*
 void AItemBase::DropItem() {
 	// Play the drop sound at the item's location
 	if (DropSound) {
-		UGameplayStatics::PlaySoundAtLocation(this, DropSound, GetActorLocation());
+		UAudioEventSubsystem::PostSound(this, DropSound, GetActorLocation(), RiotWaveSoundTags::Item_Drop);
+	}
+
+	UItemDropSubsystem* ItemDrops = GetWorld()->GetSubsystem<UItemDropSubsystem>();
+	if (ItemDrops && UItemDropSubsystem::AreArcsEnabled() && !bSimulateDropPhysics) {
+		ItemDrops->LaunchItem(this);
+		return;
 	}
 
 	Mesh->SetSimulatePhysics(true);
@@ -81,15 +112,38 @@ void AItemBase::DropItem() {
 	const float RandomStrength = FMath::RandRange(329.0f, 400.8f);
 
 	Mesh->AddImpulse(RandomImpulseDirection * RandomStrength);
+
+	// Stopped once asleep or after a fixed time, rather than by a timer re-armed on every contact
+	if (ItemDrops) {
+		ItemDrops->AddPhysicsDrop(this);
+	}
 }
 
-void AItemBase::NotifyHit( class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit ) {
-	Super::NotifyHit(MyComp, Other, OtherComp, bSelfMoved, HitLocation, HitNormal, NormalImpulse, Hit);
 
-	FTimerHandle DropTimerHandle;
-	GetWorld()->GetTimerManager().SetTimer(DropTimerHandle, this, &AItemBase::DIsablePhysics, 4.0f, false);
+void AItemBase::OnAcquiredFromPool( const FTransform& SpawnTransform ) {
+	// The mesh may have come to rest away from the root as a rigid body
+	Mesh->AttachToComponent(DefaultRootScene, FAttachmentTransformRules::SnapToTargetNotIncludingScale);
+	SetActorLocationAndRotation(SpawnTransform.GetLocation(), SpawnTransform.GetRotation(), false, nullptr, ETeleportType::ResetPhysics);
+
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->SetAgentEnabled(this, true);
+	}
+
+	DropItem();
 }
 
-void AItemBase::DIsablePhysics() {
+
+void AItemBase::OnReturnedToPool( const FVector& ParkLocation ) {
 	Mesh->SetSimulatePhysics(false);
+
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->SetAgentEnabled(this, false);
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorLocation(ParkLocation, false, nullptr, ETeleportType::ResetPhysics);
 }
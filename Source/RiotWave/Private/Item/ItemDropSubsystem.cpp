@@ -0,0 +1,450 @@
+// ItemDropSubsystem.cpp - Implements item arcs, physics drop settling and the item pool
+
+#include "Item/ItemDropSubsystem.h"
+
+#include "Algo/Count.h"
+#include "Audio/AudioEventSubsystem.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Item/ItemBase.h"
+#include "Player/PlayerCharacter.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+#include "TimerManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Drops"), STAT_ItemDrops, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Arcs"), STAT_ItemArcs, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Physics Bodies"), STAT_ItemPhysicsBodies, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resting Item Instances"), STAT_RestingItemInstances, STATGROUP_Game);
+
+static int32 GItemArcDrops = 1;
+static FAutoConsoleVariableRef CVarItemArcDrops(
+	TEXT("RiotWave.Items.ArcDrops"),
+	GItemArcDrops,
+	TEXT("1 = dropped items fly a computed arc, 0 = every drop simulates rigid-body physics."),
+	ECVF_Default
+);
+
+static int32 GItemInstancing = 1;
+static FAutoConsoleVariableRef CVarItemInstancing(
+	TEXT("RiotWave.Items.Instancing"),
+	GItemInstancing,
+	TEXT("1 = items at rest are drawn as instances of one instanced mesh per item class, 0 = they stay actors."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GItemDropStatsCommand(
+	TEXT("RiotWave.Items.Stats"),
+	TEXT("Prints items in flight, simulating item bodies and how many of them are awake, item pool and instance counts, item primitive components and the world's timers."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UItemDropSubsystem* ItemDrops = World ? World->GetSubsystem<UItemDropSubsystem>() : nullptr ) { ItemDrops->LogStats(); }
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GItemSpawnTestCommand(
+	TEXT("RiotWave.Items.SpawnTest"),
+	TEXT("Drops items around the player to compare resting item cost with RiotWave.Items.Instancing 0 and 1. Arguments: item class path, count (default 500)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([]( const TArray<FString>& Args, UWorld* World ) {
+		UItemDropSubsystem* ItemDrops = World ? World->GetSubsystem<UItemDropSubsystem>() : nullptr;
+		const TSubclassOf<AItemBase> ItemClass = Args.Num() > 0 ? LoadClass<AItemBase>(nullptr, *Args[0]) : nullptr;
+		if ( !ItemDrops || !ItemClass ) {
+			UE_LOG(LogRiotWave, Warning, TEXT("Items: SpawnTest needs an item class path, e.g. /Game/Items/BP_Coin.BP_Coin_C"));
+			return;
+		}
+		ItemDrops->SpawnTestItems(ItemClass, Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 500);
+	})
+);
+
+
+bool UItemDropSubsystem::AreArcsEnabled() {
+	return GItemArcDrops != 0;
+}
+
+
+bool UItemDropSubsystem::IsInstancingEnabled() {
+	return GItemInstancing != 0;
+}
+
+
+bool UItemDropSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UItemDropSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemDropSubsystem, STATGROUP_Tickables);
+}
+
+
+void UItemDropSubsystem::Deinitialize() {
+	for ( TPair<TObjectPtr<UClass>, FItemPoolBucket>& Pair : Buckets ) {
+		for ( AItemBase* Item : Pair.Value.FreeItems ) {
+			if ( IsValid(Item) ) { Item->Destroy(); }
+		}
+	}
+	Buckets.Empty();
+	Arcs.Reset();
+	PhysicsDrops.Reset();
+
+	if ( InstanceActor ) { InstanceActor->Destroy(); }
+	InstanceActor = nullptr;
+	InstanceBuckets.Reset();
+
+	Super::Deinitialize();
+}
+
+
+AItemBase* UItemDropSubsystem::SpawnItem( const UObject* WorldContextObject, const TSubclassOf<AItemBase> ItemClass, const FTransform& Transform ) {
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if ( !World || !ItemClass ) { return nullptr; }
+
+	if ( UItemDropSubsystem* ItemDrops = World->GetSubsystem<UItemDropSubsystem>() ) { return ItemDrops->AcquireItem(ItemClass, Transform); }
+	return World->SpawnActor<AItemBase>(ItemClass, Transform);
+}
+
+
+AItemBase* UItemDropSubsystem::AcquireItem( const TSubclassOf<AItemBase> ItemClass, const FTransform& Transform ) {
+	if ( !ItemClass ) { return nullptr; }
+
+	// Parked items can be destroyed externally (level streaming, editor), so skip stale entries
+	FItemPoolBucket& Bucket = Buckets.FindOrAdd(ItemClass.Get());
+	while ( Bucket.FreeItems.Num() > 0 ) {
+		AItemBase* Item = Bucket.FreeItems.Pop(EAllowShrinking::No);
+		if ( IsValid(Item) ) {
+			++TotalReused;
+			Item->OnAcquiredFromPool(Transform);
+			return Item;
+		}
+	}
+
+	// A new item drops itself from BeginPlay
+	++TotalSpawned;
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return GetWorld()->SpawnActor<AItemBase>(ItemClass, Transform, SpawnParams);
+}
+
+
+void UItemDropSubsystem::ReleaseItem( AItemBase* Item ) {
+	if ( !IsValid(Item) ) { return; }
+
+	StopDrop(Item);
+
+	FItemPoolBucket& Bucket = Buckets.FindOrAdd(Item->GetClass());
+	if ( Bucket.FreeItems.Num() >= MaxPooledPerClass ) {
+		Item->Destroy();
+		return;
+	}
+
+	++TotalReleased;
+	Item->OnReturnedToPool(ParkLocation);
+	Bucket.FreeItems.Add(Item);
+}
+
+
+bool UItemDropSubsystem::TraceLanding( const AItemBase* Item, const FVector& Start, const FVector2D& Offset, const float PivotHeight, float& OutLandZ, float& OutClearFraction ) const {
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ItemDropGround), false, Item);
+	const FCollisionObjectQueryParams ObjectParams(ECC_WorldStatic);
+
+	const FVector TraceStart(Start.X + Offset.X, Start.Y + Offset.Y, Start.Z + ApexHeight);
+	const FVector TraceEnd(TraceStart.X, TraceStart.Y, Start.Z - GroundTraceDepth);
+	FHitResult Hit;
+	const bool bHitGround = GetWorld()->LineTraceSingleByObjectType(Hit, TraceStart, TraceEnd, ObjectParams, QueryParams);
+	OutLandZ = bHitGround ? Hit.ImpactPoint.Z + PivotHeight : Start.Z;
+
+	// The arc is moved without sweeps, so a wall between the drop and the landing point would be flown through
+	const FVector Landing(TraceStart.X, TraceStart.Y, OutLandZ);
+	if ( GetWorld()->LineTraceSingleByObjectType(Hit, Start, Landing, ObjectParams, QueryParams) ) {
+		OutClearFraction = Hit.Time;
+		return false;
+	}
+	OutClearFraction = 1.0f;
+	return true;
+}
+
+
+/**
+* The landing point is chosen before the arc: a random point on a ring around the item,
+* dropped onto the ground with one trace and checked for walls with a second one from the
+* start. A blocked point is pulled back in front of the wall, or straight below the start
+* when even that is blocked. Launch speed and flight time are then solved so the arc peaks
+* ApexHeight above the start and comes down exactly there.
+*/
+void UItemDropSubsystem::LaunchItem( AItemBase* Item ) {
+	if ( !IsValid(Item) ) { return; }
+
+	StopDrop(Item);
+
+	const FVector Start = Item->GetActorLocation();
+	const float Gravity = FMath::Max(-GetWorld()->GetGravityZ(), 1.0f);
+	const FVector2D Direction = FVector2D(FMath::VRand()).GetSafeNormal();
+	FVector2D Offset = ( Direction.IsZero() ? FVector2D(1.0f, 0.0f) : Direction ) * FMath::FRandRange(MinDropDistance, MaxDropDistance);
+
+	// Rests the bottom of the mesh on the ground rather than the actor's pivot
+	const float PivotHeight = FMath::Max(Start.Z - Item->GetMesh()->Bounds.GetBox().Min.Z, 0.0f);
+
+	float LandZ;
+	float ClearFraction;
+	if ( !TraceLanding(Item, Start, Offset, PivotHeight, LandZ, ClearFraction) ) {
+		++TotalBlockedLandings;
+		const float ClearDistance = Offset.Size() * ClearFraction - WallClearance;
+		Offset = ClearDistance > 0.0f ? Offset.GetSafeNormal() * ClearDistance : FVector2D::ZeroVector;
+		if ( !TraceLanding(Item, Start, Offset, PivotHeight, LandZ, ClearFraction) && !Offset.IsZero() ) {
+			Offset = FVector2D::ZeroVector;
+			TraceLanding(Item, Start, Offset, PivotHeight, LandZ, ClearFraction);
+		}
+	}
+
+	// Ground above the start still needs an arc that clears it
+	const float Apex = FMath::Max(ApexHeight, LandZ - Start.Z + ApexHeight * 0.5f);
+	const float VerticalSpeed = FMath::Sqrt(2.0f * Gravity * Apex);
+	const float FlightTime = ( VerticalSpeed + FMath::Sqrt(FMath::Max(VerticalSpeed * VerticalSpeed + 2.0f * Gravity * ( Start.Z - LandZ ), 0.0f)) ) / Gravity;
+
+	FItemArc& Arc = Arcs.AddDefaulted_GetRef();
+	Arc.Item = Item;
+	Arc.Start = Start;
+	Arc.Velocity = FVector(Offset.X / FlightTime, Offset.Y / FlightTime, VerticalSpeed);
+	Arc.StartRotation = Item->GetActorRotation();
+	Arc.Gravity = Gravity;
+	Arc.FlightTime = FlightTime;
+	Arc.LaunchTime = GetWorld()->GetTimeSeconds();
+	++TotalLaunched;
+}
+
+
+void UItemDropSubsystem::AddPhysicsDrop( AItemBase* Item ) {
+	if ( !IsValid(Item) ) { return; }
+
+	StopDrop(Item);
+	PhysicsDrops.Add({ Item, GetWorld()->GetTimeSeconds() });
+	++TotalPhysicsDrops;
+}
+
+
+void UItemDropSubsystem::StopDrop( const AItemBase* Item ) {
+	Arcs.RemoveAllSwap([Item]( const FItemArc& Arc ) { return Arc.Item.Get() == Item; }, EAllowShrinking::No);
+	PhysicsDrops.RemoveAllSwap([Item]( const FPhysicsDrop& Drop ) { return Drop.Item.Get() == Item; }, EAllowShrinking::No);
+}
+
+
+void UItemDropSubsystem::EvaluateArc( const FItemArc& Arc, const float Time, FVector& OutLocation, FRotator& OutRotation ) const {
+	const float FlightTime = FMath::Min(Time, Arc.FlightTime);
+	OutLocation = Arc.Start + Arc.Velocity * FlightTime;
+	OutLocation.Z -= 0.5f * Arc.Gravity * FlightTime * FlightTime;
+
+	// Two damped hops after touching down
+	if ( Time > Arc.FlightTime && SettleTime > 0.0f ) {
+		const float Settle = FMath::Min(( Time - Arc.FlightTime ) / SettleTime, 1.0f);
+		OutLocation.Z += SettleBounceHeight * ( 1.0f - Settle ) * FMath::Abs(FMath::Sin(2.0f * PI * Settle));
+	}
+
+	OutRotation = Arc.StartRotation;
+	OutRotation.Yaw += SpinDegreesPerSecond * FlightTime;
+}
+
+
+void UItemDropSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SET_DWORD_STAT(STAT_ItemArcs, Arcs.Num());
+	SET_DWORD_STAT(STAT_ItemPhysicsBodies, PhysicsDrops.Num());
+	SET_DWORD_STAT(STAT_RestingItemInstances, TotalInstanced - TotalInstancePickups);
+	if ( Arcs.Num() == 0 && PhysicsDrops.Num() == 0 && InstanceBuckets.Num() == 0 ) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_ItemDrops);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UItemDropSubsystem::Tick);
+
+	const double Now = GetWorld()->GetTimeSeconds();
+
+	// Converted after both loops, since parking an item removes it from the arrays being walked
+	TArray<AItemBase*, TInlineAllocator<16>> RestedItems;
+
+	// Backwards, so swap-removal only moves items that were already handled
+	for ( int32 Index = Arcs.Num() - 1; Index >= 0; --Index ) {
+		const FItemArc& Arc = Arcs[Index];
+		AItemBase* Item = Arc.Item.Get();
+		if ( !Item ) {
+			Arcs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const float Time = static_cast<float>(Now - Arc.LaunchTime);
+		FVector Location;
+		FRotator Rotation;
+		EvaluateArc(Arc, Time, Location, Rotation);
+		Item->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+		if ( Time >= Arc.FlightTime + SettleTime ) {
+			RestedItems.Add(Item);
+			Arcs.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		}
+	}
+
+	for ( int32 Index = PhysicsDrops.Num() - 1; Index >= 0; --Index ) {
+		const FPhysicsDrop& Drop = PhysicsDrops[Index];
+		AItemBase* Item = Drop.Item.Get();
+		if ( Item && Item->GetMesh()->IsSimulatingPhysics() && Item->GetMesh()->RigidBodyIsAwake() && Now - Drop.StartTime < MaxPhysicsTime ) { continue; }
+
+		if ( Item ) {
+			Item->GetMesh()->SetSimulatePhysics(false);
+			RestedItems.Add(Item);
+		}
+		PhysicsDrops.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	}
+
+	if ( IsInstancingEnabled() ) {
+		for ( AItemBase* Item : RestedItems ) { ConvertToInstance(Item); }
+	}
+
+	PickUpTouchedInstances();
+}
+
+
+UItemDropSubsystem::FInstanceBucket& UItemDropSubsystem::FindOrAddInstanceBucket( const AItemBase* Item ) {
+	FInstanceBucket& Bucket = InstanceBuckets.FindOrAdd(Item->GetClass());
+	if ( Bucket.Component ) { return Bucket; }
+
+	if ( !InstanceActor ) {
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		InstanceActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+	}
+
+	// Looks like the class's own mesh component, but nothing collides with or walks on a resting item
+	const UStaticMeshComponent* Mesh = Item->GetMesh();
+	UHierarchicalInstancedStaticMeshComponent* Component = NewObject<UHierarchicalInstancedStaticMeshComponent>(InstanceActor);
+	Component->SetStaticMesh(Mesh->GetStaticMesh());
+	for ( int32 MaterialIndex = 0; MaterialIndex < Mesh->GetNumMaterials(); ++MaterialIndex ) { Component->SetMaterial(MaterialIndex, Mesh->GetMaterial(MaterialIndex)); }
+	Component->SetCastShadow(Mesh->CastShadow);
+	Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Component->SetCanEverAffectNavigation(false);
+	if ( !InstanceActor->GetRootComponent() ) { InstanceActor->SetRootComponent(Component); }
+	Component->RegisterComponent();
+	InstanceActor->AddInstanceComponent(Component);
+
+	Bucket.Component = Component;
+	Bucket.PickupRadius = Item->GetCollisionSphere()->GetScaledSphereRadius();
+	Bucket.PickupSound = Item->GetPickupSound();
+	return Bucket;
+}
+
+
+bool UItemDropSubsystem::ConvertToInstance( AItemBase* Item ) {
+	if ( !IsValid(Item) || !Item->GetMesh()->GetStaticMesh() ) { return false; }
+
+	FInstanceBucket& Bucket = FindOrAddInstanceBucket(Item);
+	const FTransform Transform = Item->GetMesh()->GetComponentTransform();
+	const FVector PickupLocation = Item->GetCollisionSphere()->GetComponentLocation();
+
+	int32 Index;
+	if ( Bucket.FreeIndices.Num() > 0 ) {
+		Index = Bucket.FreeIndices.Pop(EAllowShrinking::No);
+		Bucket.Component->UpdateInstanceTransform(Index, Transform, true, true, true);
+		Bucket.PickupLocations[Index] = PickupLocation;
+		Bucket.Resting[Index] = true;
+	} else {
+		Index = Bucket.Component->AddInstance(Transform, true);
+		Bucket.PickupLocations.Add(PickupLocation);
+		Bucket.Resting.Add(true);
+	}
+	++TotalInstanced;
+	ReleaseItem(Item);
+	return true;
+}
+
+
+void UItemDropSubsystem::PickUpInstance( const TSubclassOf<AItemBase> ItemClass, const int32 Index ) {
+	FInstanceBucket* Bucket = InstanceBuckets.Find(ItemClass.Get());
+	if ( !Bucket || !Bucket->Resting.IsValidIndex(Index) || !Bucket->Resting[Index] ) { return; }
+
+	const FVector Location = Bucket->PickupLocations[Index];
+	if ( Bucket->PickupSound ) { UAudioEventSubsystem::PostSound(this, Bucket->PickupSound, Location, RiotWaveSoundTags::Item_Pickup); }
+
+	// Scaled to nothing rather than removed, so every other instance keeps its index
+	Bucket->Component->UpdateInstanceTransform(Index, FTransform(FQuat::Identity, Location, FVector::ZeroVector), true, true, true);
+	Bucket->Resting[Index] = false;
+	Bucket->FreeIndices.Add(Index);
+	++TotalInstancePickups;
+}
+
+
+void UItemDropSubsystem::PickUpTouchedInstances() {
+	if ( TotalInstanced == TotalInstancePickups ) { return; }
+
+	for ( FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It ) {
+		const APlayerController* PlayerController = It->Get();
+		const APlayerCharacter* Player = PlayerController ? Cast<APlayerCharacter>(PlayerController->GetPawn()) : nullptr;
+		if ( !Player ) { continue; }
+
+		const FVector PlayerLocation = Player->GetActorLocation();
+		const float PlayerRadius = Player->GetSimpleCollisionRadius();
+		for ( const TPair<TObjectKey<UClass>, FInstanceBucket>& Pair : InstanceBuckets ) {
+			const FInstanceBucket& Bucket = Pair.Value;
+			const float ReachSquared = FMath::Square(Bucket.PickupRadius + PlayerRadius);
+
+			// Collected first, since picking up clears bits of the array being walked
+			TArray<int32, TInlineAllocator<8>> Touched;
+			for ( TConstSetBitIterator<> Resting(Bucket.Resting); Resting; ++Resting ) {
+				if ( FVector::DistSquared(Bucket.PickupLocations[Resting.GetIndex()], PlayerLocation) <= ReachSquared ) { Touched.Add(Resting.GetIndex()); }
+			}
+			for ( const int32 Index : Touched ) { PickUpInstance(Pair.Key.ResolveObjectPtr(), Index); }
+		}
+	}
+}
+
+
+void UItemDropSubsystem::SpawnTestItems( const TSubclassOf<AItemBase> ItemClass, const int32 Count ) {
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	const APawn* Player = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if ( !ItemClass || !Player || Count <= 0 ) { return; }
+
+	// Starts a few meters ahead so the player does not pick the grid up straight away
+	constexpr float Spacing = 150.0f;
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	const FVector Origin = Player->GetActorLocation() + Player->GetActorForwardVector() * 500.0f;
+	for ( int32 Index = 0; Index < Count; ++Index ) {
+		const FVector Offset(( Index / Columns ) * Spacing, ( Index % Columns - Columns / 2 ) * Spacing, 0.0f);
+		AcquireItem(ItemClass, FTransform(Player->GetActorRotation().RotateVector(Offset) + Origin));
+	}
+}
+
+
+void UItemDropSubsystem::LogStats() const {
+	const double Now = GetWorld()->GetTimeSeconds();
+	const int32 NumSettling = Algo::CountIf(Arcs, [Now]( const FItemArc& Arc ) { return Now - Arc.LaunchTime >= Arc.FlightTime; });
+
+	int32 NumAwake = 0;
+	for ( const FPhysicsDrop& Drop : PhysicsDrops ) {
+		if ( const AItemBase* Item = Drop.Item.Get(); Item && Item->GetMesh()->RigidBodyIsAwake() ) { ++NumAwake; }
+	}
+
+	int32 NumFree = 0;
+	for ( const TPair<TObjectPtr<UClass>, FItemPoolBucket>& Pair : Buckets ) { NumFree += Pair.Value.FreeItems.Num(); }
+
+	// Registered item primitives outside the pool, each of which has its own scene proxy
+	int32 NumItemActors = 0;
+	int32 NumItemPrimitives = 0;
+	for ( TActorIterator<AItemBase> It(GetWorld()); It; ++It ) {
+		if ( It->IsHidden() ) { continue; }
+		++NumItemActors;
+		It->ForEachComponent<UPrimitiveComponent>(false, [&NumItemPrimitives]( const UPrimitiveComponent* Primitive ) {
+			if ( Primitive->IsRegistered() ) { ++NumItemPrimitives; }
+		});
+	}
+
+	const int32 NumInstances = TotalInstanced - TotalInstancePickups;
+	UE_LOG(LogRiotWave, Display, TEXT("Items: ArcDrops=%d Flying=%d Settling=%d PhysicsBodies=%d AwakeBodies=%d Launched=%d PhysicsDrops=%d Free=%d Reused=%d Spawned=%d Released=%d"),
+		GItemArcDrops, Arcs.Num() - NumSettling, NumSettling, PhysicsDrops.Num(), NumAwake, TotalLaunched, TotalPhysicsDrops, NumFree, TotalReused, TotalSpawned, TotalReleased);
+	UE_LOG(LogRiotWave, Display, TEXT("Items: Instancing=%d RestingInstances=%d InstanceComponents=%d InstancePickups=%d ItemActors=%d ItemPrimitives=%d Primitives=%d BlockedLandings=%d"),
+		GItemInstancing, NumInstances, InstanceBuckets.Num(), TotalInstancePickups, NumItemActors, NumItemPrimitives, NumItemPrimitives + InstanceBuckets.Num(), TotalBlockedLandings);
+
+	// Item drops arm no timers; the listing heads its sections with active, paused and pending counts to confirm it
+	UE_LOG(LogRiotWave, Display, TEXT("Items: World timers follow"));
+	GetWorld()->GetTimerManager().ListTimers();
+}
@@ -0,0 +1,368 @@
+// FlowFieldSubsystem.cpp - Implements flow field upkeep and sampling
+//
+// Per tick: drop idle fields, recenter fields whose target walked away, spend the projection
+// budget on unknown cells, and rerun the search where walkability changed or the goal moved far
+// or long enough ago. A full search over the default 81x81 grid touches each cell a handful of
+// times; the hysteresis and intervals keep a target pacing across a cell border, or a projection
+// batch trickling in over several ticks, from paying it every tick.
+
+#include "Navigation/FlowFieldSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationSystem.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Flow Field Update"), STAT_FlowFieldUpdate, STATGROUP_Game);
+
+static int32 GFlowFieldEnabled = 1;
+static FAutoConsoleVariableRef CVarFlowFieldEnabled(
+	TEXT("RiotWave.FlowField.Enabled"),
+	GFlowFieldEnabled,
+	TEXT("1 = chasing enemies steer by shared flow fields, 0 = every chaser pathfinds on its own."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GFlowFieldStatsCommand(
+	TEXT("RiotWave.FlowField.Stats"),
+	TEXT("Prints flow field counts, rebuild cost and the share of samples that fell back to pathfinding."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UFlowFieldSubsystem* FlowFields = World ? World->GetSubsystem<UFlowFieldSubsystem>() : nullptr ) { FlowFields->LogStats(); }
+	})
+);
+
+namespace {
+	/** Orthogonal neighbours first; diagonals are only taken when both adjacent orthogonals are walkable */
+	const FIntPoint NeighbourOffsets[] = {
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+		{ 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 }
+	};
+
+	constexpr int32 NumOrthogonalNeighbours = 4;
+
+	/** Cached height of cells that are not on the navmesh */
+	constexpr float BlockedHeight = -MAX_flt;
+}
+
+
+bool UFlowFieldSubsystem::IsFlowFieldEnabled() {
+	return GFlowFieldEnabled != 0;
+}
+
+
+bool UFlowFieldSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UFlowFieldSubsystem::OnWorldBeginPlay( UWorld& InWorld ) {
+	Super::OnWorldBeginPlay(InWorld);
+	Stats.StartTime = InWorld.GetTimeSeconds();
+
+	if ( UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld) ) {
+		NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UFlowFieldSubsystem::HandleNavigationGenerationFinished);
+	}
+}
+
+
+void UFlowFieldSubsystem::Deinitialize() {
+	if ( UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()) ) {
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UFlowFieldSubsystem::HandleNavigationGenerationFinished);
+	}
+	Super::Deinitialize();
+}
+
+
+TStatId UFlowFieldSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFlowFieldSubsystem, STATGROUP_Tickables);
+}
+
+
+FIntPoint UFlowFieldSubsystem::ToCell( const FVector& Location ) const {
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+
+bool UFlowFieldSubsystem::SampleDirection( AActor* Target, const FVector& Location, FVector& OutDirection ) {
+	++Stats.Samples;
+	if ( !Target || !IsFlowFieldEnabled() ) {
+		++Stats.SampleMisses;
+		return false;
+	}
+
+	FFlowField* Field = Fields.FindByPredicate([Target]( const FFlowField& Candidate ) { return Candidate.Target == Target; });
+	if ( !Field ) {
+		Field = &Fields.AddDefaulted_GetRef();
+		Field->Target = Target;
+		Field->CenterZ = Target->GetActorLocation().Z;
+		RecenterField(*Field, ToCell(Target->GetActorLocation()));
+	}
+	Field->LastSampledTime = GetWorld()->GetTimeSeconds();
+
+	const int32 Size = GetFieldSize();
+	const FIntPoint Local = ToCell(Location) - Field->OriginCell;
+	if ( !Field->bHasSearched || Local.X < 0 || Local.Y < 0 || Local.X >= Size || Local.Y >= Size ) {
+		++Stats.SampleMisses;
+		return false;
+	}
+
+	const int32 Index = Local.Y * Size + Local.X;
+	if ( Field->Distances[Index] == MAX_uint16 ) {
+		++Stats.SampleMisses;
+		return false;
+	}
+
+	// The goal cell has no step; head straight for the target inside it
+	const int8 Direction = Field->Directions[Index];
+	const FVector Step = Direction == INDEX_NONE
+		? Target->GetActorLocation() - Location
+		: FVector(NeighbourOffsets[Direction].X, NeighbourOffsets[Direction].Y, 0.0f);
+
+	OutDirection = FVector(Step.X, Step.Y, 0.0f).GetSafeNormal();
+	return true;
+}
+
+
+void UFlowFieldSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_FlowFieldUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFlowFieldSubsystem::Tick);
+
+	if ( Fields.Num() == 0 ) { return; }
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	int32 ProjectionBudget = MaxProjectionsPerTick;
+
+	for ( int32 FieldIndex = Fields.Num() - 1; FieldIndex >= 0; --FieldIndex ) {
+		FFlowField& Field = Fields[FieldIndex];
+		const AActor* Target = Field.Target.Get();
+		if ( !Target || WorldTime - Field.LastSampledTime > IdleFieldTimeout ) {
+			Fields.RemoveAtSwap(FieldIndex, 1, EAllowShrinking::No);
+			continue;
+		}
+
+		const FIntPoint TargetCell = ToCell(Target->GetActorLocation());
+		const FIntPoint FromCenter = TargetCell - ( Field.OriginCell + FIntPoint(FieldHalfExtentCells) );
+		const bool bRecenter = FMath::Max(FMath::Abs(FromCenter.X), FMath::Abs(FromCenter.Y)) > RecenterCells;
+		if ( bRecenter ) {
+			Field.CenterZ = Target->GetActorLocation().Z;
+			RecenterField(Field, TargetCell);
+		}
+
+		if ( ProjectionBudget > 0 && Field.PendingCells.Num() > 0 ) {
+			ProjectionBudget -= ResolvePendingCells(Field, ProjectionBudget);
+		}
+
+		const bool bGoalMoved = TargetCell != Field.GoalCell;
+		if ( !Field.bNeedsSearch && !bGoalMoved ) { continue; }
+
+		// New projections and a moved goal share one search
+		const double SinceSearch = WorldTime - Field.LastSearchTime;
+		const FIntPoint GoalDelta = TargetCell - Field.GoalCell;
+		const bool bProjectionsDue = Field.bNeedsSearch && ( Field.PendingCells.Num() == 0 || SinceSearch >= GoalSearchInterval );
+		const bool bGoalDue = bGoalMoved && ( FMath::Max(FMath::Abs(GoalDelta.X), FMath::Abs(GoalDelta.Y)) >= GoalHysteresisCells || SinceSearch >= GoalSearchInterval );
+
+		if ( bRecenter || !Field.bHasSearched || ( SinceSearch >= MinSearchInterval && ( bProjectionsDue || bGoalDue ) ) ) {
+			SearchField(Field);
+		} else {
+			++Stats.DeferredSearches;
+		}
+	}
+
+	// Fields keep their own copy of the states, so dropping the cache only costs re-projection
+	if ( CellHeightCache.Num() > MaxCachedCells ) { CellHeightCache.Reset(); }
+}
+
+
+void UFlowFieldSubsystem::RecenterField( FFlowField& Field, const FIntPoint& CenterCell ) const {
+	const int32 Size = GetFieldSize();
+	Field.OriginCell = CenterCell - FIntPoint(FieldHalfExtentCells);
+
+	Field.States.SetNumUninitialized(Size * Size);
+	Field.Heights.SetNumUninitialized(Size * Size);
+	Field.PendingCells.Reset();
+
+	for ( int32 Y = 0; Y < Size; ++Y ) {
+		for ( int32 X = 0; X < Size; ++X ) {
+			const int32 Index = Y * Size + X;
+			if ( const float* CachedHeight = CellHeightCache.Find(Field.OriginCell + FIntPoint(X, Y)) ) {
+				Field.States[Index] = *CachedHeight == BlockedHeight ? ECellState::Blocked : ECellState::Walkable;
+				Field.Heights[Index] = *CachedHeight;
+			} else {
+				Field.States[Index] = ECellState::Unknown;
+				Field.Heights[Index] = 0.0f;
+				Field.PendingCells.Add(Index);
+			}
+		}
+	}
+
+	SortPendingCells(Field);
+	Field.bNeedsSearch = true;
+}
+
+
+void UFlowFieldSubsystem::SortPendingCells( FFlowField& Field ) const {
+	// Resolved from the back, so the cells closest to the target come first
+	const int32 Size = GetFieldSize();
+	const FIntPoint Center(FieldHalfExtentCells);
+	Field.PendingCells.Sort([Size, Center]( const int32 A, const int32 B ) {
+		const int32 DistA = FMath::Max(FMath::Abs(A % Size - Center.X), FMath::Abs(A / Size - Center.Y));
+		const int32 DistB = FMath::Max(FMath::Abs(B % Size - Center.X), FMath::Abs(B / Size - Center.Y));
+		return DistA > DistB;
+	});
+}
+
+
+void UFlowFieldSubsystem::HandleNavigationGenerationFinished( ANavigationData* NavData ) {
+	++Stats.NavRebuilds;
+	CellHeightCache.Reset();
+
+	// Fields keep steering by their old states until the new projections come in
+	const int32 NumCells = GetFieldSize() * GetFieldSize();
+	for ( FFlowField& Field : Fields ) {
+		Field.PendingCells.Reset(NumCells);
+		for ( int32 Index = 0; Index < NumCells; ++Index ) { Field.PendingCells.Add(Index); }
+		SortPendingCells(Field);
+	}
+}
+
+
+int32 UFlowFieldSubsystem::ResolvePendingCells( FFlowField& Field, const int32 Budget ) {
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if ( !NavSys ) { return 0; }
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFlowFieldSubsystem::ResolvePendingCells);
+
+	const int32 Size = GetFieldSize();
+	const FVector ProjectionExtent(CellSize * 0.5f, CellSize * 0.5f, ProjectionHalfHeight);
+
+	int32 NumProjected = 0;
+	while ( Field.PendingCells.Num() > 0 && NumProjected < Budget ) {
+		const int32 Index = Field.PendingCells.Pop(EAllowShrinking::No);
+		const FIntPoint WorldCell = Field.OriginCell + FIntPoint(Index % Size, Index / Size);
+
+		// Another field may have projected this cell in the meantime
+		float* Height = CellHeightCache.Find(WorldCell);
+		if ( !Height ) {
+			const FVector CellCenter(( WorldCell.X + 0.5f ) * CellSize, ( WorldCell.Y + 0.5f ) * CellSize, Field.CenterZ);
+
+			FNavLocation NavLocation;
+			const bool bOnNavMesh = NavSys->ProjectPointToNavigation(CellCenter, NavLocation, ProjectionExtent);
+			Height = &CellHeightCache.Add(WorldCell, bOnNavMesh ? NavLocation.Location.Z : BlockedHeight);
+			++NumProjected;
+		}
+
+		Field.States[Index] = *Height == BlockedHeight ? ECellState::Blocked : ECellState::Walkable;
+		Field.Heights[Index] = *Height;
+		Field.bNeedsSearch = true;
+	}
+
+	Stats.NavProjections += NumProjected;
+	return NumProjected;
+}
+
+
+void UFlowFieldSubsystem::SearchField( FFlowField& Field ) {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UFlowFieldSubsystem::SearchField);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const int32 Size = GetFieldSize();
+	const int32 NumCells = Size * Size;
+	const FVector TargetLocation = Field.Target->GetActorLocation();
+
+	Field.GoalCell = ToCell(TargetLocation);
+	Field.LastSearchTime = GetWorld()->GetTimeSeconds();
+	Field.bNeedsSearch = false;
+	Field.bHasSearched = true;
+	Field.Distances.Init(MAX_uint16, NumCells);
+	Field.Directions.Init(INDEX_NONE, NumCells);
+
+	const FIntPoint GoalLocal = Field.GoalCell - Field.OriginCell;
+	if ( GoalLocal.X < 0 || GoalLocal.Y < 0 || GoalLocal.X >= Size || GoalLocal.Y >= Size ) { return; }
+	const int32 GoalIndex = GoalLocal.Y * Size + GoalLocal.X;
+
+	// The target stands in its cell, so the goal counts as walkable even if the projection missed it
+	auto IsOpen = [&]( const int32 Index ) { return Index == GoalIndex || Field.States[Index] == ECellState::Walkable; };
+	auto CanStep = [&]( const int32 X, const int32 Y, const int32 NeighbourIndex, int32& OutIndex ) {
+		const FIntPoint Offset = NeighbourOffsets[NeighbourIndex];
+		const int32 NX = X + Offset.X;
+		const int32 NY = Y + Offset.Y;
+		if ( NX < 0 || NY < 0 || NX >= Size || NY >= Size ) { return false; }
+
+		OutIndex = NY * Size + NX;
+		if ( !IsOpen(OutIndex) ) { return false; }
+		if ( NeighbourIndex >= NumOrthogonalNeighbours && ( !IsOpen(Y * Size + NX) || !IsOpen(NY * Size + X) ) ) { return false; }
+
+		const int32 FromIndex = Y * Size + X;
+		return FromIndex == GoalIndex || OutIndex == GoalIndex || FMath::Abs(Field.Heights[OutIndex] - Field.Heights[FromIndex]) <= MaxStepHeight;
+	};
+
+	TArray<int32> Queue;
+	Queue.Reserve(NumCells);
+	Queue.Add(GoalIndex);
+	Field.Distances[GoalIndex] = 0;
+
+	for ( int32 Head = 0; Head < Queue.Num(); ++Head ) {
+		const int32 Index = Queue[Head];
+		const int32 X = Index % Size;
+		const int32 Y = Index / Size;
+		const uint16 NextDistance = Field.Distances[Index] + 1;
+
+		for ( int32 NeighbourIndex = 0; NeighbourIndex < UE_ARRAY_COUNT(NeighbourOffsets); ++NeighbourIndex ) {
+			int32 Neighbour;
+			if ( CanStep(X, Y, NeighbourIndex, Neighbour) && Field.Distances[Neighbour] == MAX_uint16 ) {
+				Field.Distances[Neighbour] = NextDistance;
+				Queue.Add(Neighbour);
+			}
+		}
+	}
+
+	// Among equally short steps prefer the one pointing most directly at the goal, which keeps diagonal runs straight
+	for ( const int32 Index : Queue ) {
+		if ( Index == GoalIndex ) { continue; }
+
+		const int32 X = Index % Size;
+		const int32 Y = Index / Size;
+		const FVector2D ToGoal = FVector2D(GoalLocal.X - X, GoalLocal.Y - Y).GetSafeNormal();
+
+		uint16 BestDistance = Field.Distances[Index];
+		float BestAlignment = -MAX_flt;
+		for ( int32 NeighbourIndex = 0; NeighbourIndex < UE_ARRAY_COUNT(NeighbourOffsets); ++NeighbourIndex ) {
+			int32 Neighbour;
+			if ( !CanStep(X, Y, NeighbourIndex, Neighbour) ) { continue; }
+
+			const uint16 Distance = Field.Distances[Neighbour];
+			const float Alignment = FVector2D::DotProduct(FVector2D(NeighbourOffsets[NeighbourIndex]).GetSafeNormal(), ToGoal);
+			if ( Distance < BestDistance || ( Distance == BestDistance && Distance < Field.Distances[Index] && Alignment > BestAlignment ) ) {
+				BestDistance = Distance;
+				BestAlignment = Alignment;
+				Field.Directions[Index] = static_cast<int8>(NeighbourIndex);
+			}
+		}
+	}
+
+	const double RebuildMs = ( FPlatformTime::Seconds() - StartTime ) * 1000.0;
+	++Stats.Rebuilds;
+	Stats.TotalRebuildMs += RebuildMs;
+	Stats.MaxRebuildMs = FMath::Max(Stats.MaxRebuildMs, RebuildMs);
+}
+
+
+void UFlowFieldSubsystem::LogStats() const {
+	const double Elapsed = GetWorld()->GetTimeSeconds() - Stats.StartTime;
+
+	UE_LOG(LogRiotWave, Display, TEXT("FlowField: Fields=%d CachedCells=%d NavRebuilds=%d NavProjections=%d Samples=%d Fallbacks=%d (%.1f%%)"),
+		Fields.Num(), CellHeightCache.Num(), Stats.NavRebuilds, Stats.NavProjections, Stats.Samples, Stats.SampleMisses,
+		Stats.Samples > 0 ? 100.0 * Stats.SampleMisses / Stats.Samples : 0.0);
+	UE_LOG(LogRiotWave, Display, TEXT("FlowField: Searches=%d over %d cells each, AvgMs=%.3f MaxMs=%.3f, %.1f searches/s costing %.3f ms/s, DeferredSearches=%d"),
+		Stats.Rebuilds, GetFieldSize() * GetFieldSize(), Stats.Rebuilds > 0 ? Stats.TotalRebuildMs / Stats.Rebuilds : 0.0, Stats.MaxRebuildMs,
+		Elapsed > 0.0 ? Stats.Rebuilds / Elapsed : 0.0, Elapsed > 0.0 ? Stats.TotalRebuildMs / Elapsed : 0.0, Stats.DeferredSearches);
+
+	for ( const FFlowField& Field : Fields ) {
+		UE_LOG(LogRiotWave, Display, TEXT("  %s: Origin=(%d, %d) PendingCells=%d"),
+			*GetNameSafe(Field.Target.Get()), Field.OriginCell.X, Field.OriginCell.Y, Field.PendingCells.Num());
+	}
+}
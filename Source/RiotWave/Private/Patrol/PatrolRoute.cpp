@@ -0,0 +1,37 @@
+// PatrolRoute.cpp - Spline-backed patrol route
+
+#include "Patrol/PatrolRoute.h"
+
+#include "Components/SplineComponent.h"
+#include "Patrol/PatrolRouteSubsystem.h"
+
+
+APatrolRoute::APatrolRoute() {
+	PrimaryActorTick.bCanEverTick = false;
+
+	Spline = CreateDefaultSubobject<USplineComponent>(TEXT("Spline"));
+	SetRootComponent(Spline);
+}
+
+
+void APatrolRoute::BeginPlay() {
+	Super::BeginPlay();
+
+	if ( UPatrolRouteSubsystem* PatrolRoutes = GetWorld()->GetSubsystem<UPatrolRouteSubsystem>() ) {
+		PatrolRoutes->FindOrBuildRoute(this);
+	}
+}
+
+
+void APatrolRoute::GetRoutePoints( TArray<FVector>& OutPoints ) const {
+	const int32 NumPoints = Spline->GetNumberOfSplinePoints();
+	OutPoints.Reset(NumPoints);
+	for ( int32 Index = 0; Index < NumPoints; ++Index ) {
+		OutPoints.Add(Spline->GetLocationAtSplinePoint(Index, ESplineCoordinateSpace::World));
+	}
+}
+
+
+bool APatrolRoute::IsClosedLoop() const {
+	return Spline->IsClosedLoop();
+}
@@ -0,0 +1,209 @@
+// PatrolRouteSubsystem.cpp - Implements the patrol path cache and path query counters
+
+#include "Patrol/PatrolRouteSubsystem.h"
+
+#include "AIController.h"
+#include "Algo/Reverse.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "NavigationData.h"
+#include "NavigationSystem.h"
+#include "Patrol/PatrolRoute.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemy Path Queries"), STAT_EnemyPathQueries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cached Patrol Leg Moves"), STAT_CachedPatrolLegMoves, STATGROUP_Game);
+
+static FAutoConsoleCommandWithWorld GPatrolStatsCommand(
+	TEXT("RiotWave.Patrol.Stats"),
+	TEXT("Prints cached patrol routes, path queries made by enemies and queries per second since the previous call."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( UPatrolRouteSubsystem* PatrolRoutes = World ? World->GetSubsystem<UPatrolRouteSubsystem>() : nullptr ) { PatrolRoutes->LogStats(); }
+	})
+);
+
+
+FVector FPatrolRoutePath::GetLegStart( const int32 LegIndex ) const {
+	const int32 NumForwardLegs = Points.Num() - 1;
+	if ( bClosedLoop || LegIndex < NumForwardLegs ) { return Points[LegIndex % Points.Num()]; }
+	return Points[Points.Num() - 1 - ( LegIndex - NumForwardLegs )];
+}
+
+
+FVector FPatrolRoutePath::GetLegEnd( const int32 LegIndex ) const {
+	return GetLegStart(GetNextLeg(LegIndex));
+}
+
+
+bool UPatrolRouteSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+const FPatrolRoutePath* UPatrolRouteSubsystem::FindOrBuildRoute( const APatrolRoute* Route ) {
+	if ( !Route ) { return nullptr; }
+
+	if ( const FPatrolRoutePath* Cached = ActorRoutes.Find(Route) ) { return Cached; }
+
+	FPatrolRoutePath NewRoute;
+	Route->GetRoutePoints(NewRoute.Points);
+	NewRoute.bClosedLoop = Route->IsClosedLoop();
+
+	// Not cached on failure, so a route requested before the navmesh was ready is built again on the next request
+	if ( !BuildLegs(NewRoute) ) { return nullptr; }
+	return &ActorRoutes.Add(Route, MoveTemp(NewRoute));
+}
+
+
+const FPatrolRoutePath* UPatrolRouteSubsystem::FindOrBuildRoute( const TArray<FVector>& Points, const bool bClosedLoop ) {
+	FPointRouteKey Key;
+	Key.bClosedLoop = bClosedLoop;
+	Key.Points.Reserve(Points.Num());
+	for ( const FVector& Point : Points ) {
+		Key.Points.Add(FIntVector(FMath::RoundToInt32(Point.X / PointQuantization), FMath::RoundToInt32(Point.Y / PointQuantization), FMath::RoundToInt32(Point.Z / PointQuantization)));
+	}
+
+	++PointRouteUseCounter;
+	if ( FPointRouteEntry* Cached = PointRoutes.Find(Key) ) {
+		Cached->LastUse = PointRouteUseCounter;
+		return &Cached->Route;
+	}
+
+	FPointRouteEntry NewEntry;
+	NewEntry.Route.Points = Points;
+	NewEntry.Route.bClosedLoop = bClosedLoop;
+	NewEntry.LastUse = PointRouteUseCounter;
+	if ( !BuildLegs(NewEntry.Route) ) { return nullptr; }
+
+	// Spawn points are random, so this cache can grow with every wave. A full cache gives up the route
+	// nobody asked for the longest; the scan only runs when a new route is built, which already costs path queries
+	if ( PointRoutes.Num() >= MaxCachedPointRoutes ) {
+		const TPair<FPointRouteKey, FPointRouteEntry>* Oldest = nullptr;
+		for ( const TPair<FPointRouteKey, FPointRouteEntry>& Pair : PointRoutes ) {
+			if ( !Oldest || Pair.Value.LastUse < Oldest->Value.LastUse ) { Oldest = &Pair; }
+		}
+		if ( Oldest ) {
+			// Copied, the map must not compare against the element it is removing
+			const FPointRouteKey OldestKey = Oldest->Key;
+			PointRoutes.Remove(OldestKey);
+			++EvictedPointRoutes;
+		}
+	}
+
+	return &PointRoutes.Add(MoveTemp(Key), MoveTemp(NewEntry)).Route;
+}
+
+
+void UPatrolRouteSubsystem::OnWorldBeginPlay( UWorld& InWorld ) {
+	Super::OnWorldBeginPlay(InWorld);
+
+	if ( UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(&InWorld) ) {
+		NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UPatrolRouteSubsystem::HandleNavigationGenerationFinished);
+	}
+}
+
+
+void UPatrolRouteSubsystem::Deinitialize() {
+	if ( UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()) ) {
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UPatrolRouteSubsystem::HandleNavigationGenerationFinished);
+	}
+	Super::Deinitialize();
+}
+
+
+void UPatrolRouteSubsystem::HandleNavigationGenerationFinished( ANavigationData* NavData ) {
+	// Legs that found no path may have one on the new navmesh; drop those routes so their next request rebuilds them
+	const auto HasMissingLeg = []( const FPatrolRoutePath& Route ) {
+		return Route.Legs.ContainsByPredicate([]( const TArray<FVector>& Leg ) { return Leg.Num() < 2; });
+	};
+
+	for ( auto It = ActorRoutes.CreateIterator(); It; ++It ) {
+		if ( HasMissingLeg(It.Value()) ) { It.RemoveCurrent(); }
+	}
+	for ( auto It = PointRoutes.CreateIterator(); It; ++It ) {
+		if ( HasMissingLeg(It.Value().Route) ) { It.RemoveCurrent(); }
+	}
+}
+
+
+bool UPatrolRouteSubsystem::BuildLegs( FPatrolRoutePath& Route ) {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UPatrolRouteSubsystem::BuildLegs);
+
+	Route.Legs.Reset();
+	if ( Route.Points.Num() < 2 ) { return false; }
+
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* NavData = NavSys ? NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate) : nullptr;
+	if ( !NavData ) { return false; }
+
+	const int32 NumForwardLegs = Route.bClosedLoop ? Route.Points.Num() : Route.Points.Num() - 1;
+	Route.Legs.SetNum(Route.bClosedLoop ? NumForwardLegs : NumForwardLegs * 2);
+
+	for ( int32 LegIndex = 0; LegIndex < NumForwardLegs; ++LegIndex ) {
+		const FVector Start = Route.Points[LegIndex];
+		const FVector End = Route.Points[( LegIndex + 1 ) % Route.Points.Num()];
+
+		FPathFindingQuery Query(this, *NavData, Start, End);
+		const FPathFindingResult Result = NavSys->FindPathSync(Query);
+		++RouteBuildQueries;
+		if ( !Result.IsSuccessful() || !Result.Path.IsValid() ) { continue; }
+
+		TArray<FVector>& LegPoints = Route.Legs[LegIndex];
+		for ( const FNavPathPoint& PathPoint : Result.Path->GetPathPoints() ) { LegPoints.Add(PathPoint.Location); }
+	}
+
+	if ( !Route.Legs.ContainsByPredicate([]( const TArray<FVector>& Leg ) { return Leg.Num() >= 2; }) ) {
+		Route.Legs.Reset();
+		return false;
+	}
+
+	// The way back walks the forward legs in reverse order, each reversed
+	if ( !Route.bClosedLoop ) {
+		for ( int32 LegIndex = 0; LegIndex < NumForwardLegs; ++LegIndex ) {
+			TArray<FVector>& ReverseLeg = Route.Legs[NumForwardLegs * 2 - 1 - LegIndex];
+			ReverseLeg = Route.Legs[LegIndex];
+			Algo::Reverse(ReverseLeg);
+		}
+	}
+	return true;
+}
+
+
+FAIRequestID UPatrolRouteSubsystem::RequestLegMove( AAIController* Controller, const FPatrolRoutePath& Route, const int32 LegIndex, const float AcceptanceRadius ) {
+	if ( !Controller || !Route.Legs.IsValidIndex(LegIndex) || Route.Legs[LegIndex].Num() < 2 ) { return FAIRequestID::InvalidRequest; }
+
+	const FNavPathSharedPtr Path = MakeShared<FNavigationPath, ESPMode::ThreadSafe>(Route.Legs[LegIndex]);
+	if ( const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()) ) {
+		Path->SetNavigationDataUsed(NavSys->GetDefaultNavDataInstance(FNavigationSystem::DontCreate));
+	}
+
+	FAIMoveRequest MoveRequest(Route.Legs[LegIndex].Last());
+	MoveRequest.SetAcceptanceRadius(AcceptanceRadius);
+
+	const FAIRequestID RequestID = Controller->RequestMove(MoveRequest, Path);
+	if ( RequestID.IsValid() ) {
+		INC_DWORD_STAT(STAT_CachedPatrolLegMoves);
+		++CachedLegMoves;
+	}
+	return RequestID;
+}
+
+
+void UPatrolRouteSubsystem::RecordPathQuery() {
+	INC_DWORD_STAT(STAT_EnemyPathQueries);
+	++EnemyPathQueries;
+}
+
+
+void UPatrolRouteSubsystem::LogStats() {
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double Elapsed = Now - LastLogTime;
+	const double QueriesPerSecond = Elapsed > 0.0 ? ( EnemyPathQueries - EnemyPathQueriesAtLastLog ) / Elapsed : 0.0;
+
+	UE_LOG(LogRiotWave, Display, TEXT("Patrol: RouteActors=%d PointRoutes=%d EvictedPointRoutes=%d RouteBuildQueries=%d CachedLegMoves=%d EnemyPathQueries=%d (%.2f/s over the last %.1fs)"),
+		ActorRoutes.Num(), PointRoutes.Num(), EvictedPointRoutes, RouteBuildQueries, CachedLegMoves, EnemyPathQueries, QueriesPerSecond, Elapsed);
+
+	EnemyPathQueriesAtLastLog = EnemyPathQueries;
+	LastLogTime = Now;
+}
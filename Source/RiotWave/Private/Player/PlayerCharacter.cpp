@@ -5,10 +5,11 @@
 
 #include "Player/PlayerCharacter.h"
 
+#include "Audio/AudioEventSubsystem.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "GameFramework/SpringArmComponent.h"
-#include "Kismet/GameplayStatics.h"
+#include "Proximity/ProximitySubsystem.h"
 #include "Weapon/WeaponHandlingComponent.h"
 
 /**
@@ -17,9 +18,9 @@
  * before Blueprint construction scripts run and to support editor preview.
  */
 APlayerCharacter::APlayerCharacter() {
-	// Enable Tick() for continuous updates. This is necessary for smooth
-	// camera movement and potential animation blending.
-	PrimaryActorTick.bCanEverTick = true;
+	// Camera, movement and animation update through their components,
+	// so the actor itself has nothing to do per frame.
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Spring arm setup provides smooth camera behavior and collision handling.
 	// Attached to root to ensure it moves with the character's collision capsule.
@@ -68,18 +69,30 @@ UWeaponHandlingComponent* APlayerCharacter::GetWeaponHandlingComponent() {
 }
 
 /**
- * Called when gameplay begins. Currently minimal as most initialization
- * is handled in constructor for editor preview support.
- * Kept for potential future runtime-only initialization needs.
+ * Called when gameplay begins. Most initialization is handled in the constructor
+ * for editor preview support; here the character registers itself as a target
+ * so enemies, weapons and items can detect it without overlap spheres.
+ * The weapon handling component is created now rather than on the first pickup,
+ * so its weapon slot meshes are registered before gameplay needs them.
  */
-void APlayerCharacter::BeginPlay() { Super::BeginPlay(); }
+void APlayerCharacter::BeginPlay() {
+	Super::BeginPlay();
+
+	GetWeaponHandlingComponent();
+
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->RegisterTarget(this, GetCapsuleComponent()->GetScaledCapsuleRadius());
+	}
+}
+
+void APlayerCharacter::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	if (UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>()) {
+		Proximity->UnregisterTarget(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
 
-/**
- * Frame update function. Currently minimal as component Tick functions
- * handle most continuous behavior. Kept for potential future 
- * character-specific update needs.
- */
-void APlayerCharacter::Tick( float DeltaTime ) { Super::Tick(DeltaTime); }
 void APlayerCharacter::Death() {
 	GetMesh()->bPauseAnims = true;
 	GetMesh()->bNoSkeletonUpdate = true;
@@ -87,8 +100,10 @@ void APlayerCharacter::Death() {
 	APlayerController* PlayerController = Cast<APlayerController>(GetController());
 	if (PlayerController) {
 		PlayerController->DisableInput(PlayerController);
-	} GetPlayerMesh()->SetVisibility(false);
-	UGameplayStatics::PlaySoundAtLocation(GetWorld(), DeathSound, GetActorLocation());
+	}
+	// Propagated, so the attached weapon meshes hide with the arms
+	GetPlayerMesh()->SetVisibility(false, true);
+	UAudioEventSubsystem::PostSound(this, DeathSound, GetActorLocation(), RiotWaveSoundTags::Player_Death);
 }
 
 float APlayerCharacter::TakeDamage( float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser ) {
@@ -100,7 +115,7 @@ float APlayerCharacter::TakeDamage( float DamageAmount, FDamageEvent const& Dama
 		Health -= DamageAmount;
 
 		if (ImpactSound) {
-			UGameplayStatics::PlaySoundAtLocation(GetWorld(), ImpactSound, GetActorLocation());
+			UAudioEventSubsystem::PostSound(this, ImpactSound, GetActorLocation(), RiotWaveSoundTags::Player_Impact);
 		}
 	} return DamageAmount;
 }
@@ -0,0 +1,134 @@
+// ShotLatency.cpp - Implements shot latency markers, Insights output and histograms
+
+#include "Profiling/ShotLatency.h"
+
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/MiscTrace.h"
+#include "RiotWave.h"
+#include "UObject/ObjectKey.h"
+
+TRACE_DECLARE_FLOAT_COUNTER(ShotLatencyFire, TEXT("RiotWave/ShotLatency/FireMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShotLatencyTrace, TEXT("RiotWave/ShotLatency/TraceMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShotLatencyDamage, TEXT("RiotWave/ShotLatency/DamageMs"));
+TRACE_DECLARE_FLOAT_COUNTER(ShotLatencyEffects, TEXT("RiotWave/ShotLatency/EffectsMs"));
+
+static FAutoConsoleCommand GShotLatencyCommand(
+	TEXT("RiotWave.ShotLatency"),
+	TEXT("Prints p50, p95 and p99 latency from trigger press to fire, trace, damage and effects. Argument 'reset' clears the histograms."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([]( const TArray<FString>& Args ) {
+		if ( Args.Num() > 0 && Args[0] == TEXT("reset") ) {
+			FShotLatency::Reset();
+			return;
+		}
+		FShotLatency::LogStats();
+	})
+);
+
+namespace {
+	constexpr int32 NumStages = static_cast<int32>(EShotLatencyStage::Num);
+
+	const TCHAR* const StageNames[NumStages] = { TEXT("Fire"), TEXT("Trace"), TEXT("Damage"), TEXT("Effects") };
+
+	/** Bucket 0 ends at MinMs, every further bucket is Growth times wider; the last one catches the rest */
+	constexpr int32 NumBuckets = 64;
+	constexpr double MinMs = 0.01;
+	constexpr double Growth = 1.25;
+
+	struct FLatencyHistogram {
+		uint32 Buckets[NumBuckets] = {};
+		uint32 Count = 0;
+		double MaxMs = 0.0;
+		uint64 TotalFrames = 0;
+
+		void Add( const double Ms, const uint64 Frames ) {
+			const int32 Bucket = Ms <= MinMs ? 0 : FMath::Min(FMath::CeilToInt(FMath::LogX(Growth, Ms / MinMs)), NumBuckets - 1);
+			++Buckets[Bucket];
+			++Count;
+			MaxMs = FMath::Max(MaxMs, Ms);
+			TotalFrames += Frames;
+		}
+
+		/** Upper edge of the bucket holding the Fraction quantile, clamped to the largest sample */
+		double GetPercentileMs( const double Fraction ) const {
+			const uint64 Rank = FMath::Max<uint64>(FMath::CeilToInt64(Fraction * Count), 1);
+			uint64 Seen = 0;
+			for ( int32 Bucket = 0; Bucket < NumBuckets; ++Bucket ) {
+				Seen += Buckets[Bucket];
+				if ( Seen >= Rank ) { return FMath::Min(MinMs * FMath::Pow(Growth, Bucket), MaxMs); }
+			}
+			return MaxMs;
+		}
+	};
+
+	/** The shot a shooter's last press started */
+	struct FPendingShot {
+		uint64 InputCycles = 0;
+		uint64 InputFrame = 0;
+		uint32 ShotId = 0;
+		uint8 RecordedStages = 0;
+	};
+
+	FLatencyHistogram Histograms[NumStages];
+	TMap<TObjectKey<AActor>, FPendingShot> PendingShots;
+	uint32 NextShotId = 0;
+
+	void SetTraceCounter( const EShotLatencyStage Stage, const double Ms ) {
+		switch ( Stage ) {
+			case EShotLatencyStage::Fire: TRACE_COUNTER_SET(ShotLatencyFire, Ms); break;
+			case EShotLatencyStage::Trace: TRACE_COUNTER_SET(ShotLatencyTrace, Ms); break;
+			case EShotLatencyStage::Damage: TRACE_COUNTER_SET(ShotLatencyDamage, Ms); break;
+			case EShotLatencyStage::Effects: TRACE_COUNTER_SET(ShotLatencyEffects, Ms); break;
+			default: break;
+		}
+	}
+}
+
+
+void FShotLatency::MarkInput( const AActor* Shooter ) {
+	if ( !Shooter ) { return; }
+
+	FPendingShot& Shot = PendingShots.FindOrAdd(Shooter);
+	Shot.InputCycles = FPlatformTime::Cycles64();
+	Shot.InputFrame = GFrameCounter;
+	Shot.ShotId = ++NextShotId;
+	Shot.RecordedStages = 0;
+	TRACE_BOOKMARK(TEXT("Shot %u Input"), Shot.ShotId);
+}
+
+
+void FShotLatency::MarkStage( const EShotLatencyStage Stage, const AActor* Shooter ) {
+	FPendingShot* Shot = Shooter ? PendingShots.Find(Shooter) : nullptr;
+	if ( !Shot ) { return; }
+
+	// A second shot means the measured one is over; it came from the fire rate, not the press
+	const uint8 StageBit = 1 << static_cast<uint8>(Stage);
+	if ( Shot->RecordedStages & StageBit ) {
+		if ( Stage == EShotLatencyStage::Fire ) { PendingShots.Remove(Shooter); }
+		return;
+	}
+	Shot->RecordedStages |= StageBit;
+
+	const double Ms = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Shot->InputCycles);
+	const uint64 Frames = GFrameCounter - Shot->InputFrame;
+	Histograms[static_cast<int32>(Stage)].Add(Ms, Frames);
+	SetTraceCounter(Stage, Ms);
+	TRACE_BOOKMARK(TEXT("Shot %u %s +%.2fms (%llu frames)"), Shot->ShotId, StageNames[static_cast<int32>(Stage)], Ms, Frames);
+}
+
+
+void FShotLatency::Reset() {
+	for ( FLatencyHistogram& Histogram : Histograms ) { Histogram = FLatencyHistogram(); }
+	PendingShots.Reset();
+}
+
+
+void FShotLatency::LogStats() {
+	for ( int32 Stage = 0; Stage < NumStages; ++Stage ) {
+		const FLatencyHistogram& Histogram = Histograms[Stage];
+		UE_LOG(LogRiotWave, Display, TEXT("ShotLatency %s: Count=%u P50=%.2fms P95=%.2fms P99=%.2fms Max=%.2fms MeanFrames=%.2f"),
+			StageNames[Stage], Histogram.Count, Histogram.GetPercentileMs(0.50), Histogram.GetPercentileMs(0.95), Histogram.GetPercentileMs(0.99), Histogram.MaxMs,
+			Histogram.Count > 0 ? static_cast<double>(Histogram.TotalFrames) / Histogram.Count : 0.0);
+	}
+}
@@ -0,0 +1,182 @@
+// TickAudit.cpp - Implements the tick audit capture and report
+
+#include "Profiling/TickAudit.h"
+
+#include "Components/ActorComponent.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "RiotWave.h"
+#include "Subsystems/WorldSubsystem.h"
+
+static FAutoConsoleCommandWithWorldAndArgs GTickAuditCommand(
+	TEXT("RiotWave.TickAudit"),
+	TEXT("Lists every registered tick function grouped by RiotWave class and, after capturing, the measured cost per frame. Optional argument: frames to capture (default 120, 0 = listing only)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([]( const TArray<FString>& Args, UWorld* World ) {
+		if ( World ) { FTickAudit::StartCapture(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 120); }
+	})
+);
+
+namespace {
+	struct FTickEntry {
+		int32 Registered = 0;
+		int32 Enabled = 0;
+		uint64 Cycles = 0;
+		int32 Samples = 0;
+	};
+
+	/** Group and tick function name, e.g. ("Enemy", "CharacterMovementComponent") or ("Enemy", "Actor") */
+	using FTickEntryKey = TPair<FName, FName>;
+
+	const FName ActorEntryName(TEXT("Actor"));
+	const FName OtherGroupName(TEXT("Other"));
+	const FName SubsystemGroupName(TEXT("WorldSubsystem"));
+
+	bool bCapturing = false;
+	int32 FramesLeft = 0;
+	int32 FramesCaptured = 0;
+	double ActorTickStartSeconds = 0.0;
+	double ActorTickSeconds = 0.0;
+	TWeakObjectPtr<UWorld> CaptureWorld;
+	FDelegateHandle PreActorTickHandle;
+	FDelegateHandle PostActorTickHandle;
+	FCriticalSection SamplesLock;
+	TMap<FTickEntryKey, FTickEntry> CapturedSamples;
+
+	/** Nearest native class of Class declared in this module, null for engine and plugin classes */
+	const UClass* FindRiotWaveClass( const UClass* Class ) {
+		static const FName ModulePackageName(TEXT("/Script/RiotWave"));
+		for ( ; Class; Class = Class->GetSuperClass() ) {
+			if ( Class->HasAnyClassFlags(CLASS_Native) && Class->GetOutermost()->GetFName() == ModulePackageName ) { return Class; }
+		}
+		return nullptr;
+	}
+
+	/** Group of an actor: its RiotWave class, or Other */
+	FName GetGroupName( const AActor* Actor ) {
+		const UClass* RiotWaveClass = Actor ? FindRiotWaveClass(Actor->GetClass()) : nullptr;
+		return RiotWaveClass ? RiotWaveClass->GetFName() : OtherGroupName;
+	}
+
+	FTickEntryKey GetEntryKey( const UObject* Object ) {
+		if ( Object->IsA<UWorldSubsystem>() ) {
+			return FTickEntryKey(FindRiotWaveClass(Object->GetClass()) ? SubsystemGroupName : OtherGroupName, Object->GetClass()->GetFName());
+		}
+		if ( const UActorComponent* Component = Cast<UActorComponent>(Object) ) {
+			return FTickEntryKey(GetGroupName(Component->GetOwner()), Component->GetClass()->GetFName());
+		}
+		return FTickEntryKey(GetGroupName(Cast<AActor>(Object)), ActorEntryName);
+	}
+
+	void StopCapture() {
+		FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+		FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+		bCapturing = false;
+	}
+}
+
+
+bool FTickAudit::IsCapturing() {
+	return bCapturing;
+}
+
+
+void FTickAudit::StartCapture( UWorld* World, const int32 Frames ) {
+	if ( bCapturing ) { StopCapture(); }
+
+	CapturedSamples.Reset();
+	FramesCaptured = 0;
+	ActorTickSeconds = 0.0;
+	if ( Frames <= 0 ) {
+		LogReport(World);
+		return;
+	}
+
+	CaptureWorld = World;
+	FramesLeft = Frames;
+	bCapturing = true;
+	UE_LOG(LogRiotWave, Display, TEXT("TickAudit: capturing %d frames"), Frames);
+
+	PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddLambda([]( UWorld* TickedWorld, ELevelTick, float ) {
+		if ( TickedWorld == CaptureWorld.Get() ) { ActorTickStartSeconds = FPlatformTime::Seconds(); }
+	});
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddLambda([]( UWorld* TickedWorld, ELevelTick, float ) {
+		if ( !CaptureWorld.IsValid() ) {
+			StopCapture();
+			return;
+		}
+		if ( TickedWorld != CaptureWorld.Get() ) { return; }
+
+		ActorTickSeconds += FPlatformTime::Seconds() - ActorTickStartSeconds;
+		++FramesCaptured;
+		if ( --FramesLeft <= 0 ) {
+			StopCapture();
+			LogReport(TickedWorld);
+		}
+	});
+}
+
+
+void FTickAudit::AddSample( const UObject* Object, const uint64 Cycles ) {
+	const FTickEntryKey Key = GetEntryKey(Object);
+
+	FScopeLock Lock(&SamplesLock);
+	FTickEntry& Entry = CapturedSamples.FindOrAdd(Key);
+	Entry.Cycles += Cycles;
+	++Entry.Samples;
+}
+
+
+void FTickAudit::LogReport( UWorld* World ) {
+	TMap<FTickEntryKey, FTickEntry> Entries = CapturedSamples;
+	const auto AddTickFunction = [&Entries]( const FTickEntryKey& Key, const FTickFunction& TickFunction ) {
+		if ( !TickFunction.IsTickFunctionRegistered() ) { return; }
+		FTickEntry& Entry = Entries.FindOrAdd(Key);
+		++Entry.Registered;
+		Entry.Enabled += TickFunction.IsTickFunctionEnabled() ? 1 : 0;
+	};
+
+	for ( TActorIterator<AActor> It(World); It; ++It ) {
+		const AActor* Actor = *It;
+		const FName GroupName = GetGroupName(Actor);
+		AddTickFunction(FTickEntryKey(GroupName, ActorEntryName), Actor->PrimaryActorTick);
+		Actor->ForEachComponent(false, [&]( const UActorComponent* Component ) {
+			AddTickFunction(FTickEntryKey(GroupName, Component->GetClass()->GetFName()), Component->PrimaryComponentTick);
+		});
+	}
+
+	// Tickable subsystems are FTickableGameObjects, not tick functions; one row per subsystem class
+	for ( const UTickableWorldSubsystem* Subsystem : World->GetSubsystemArray<UTickableWorldSubsystem>() ) {
+		FTickEntry& Entry = Entries.FindOrAdd(GetEntryKey(Subsystem));
+		++Entry.Registered;
+		Entry.Enabled += Subsystem->IsTickable() ? 1 : 0;
+	}
+
+	// Most enabled tick functions first, which is where a regression shows up
+	Entries.ValueSort([]( const FTickEntry& A, const FTickEntry& B ) { return A.Enabled > B.Enabled; });
+
+	const int32 Frames = FMath::Max(FramesCaptured, 1);
+	int32 RiotWaveEnabled = 0;
+	int32 OtherEnabled = 0;
+	double MeasuredMs = 0.0;
+	for ( const TPair<FTickEntryKey, FTickEntry>& Pair : Entries ) {
+		const FTickEntry& Entry = Pair.Value;
+		const double EntryMs = FPlatformTime::ToMilliseconds64(Entry.Cycles) / Frames;
+		MeasuredMs += EntryMs;
+
+		if ( Pair.Key.Key == OtherGroupName ) {
+			OtherEnabled += Entry.Enabled;
+			continue;
+		}
+		RiotWaveEnabled += Entry.Enabled;
+
+		UE_LOG(LogRiotWave, Display, TEXT("TickAudit: %s / %s Registered=%d Enabled=%d MsPerFrame=%s TicksPerFrame=%.1f"),
+			*Pair.Key.Key.ToString(), *Pair.Key.Value.ToString(), Entry.Registered, Entry.Enabled,
+			Entry.Samples > 0 ? *FString::Printf(TEXT("%.3f"), EntryMs) : TEXT("-"), static_cast<double>(Entry.Samples) / Frames);
+	}
+
+	UE_LOG(LogRiotWave, Display, TEXT("TickAudit: Frames=%d EnabledRiotWave=%d EnabledOther=%d MeasuredRiotWaveMs=%.3f ActorTickMs=%.3f"),
+		FramesCaptured, RiotWaveEnabled, OtherEnabled, MeasuredMs, FramesCaptured > 0 ? ActorTickSeconds * 1000.0 / FramesCaptured : 0.0);
+}
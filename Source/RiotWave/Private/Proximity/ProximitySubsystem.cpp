@@ -0,0 +1,322 @@
+// ProximitySubsystem.cpp - Implements the batched proximity pass and its benchmark
+//
+// The per-tick cost is O(agents * targets in neighbouring cells). With a handful of players
+// that is effectively linear in the number of agents, compared to overlap spheres where
+// every moving pawn is tested against every sphere around it.
+
+#include "Proximity/ProximitySubsystem.h"
+
+#include "CollisionQueryParams.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+DECLARE_CYCLE_STAT(TEXT("Proximity Update"), STAT_ProximityUpdate, STATGROUP_Game);
+
+static int32 GProximityUseGrid = 1;
+static FAutoConsoleVariableRef CVarProximityUseGrid(
+	TEXT("RiotWave.Proximity.UseGrid"),
+	GProximityUseGrid,
+	TEXT("1 = enemies, weapons and items use the shared proximity grid instead of overlap spheres. Read when actors begin play."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorldAndArgs GProximityBenchmarkCommand(
+	TEXT("RiotWave.Proximity.Benchmark"),
+	TEXT("Compares overlap-query cost with grid cost for synthetic agents. Optional args: agent counts (default 50 200 1000)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([]( const TArray<FString>& Args, UWorld* World ) {
+		const UProximitySubsystem* Proximity = World ? World->GetSubsystem<UProximitySubsystem>() : nullptr;
+		if ( !Proximity ) { return; }
+
+		TArray<int32> AgentCounts;
+		for ( const FString& Arg : Args ) { AgentCounts.Add(FCString::Atoi(*Arg)); }
+		if ( AgentCounts.Num() == 0 ) { AgentCounts = { 50, 200, 1000 }; }
+
+		Proximity->RunBenchmark(AgentCounts);
+	})
+);
+
+
+void FProximityGrid::Reset() {
+	// Keep the cell arrays so rebuilding every tick does not reallocate
+	for ( TPair<FIntPoint, TArray<int32>>& Pair : Cells ) { Pair.Value.Reset(); }
+}
+
+
+void FProximityGrid::Add( const int32 Id, const FVector& Location ) {
+	Cells.FindOrAdd(ToCell(Location)).Add(Id);
+}
+
+
+bool UProximitySubsystem::IsGridEnabled() {
+	return GProximityUseGrid != 0;
+}
+
+
+bool UProximitySubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UProximitySubsystem::Initialize( FSubsystemCollectionBase& Collection ) {
+	Super::Initialize(Collection);
+	TargetGrid.CellSize = FMath::Max(CellSize, 1.0f);
+}
+
+
+TStatId UProximitySubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProximitySubsystem, STATGROUP_Tickables);
+}
+
+
+void UProximitySubsystem::RegisterAgent( AActor* Agent, const EProximityChannel Channel, const float Radius, USceneComponent* LocationSource ) {
+	if ( !Agent || Channel == EProximityChannel::Count ) { return; }
+
+	int32& AgentIndex = AgentIndexByActor.FindOrAdd(Agent, INDEX_NONE);
+	if ( AgentIndex == INDEX_NONE ) {
+		AgentIndex = Agents.AddDefaulted();
+		Agents[AgentIndex].Key = Agent;
+		Agents[AgentIndex].Actor = Agent;
+	}
+
+	FAgent& AgentData = Agents[AgentIndex];
+	AgentData.Radius[static_cast<int32>(Channel)] = Radius;
+	AgentData.LocationSource = LocationSource ? LocationSource : Agent->GetRootComponent();
+}
+
+
+void UProximitySubsystem::UnregisterAgent( AActor* Agent ) {
+	if ( const int32* AgentIndex = AgentIndexByActor.Find(Agent) ) {
+		RemoveAgentAt(*AgentIndex);
+	}
+}
+
+
+void UProximitySubsystem::RemoveAgentAt( const int32 AgentIndex ) {
+	AgentIndexByActor.Remove(Agents[AgentIndex].Key);
+
+	// Swap-remove and patch the index of the agent that moved into the hole
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	if ( Agents.IsValidIndex(AgentIndex) ) {
+		AgentIndexByActor.Add(Agents[AgentIndex].Key, AgentIndex);
+	}
+}
+
+
+void UProximitySubsystem::SetAgentEnabled( AActor* Agent, const bool bEnabled ) {
+	const int32* AgentIndex = AgentIndexByActor.Find(Agent);
+	if ( !AgentIndex ) { return; }
+
+	FAgent& AgentData = Agents[*AgentIndex];
+	if ( AgentData.bEnabled == bEnabled ) { return; }
+	AgentData.bEnabled = bEnabled;
+
+	if ( !bEnabled ) {
+		for ( int32 Channel = 0; Channel < NumChannels; ++Channel ) {
+			QueueTransitions(AgentData, static_cast<EProximityChannel>(Channel), AgentData.InsideMask[Channel], false);
+			AgentData.InsideMask[Channel] = 0;
+		}
+		DispatchTransitions();
+	}
+}
+
+
+void UProximitySubsystem::RegisterTarget( AActor* Target, const float Radius ) {
+	if ( !Target ) { return; }
+
+	int32 FreeSlot = INDEX_NONE;
+	for ( int32 Slot = 0; Slot < Targets.Num(); ++Slot ) {
+		if ( Targets[Slot].Actor == Target ) { Targets[Slot].Radius = Radius; return; }
+		if ( FreeSlot == INDEX_NONE && !Targets[Slot].Actor.IsValid() ) { FreeSlot = Slot; }
+	}
+
+	if ( FreeSlot == INDEX_NONE ) {
+		if ( !ensureMsgf(Targets.Num() < MaxTargets, TEXT("Proximity target limit (%d) reached"), MaxTargets) ) { return; }
+		FreeSlot = Targets.AddDefaulted();
+	}
+
+	Targets[FreeSlot].Actor = Target;
+	Targets[FreeSlot].Radius = Radius;
+	MaxTargetRadius = FMath::Max(MaxTargetRadius, Radius);
+}
+
+
+void UProximitySubsystem::UnregisterTarget( AActor* Target ) {
+	const int32 Slot = Targets.IndexOfByPredicate([Target]( const FTarget& TargetData ) { return TargetData.Actor == Target; });
+	if ( !Target || Slot == INDEX_NONE ) { return; }
+
+	// Ended and cleared right away, while the target is still valid, so a target registered into this slot starts clean
+	const uint64 SlotBit = 1ull << Slot;
+	for ( FAgent& Agent : Agents ) {
+		for ( int32 Channel = 0; Channel < NumChannels; ++Channel ) {
+			if ( Agent.InsideMask[Channel] & SlotBit ) {
+				QueueTransitions(Agent, static_cast<EProximityChannel>(Channel), SlotBit, false);
+				Agent.InsideMask[Channel] &= ~SlotBit;
+			}
+		}
+	}
+
+	// Slot stays reserved but empty until the next RegisterTarget reuses it
+	Targets[Slot].Actor.Reset();
+	DispatchTransitions();
+}
+
+
+/**
+* The whole pass: rebuild the target grid, compute new inside-masks for every
+* agent and channel, then dispatch the differences.
+*/
+void UProximitySubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_ProximityUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UProximitySubsystem::Tick);
+
+	TargetGrid.Reset();
+	for ( int32 Slot = 0; Slot < Targets.Num(); ++Slot ) {
+		if ( const AActor* Target = Targets[Slot].Actor.Get() ) {
+			TargetGrid.Add(Slot, Target->GetActorLocation());
+		}
+	}
+
+	for ( int32 AgentIndex = Agents.Num() - 1; AgentIndex >= 0; --AgentIndex ) {
+		FAgent& Agent = Agents[AgentIndex];
+
+		const USceneComponent* LocationSource = Agent.LocationSource.Get();
+		if ( !Agent.Actor.IsValid() || !LocationSource ) {
+			RemoveAgentAt(AgentIndex);
+			continue;
+		}
+		if ( !Agent.bEnabled ) { continue; }
+
+		const FVector Location = LocationSource->GetComponentLocation();
+
+		for ( int32 Channel = 0; Channel < NumChannels; ++Channel ) {
+			const float Radius = Agent.Radius[Channel];
+			if ( Radius <= 0.0f ) { continue; }
+
+			uint64 NewMask = 0;
+			TargetGrid.ForEachInRadius(Location, Radius + MaxTargetRadius, [&]( const int32 Slot ) {
+				const FTarget& Target = Targets[Slot];
+				const float Reach = Radius + Target.Radius;
+				if ( FVector::DistSquared(Location, Target.Actor->GetActorLocation()) <= Reach * Reach ) {
+					NewMask |= 1ull << Slot;
+				}
+			});
+
+			const uint64 OldMask = Agent.InsideMask[Channel];
+			if ( NewMask != OldMask ) {
+				QueueTransitions(Agent, static_cast<EProximityChannel>(Channel), NewMask & ~OldMask, true);
+				QueueTransitions(Agent, static_cast<EProximityChannel>(Channel), OldMask & ~NewMask, false);
+				Agent.InsideMask[Channel] = NewMask;
+			}
+		}
+	}
+
+	DispatchTransitions();
+}
+
+
+void UProximitySubsystem::QueueTransitions( const FAgent& Agent, const EProximityChannel Channel, uint64 Mask, const bool bBegin ) {
+	while ( Mask != 0 ) {
+		const int32 Slot = static_cast<int32>(FMath::CountTrailingZeros64(Mask));
+		Mask &= Mask - 1;
+		PendingTransitions.Add({ Agent.Actor, Targets[Slot].Actor, Channel, bBegin });
+	}
+}
+
+
+void UProximitySubsystem::DispatchTransitions() {
+	// Listeners may pick up, destroy or pool themselves, which can re-enter this subsystem
+	TArray<FTransition> Transitions = MoveTemp(PendingTransitions);
+	PendingTransitions.Reset();
+
+	for ( const FTransition& Transition : Transitions ) {
+		AActor* Agent = Transition.Agent.Get();
+		AActor* Target = Transition.Target.Get();
+		IProximityListenerInterface* Listener = Cast<IProximityListenerInterface>(Agent);
+		if ( !Listener || !Target ) { continue; }
+
+		if ( Transition.bBegin ) {
+			Listener->OnProximityBegin(Transition.Channel, Target);
+		} else {
+			Listener->OnProximityEnd(Transition.Channel, Target);
+		}
+	}
+}
+
+
+/**
+* Synthetic comparison between the two approaches.
+*
+* Overlap cost is approximated by one sphere overlap query per agent range against pawns,
+* which is what UpdateOverlaps does for each moving sphere component. It does not include
+* the extra events enemies' spheres raise against each other, so it understates the real
+* component cost in a dense horde.
+*/
+void UProximitySubsystem::RunBenchmark( const TArray<int32>& AgentCounts ) const {
+	constexpr int32 Iterations = 20;
+	constexpr float AreaHalfSize = 10000.0f;
+	const float Radii[] = { 300.0f, 250.0f };
+
+	UWorld* World = GetWorld();
+	FVector Center = FVector::ZeroVector;
+	if ( Targets.Num() > 0 && Targets[0].Actor.IsValid() ) { Center = Targets[0].Actor->GetActorLocation(); }
+
+	FRandomStream Random(1337);
+
+	for ( const int32 AgentCount : AgentCounts ) {
+		TArray<FVector> AgentLocations;
+		AgentLocations.Reserve(AgentCount);
+		for ( int32 Index = 0; Index < AgentCount; ++Index ) {
+			AgentLocations.Add(Center + FVector(Random.FRandRange(-AreaHalfSize, AreaHalfSize), Random.FRandRange(-AreaHalfSize, AreaHalfSize), 0.0f));
+		}
+
+		// Overlap queries against the live physics scene
+		TArray<FOverlapResult> Overlaps;
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProximityBenchmark), false);
+		const double OverlapStart = FPlatformTime::Seconds();
+		for ( int32 Iteration = 0; Iteration < Iterations; ++Iteration ) {
+			for ( const FVector& Location : AgentLocations ) {
+				for ( const float Radius : Radii ) {
+					Overlaps.Reset();
+					World->OverlapMultiByObjectType(Overlaps, Location, FQuat::Identity, FCollisionObjectQueryParams(ECC_Pawn), FCollisionShape::MakeSphere(Radius), QueryParams);
+				}
+			}
+		}
+		const double OverlapMs = ( FPlatformTime::Seconds() - OverlapStart ) * 1000.0 / Iterations;
+
+		// Grid pass with the same agents against the registered targets
+		TArray<FVector> TargetLocations;
+		TArray<float> TargetRadii;
+		for ( const FTarget& Target : Targets ) {
+			TargetLocations.Add(Target.Actor.IsValid() ? Target.Actor->GetActorLocation() : Center);
+			TargetRadii.Add(Target.Radius);
+		}
+		if ( TargetLocations.Num() == 0 ) { TargetLocations.Add(Center); TargetRadii.Add(42.0f); }
+
+		FProximityGrid Grid(TargetGrid.CellSize);
+		uint64 Checksum = 0;
+		const double GridStart = FPlatformTime::Seconds();
+		for ( int32 Iteration = 0; Iteration < Iterations; ++Iteration ) {
+			Grid.Reset();
+			for ( int32 Slot = 0; Slot < TargetLocations.Num(); ++Slot ) { Grid.Add(Slot, TargetLocations[Slot]); }
+
+			for ( const FVector& Location : AgentLocations ) {
+				for ( const float Radius : Radii ) {
+					Grid.ForEachInRadius(Location, Radius + MaxTargetRadius, [&]( const int32 Slot ) {
+						const float Reach = Radius + TargetRadii[Slot];
+						Checksum += FVector::DistSquared(Location, TargetLocations[Slot]) <= Reach * Reach;
+					});
+				}
+			}
+		}
+		const double GridMs = ( FPlatformTime::Seconds() - GridStart ) * 1000.0 / Iterations;
+
+		UE_LOG(LogRiotWave, Display, TEXT("Proximity benchmark %4d agents: overlap queries %.3f ms/frame, grid %.3f ms/frame (%.1fx), %llu hits"),
+			AgentCount, OverlapMs, GridMs, GridMs > 0.0 ? OverlapMs / GridMs : 0.0, Checksum / Iterations);
+	}
+}
@@ -0,0 +1,108 @@
+// FireSchedulerTest.cpp - Automation tests for frame rate independent shot timing
+//
+// Drives FFireScheduler with synthetic frame times, the way the weapon component's tick
+// does, and checks that the rate of fire and each shot's age do not depend on frame rate.
+
+#include "Misc/AutomationTest.h"
+#include "Weapon/FireScheduler.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+	constexpr float TestRoundsPerMinute = 600.0f;
+	constexpr double TestShotInterval = 0.1;
+	constexpr float TestFrameRates[] = { 30.0f, 60.0f, 144.0f, 240.0f };
+
+	/** Seconds of float drift allowed in a shot age after about a second of accumulated frames */
+	constexpr float AgeTolerance = 1.0e-4f;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerHoldTest, "RiotWave.Weapon.FireScheduler.Hold",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+* Holds an automatic trigger for whole frames adding up to about 1.05 seconds at each frame rate.
+* The press fires at once and one shot is due every interval after it, so 11 shots are expected
+* whatever the frame rate, each aged by how long before the end of its frame it was due.
+*/
+bool FFireSchedulerHoldTest::RunTest( const FString& Parameters ) {
+	constexpr double HoldSeconds = 1.05;
+	constexpr int32 ExpectedShots = 11;
+
+	for ( const float FrameRate : TestFrameRates ) {
+		FFireScheduler Scheduler;
+		Scheduler.Configure(TestRoundsPerMinute, true);
+
+		int32 Shots = 0;
+		TestTrue(FString::Printf(TEXT("%.0f Hz: press fires at once"), FrameRate), Scheduler.Press());
+		++Shots;
+
+		const float FrameTime = 1.0f / FrameRate;
+		const int32 NumFrames = FMath::RoundToInt32(HoldSeconds * FrameRate);
+		TArray<float, TInlineAllocator<8>> ShotAges;
+		for ( int32 Frame = 0; Frame < NumFrames; ++Frame ) {
+			ShotAges.Reset();
+			Scheduler.Advance(FrameTime, ShotAges);
+
+			const double FrameEnd = ( Frame + 1 ) * static_cast<double>(FrameTime);
+			for ( const float ShotAge : ShotAges ) {
+				const double DueTime = Shots * TestShotInterval;
+				TestEqual(FString::Printf(TEXT("%.0f Hz: age of shot %d"), FrameRate, Shots), ShotAge, static_cast<float>(FrameEnd - DueTime), AgeTolerance);
+				TestTrue(FString::Printf(TEXT("%.0f Hz: shot %d is due within its frame"), FrameRate, Shots), ShotAge >= 0.0f && ShotAge < FrameTime + AgeTolerance);
+				++Shots;
+			}
+		}
+		TestEqual(FString::Printf(TEXT("%.0f Hz: shots while held"), FrameRate), Shots, ExpectedShots);
+
+		// Released: no more shots, and the weapon is ready again within one interval
+		Scheduler.Release();
+		int32 ShotsAfterRelease = 0;
+		for ( int32 Frame = 0; Frame < FMath::CeilToInt32(FrameRate); ++Frame ) {
+			ShotAges.Reset();
+			Scheduler.Advance(FrameTime, ShotAges);
+			ShotsAfterRelease += ShotAges.Num();
+		}
+		TestEqual(FString::Printf(TEXT("%.0f Hz: shots after release"), FrameRate), ShotsAfterRelease, 0);
+		TestTrue(FString::Printf(TEXT("%.0f Hz: ready after release"), FrameRate), Scheduler.IsReady());
+	}
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerTapTest, "RiotWave.Weapon.FireScheduler.Tap",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+/**
+* Taps a semi-automatic trigger every frame for about 1.05 seconds. Each tap fires only once
+* the interval has run out, on the first frame after, so every shot may slip by up to a frame
+* but the count can never exceed the held rate.
+*/
+bool FFireSchedulerTapTest::RunTest( const FString& Parameters ) {
+	constexpr double TapSeconds = 1.05;
+	constexpr int32 MaxShots = 11;
+
+	for ( const float FrameRate : TestFrameRates ) {
+		FFireScheduler Scheduler;
+		Scheduler.Configure(TestRoundsPerMinute, false);
+
+		const float FrameTime = 1.0f / FrameRate;
+		const int32 NumFrames = FMath::RoundToInt32(TapSeconds * FrameRate);
+		TArray<float, TInlineAllocator<8>> ShotAges;
+		int32 Shots = 0;
+		for ( int32 Frame = 0; Frame < NumFrames; ++Frame ) {
+			Shots += Scheduler.Press() ? 1 : 0;
+			Scheduler.Release();
+
+			ShotAges.Reset();
+			Scheduler.Advance(FrameTime, ShotAges);
+			TestEqual(FString::Printf(TEXT("%.0f Hz: semi-automatic fires only on press"), FrameRate), ShotAges.Num(), 0);
+		}
+
+		const int32 MinShots = FMath::FloorToInt32(TapSeconds / ( TestShotInterval + FrameTime )) + 1;
+		TestTrue(FString::Printf(TEXT("%.0f Hz: tapped shots (%d) within the rate of fire"), FrameRate, Shots), Shots <= MaxShots && Shots >= MinShots);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,62 @@
+// ProjectileHitTest.cpp - Automation test for projectile hits on enemy bones
+//
+// Spawns an enemy with the engine's tutorial mannequin in a throwaway game world and traces
+// through it on the Projectile channel, the way UProjectileSubsystem sweeps a bullet step.
+// The hit has to land on a mesh body with a bone name, not on the capsule, or the damage
+// queue cannot apply its head and limb multipliers.
+
+#include "Combat/ProjectileSubsystem.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "Enemy/Enemy.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileBoneHitTest, "RiotWave.Combat.Projectile.HitsEnemyBones",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FProjectileBoneHitTest::RunTest( const FString& Parameters ) {
+	// Ships with the engine and has a physics asset, so the test needs no project content
+	USkeletalMesh* SkeletalMesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/Tutorial/SubEditors/TutorialAssets/Character/TutorialTPP.TutorialTPP"));
+	if ( !TestNotNull(TEXT("Tutorial mannequin mesh"), SkeletalMesh) ) { return false; }
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("ProjectileHitTestWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	AEnemy* Enemy = World->SpawnActor<AEnemy>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if ( TestNotNull(TEXT("Enemy"), Enemy) ) {
+		UCapsuleComponent* Capsule = Enemy->GetCapsuleComponent();
+		USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+		TestEqual(TEXT("Capsule response to Projectile"), Capsule->GetCollisionResponseToChannel(ECC_Projectile), ECR_Ignore);
+		TestEqual(TEXT("Mesh response to Projectile"), Mesh->GetCollisionResponseToChannel(ECC_Projectile), ECR_Block);
+
+		// Feet at the bottom of the capsule, like the enemy Blueprints, so the capsule surrounds the mesh bodies
+		Mesh->SetSkeletalMesh(SkeletalMesh);
+		Mesh->SetRelativeLocation(FVector(0.0f, 0.0f, -Capsule->GetScaledCapsuleHalfHeight()));
+		Mesh->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+		const FVector Target = Mesh->Bounds.Origin;
+		const FVector Start = Target - FVector(300.0f, 0.0f, 0.0f);
+		const FVector End = Target + FVector(300.0f, 0.0f, 0.0f);
+
+		FHitResult Hit;
+		const bool bHit = World->LineTraceSingleByChannel(Hit, Start, End, ECC_Projectile, FCollisionQueryParams(SCENE_QUERY_STAT(ProjectileHitTest), false));
+		if ( TestTrue(TEXT("Projectile segment hits the enemy"), bHit) ) {
+			TestTrue(TEXT("Hit actor is the enemy"), Hit.GetActor() == Enemy);
+			TestTrue(TEXT("Hit component is the mesh, not the capsule"), Hit.GetComponent() == Mesh);
+			TestNotEqual(TEXT("Hit bone name"), Hit.BoneName, FName(NAME_None));
+		}
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
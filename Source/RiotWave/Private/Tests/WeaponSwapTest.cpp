@@ -0,0 +1,63 @@
+// WeaponSwapTest.cpp - Automation test for allocation-free weapon swaps
+//
+// Spawns a player character in a throwaway game world, gives it a weapon in every slot and
+// checks that cycling through them creates no UObjects, components or registrations.
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Player/PlayerCharacter.h"
+#include "Weapon/WeaponHandlingComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace {
+	int32 CountRegisteredComponents( const AActor* Actor ) {
+		int32 NumRegistered = 0;
+		Actor->ForEachComponent(false, [&NumRegistered]( const UActorComponent* Component ) { NumRegistered += Component->IsRegistered() ? 1 : 0; });
+		return NumRegistered;
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponSwapAllocationTest, "RiotWave.Weapon.Swap.NoAllocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FWeaponSwapAllocationTest::RunTest( const FString& Parameters ) {
+	constexpr int32 NumWeapons = 3;
+	constexpr int32 NumSwaps = 100;
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("WeaponSwapTestWorld"));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+	World->InitializeActorsForPlay(FURL());
+	World->BeginPlay();
+
+	// Slot meshes are created and registered when the player begins play
+	APlayerCharacter* PlayerCharacter = World->SpawnActor<APlayerCharacter>();
+	UWeaponHandlingComponent* WeaponHandling = PlayerCharacter ? PlayerCharacter->GetWeaponHandlingComponent() : nullptr;
+	if ( TestNotNull(TEXT("Player character with weapon handling"), WeaponHandling) ) {
+		for ( int32 Weapon = 0; Weapon < NumWeapons; ++Weapon ) { WeaponHandling->AttachComponentMeshToActor(nullptr); }
+		TestEqual(TEXT("Last picked up weapon is equipped"), WeaponHandling->GetActiveSlot(), NumWeapons - 1);
+
+		const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		const int32 ComponentsBefore = PlayerCharacter->GetComponents().Num();
+		const int32 RegisteredBefore = CountRegisteredComponents(PlayerCharacter);
+
+		for ( int32 Swap = 0; Swap < NumSwaps; ++Swap ) {
+			const int32 PreviousSlot = WeaponHandling->GetActiveSlot();
+			WeaponHandling->EquipNextSlot();
+			TestEqual(TEXT("Swap moves to the next occupied slot"), WeaponHandling->GetActiveSlot(), ( PreviousSlot + 1 ) % NumWeapons);
+		}
+
+		TestEqual(TEXT("UObjects created by swapping"), GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore, 0);
+		TestEqual(TEXT("Components added by swapping"), PlayerCharacter->GetComponents().Num() - ComponentsBefore, 0);
+		TestEqual(TEXT("Components registered by swapping"), CountRegisteredComponents(PlayerCharacter) - RegisteredBefore, 0);
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return true;
+}
+
+#endif
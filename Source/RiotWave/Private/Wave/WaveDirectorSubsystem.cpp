@@ -0,0 +1,316 @@
+// WaveDirectorSubsystem.cpp - Implements the wave loop and the budgeted spawn queue
+//
+// Each tick does at most SpawnBudgetMs of spawn work. Finishing already constructed enemies
+// runs first so an enemy never waits more than a frame or two between construction and BeginPlay.
+
+#include "Wave/WaveDirectorSubsystem.h"
+
+#include "Enemy/Enemy.h"
+#include "Enemy/EnemyPoolSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Horde/HordeSubsystem.h"
+#include "Kismet/GameplayStatics.h"
+#include "Profiling/TickAudit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "RiotWave.h"
+
+static float GWaveSpawnBudgetMs = 1.5f;
+static FAutoConsoleVariableRef CVarWaveSpawnBudgetMs(
+	TEXT("RiotWave.Waves.SpawnBudgetMs"),
+	GWaveSpawnBudgetMs,
+	TEXT("Game-thread milliseconds the wave director may spend spawning enemies per frame. At least one spawn step always runs."),
+	ECVF_Default
+);
+
+static FAutoConsoleCommandWithWorld GWaveTimingsCommand(
+	TEXT("RiotWave.Waves.Timings"),
+	TEXT("Prints spawn timings (total, worst frame, frames used, pool hits) for every wave run so far."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+		if ( const UWaveDirectorSubsystem* Director = World ? World->GetSubsystem<UWaveDirectorSubsystem>() : nullptr ) { Director->LogWaveTimings(); }
+	})
+);
+
+
+bool UWaveDirectorSubsystem::DoesSupportWorldType( const EWorldType::Type WorldType ) const {
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+TStatId UWaveDirectorSubsystem::GetStatId() const {
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UWaveDirectorSubsystem, STATGROUP_Tickables);
+}
+
+
+void UWaveDirectorSubsystem::Initialize( FSubsystemCollectionBase& Collection ) {
+	Super::Initialize(Collection);
+
+	if ( UHordeSubsystem* Horde = Collection.InitializeDependency<UHordeSubsystem>() ) {
+		Horde->OnEnemyPromoted.AddUObject(this, &UWaveDirectorSubsystem::HandleEnemyPromoted);
+		Horde->OnEnemyDemoted.AddUObject(this, &UWaveDirectorSubsystem::HandleEnemyDemoted);
+	}
+}
+
+
+int32 UWaveDirectorSubsystem::GetAliveEnemyCount() const {
+	const UHordeSubsystem* Horde = GetWorld()->GetSubsystem<UHordeSubsystem>();
+	return TrackedEnemies.Num() + ( Horde ? Horde->GetProxyCount() : 0 );
+}
+
+
+void UWaveDirectorSubsystem::StartWaves( const TArray<FWaveDefinition>& InWaves ) {
+	StopWaves();
+
+	Waves = InWaves;
+	if ( Waves.Num() == 0 ) { return; }
+
+	CurrentWaveIndex = 0;
+	Phase = EWavePhase::WaitingForWave;
+	NextWaveTime = GetWorld()->GetTimeSeconds() + Waves[0].DelayBeforeWave;
+}
+
+
+void UWaveDirectorSubsystem::StopWaves() {
+	Phase = EWavePhase::Idle;
+	PendingSpawns.Reset();
+	PendingSpawnCursor = 0;
+
+	// Constructed but unfinished actors would otherwise stay half-initialized forever
+	for ( const FDeferredSpawn& Deferred : DeferredSpawns ) {
+		if ( AEnemy* Enemy = Deferred.Enemy.Get() ) { Enemy->Destroy(); }
+	}
+	DeferredSpawns.Reset();
+
+	// Enemies left alive must not count towards, or report deaths into, the next StartWaves
+	for ( const TWeakObjectPtr<AEnemy>& Tracked : TrackedEnemies ) {
+		if ( AEnemy* Enemy = Tracked.Get() ) {
+			Enemy->OnEnemyDied.RemoveAll(this);
+			Enemy->OnDestroyed.RemoveDynamic(this, &UWaveDirectorSubsystem::HandleEnemyDestroyed);
+		}
+	}
+	TrackedEnemies.Reset();
+
+	// Proxies would otherwise count as alive in the next run and hold its first wave open
+	if ( UHordeSubsystem* Horde = GetWorld()->GetSubsystem<UHordeSubsystem>() ) { Horde->ClearProxies(); }
+}
+
+
+void UWaveDirectorSubsystem::Tick( const float DeltaTime ) {
+	const FTickAuditScope TickAudit(this);
+	Super::Tick(DeltaTime);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UWaveDirectorSubsystem::Tick);
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	switch ( Phase ) {
+		case EWavePhase::WaitingForWave:
+			if ( WorldTime >= NextWaveTime ) { BeginWave(); }
+			break;
+
+		case EWavePhase::Spawning:
+			ProcessSpawnQueue(WorldTime);
+			if ( PendingSpawnCursor >= PendingSpawns.Num() && DeferredSpawns.Num() == 0 ) {
+				WaveTimings.Last().SpawnCompleteTime = WorldTime;
+				Phase = EWavePhase::InProgress;
+			}
+			break;
+
+		case EWavePhase::InProgress:
+			// Enemies streamed out with their level are collected without OnDestroyed
+			TrackedEnemies.RemoveAllSwap([]( const TWeakObjectPtr<AEnemy>& Tracked ) { return !Tracked.IsValid(); }, EAllowShrinking::No);
+			if ( GetAliveEnemyCount() <= 0 ) {
+				WaveTimings.Last().ClearedTime = WorldTime;
+
+				if ( Waves.IsValidIndex(CurrentWaveIndex + 1) ) {
+					++CurrentWaveIndex;
+					NextWaveTime = WorldTime + Waves[CurrentWaveIndex].DelayBeforeWave;
+					Phase = EWavePhase::WaitingForWave;
+				} else {
+					Phase = EWavePhase::Idle;
+				}
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/**
+* Resolves spawn areas and spawn transforms once per wave so the
+* per-frame work is only the spawning itself.
+*/
+void UWaveDirectorSubsystem::BeginWave() {
+	const FWaveDefinition& Wave = Waves[CurrentWaveIndex];
+	const double WaveStartTime = GetWorld()->GetTimeSeconds();
+
+	FWaveTimings& Timings = WaveTimings.AddDefaulted_GetRef();
+	Timings.WaveIndex = CurrentWaveIndex;
+	Timings.StartTime = WaveStartTime;
+
+	PendingSpawns.Reset();
+	PendingSpawnCursor = 0;
+
+	for ( const FWaveSpawnGroup& Group : Wave.SpawnGroups ) {
+		if ( !Group.EnemyClass || Group.Count <= 0 ) { continue; }
+
+		TArray<AActor*> SpawnAreas;
+		UGameplayStatics::GetAllActorsWithTag(this, Group.SpawnAreaTag, SpawnAreas);
+		if ( SpawnAreas.Num() == 0 ) {
+			UE_LOG(LogRiotWave, Warning, TEXT("Wave %d: no spawn area tagged '%s' for %s, group skipped"),
+				CurrentWaveIndex, *Group.SpawnAreaTag.ToString(), *GetNameSafe(Group.EnemyClass));
+			continue;
+		}
+
+		int32 NumSkipped = 0;
+		for ( int32 Index = 0; Index < Group.Count; ++Index ) {
+			FTransform SpawnTransform;
+			if ( !PickSpawnTransform(SpawnAreas, SpawnTransform) ) {
+				++NumSkipped;
+				continue;
+			}
+
+			FPendingSpawn& Pending = PendingSpawns.AddDefaulted_GetRef();
+			Pending.EnemyClass = Group.EnemyClass;
+			Pending.SpawnTransform = SpawnTransform;
+			Pending.ReadyTime = WaveStartTime + Group.StartDelay + Index * Group.SpawnInterval;
+		}
+
+		if ( NumSkipped > 0 ) {
+			UE_LOG(LogRiotWave, Warning, TEXT("Wave %d: %d of %d %s skipped, their spawn area tagged '%s' is gone"),
+				CurrentWaveIndex, NumSkipped, Group.Count, *GetNameSafe(Group.EnemyClass), *Group.SpawnAreaTag.ToString());
+		}
+	}
+
+	// Groups interleave by their cadence, so drain strictly in time order
+	PendingSpawns.StableSort([]( const FPendingSpawn& A, const FPendingSpawn& B ) { return A.ReadyTime < B.ReadyTime; });
+
+	Phase = EWavePhase::Spawning;
+}
+
+
+void UWaveDirectorSubsystem::ProcessSpawnQueue( const double WorldTime ) {
+	TRACE_CPUPROFILER_EVENT_SCOPE(UWaveDirectorSubsystem::ProcessSpawnQueue);
+
+	const double FrameStart = FPlatformTime::Seconds();
+	const double BudgetSeconds = GWaveSpawnBudgetMs / 1000.0;
+	bool bDidWork = false;
+
+	// Always allow one step so a tiny budget can never stall the wave
+	auto HasBudget = [&]() { return !bDidWork || FPlatformTime::Seconds() - FrameStart < BudgetSeconds; };
+
+	FWaveTimings& Timings = WaveTimings.Last();
+
+	// Step 2: finish enemies constructed on an earlier frame. This is where BeginPlay runs
+	int32 NumFinished = 0;
+	while ( NumFinished < DeferredSpawns.Num() && HasBudget() ) {
+		const FDeferredSpawn& Deferred = DeferredSpawns[NumFinished++];
+		if ( AEnemy* Enemy = Deferred.Enemy.Get() ) {
+			Enemy->FinishSpawning(Deferred.SpawnTransform);
+			TrackEnemy(Enemy);
+			++Timings.EnemiesSpawned;
+		}
+		bDidWork = true;
+	}
+	DeferredSpawns.RemoveAt(0, NumFinished, EAllowShrinking::No);
+
+	// Step 1: start new enemies whose time has come, as proxies when far away, else preferring the pool
+	UEnemyPoolSubsystem* EnemyPool = GetWorld()->GetSubsystem<UEnemyPoolSubsystem>();
+	UHordeSubsystem* Horde = GetWorld()->GetSubsystem<UHordeSubsystem>();
+	while ( PendingSpawnCursor < PendingSpawns.Num() && PendingSpawns[PendingSpawnCursor].ReadyTime <= WorldTime && HasBudget() ) {
+		const FPendingSpawn& Pending = PendingSpawns[PendingSpawnCursor++];
+		bDidWork = true;
+
+		if ( Horde && Horde->ShouldSpawnAsProxy(Pending.EnemyClass, Pending.SpawnTransform.GetLocation()) ) {
+			Horde->AddProxy(Pending.EnemyClass, Pending.SpawnTransform);
+			++Timings.EnemiesSpawned;
+			++Timings.ProxiesSpawned;
+			continue;
+		}
+
+		if ( AEnemy* PooledEnemy = EnemyPool ? EnemyPool->TryAcquireEnemy(Pending.EnemyClass, Pending.SpawnTransform) : nullptr ) {
+			TrackEnemy(PooledEnemy);
+			++Timings.EnemiesSpawned;
+			++Timings.PoolHits;
+			continue;
+		}
+
+		AEnemy* Enemy = GetWorld()->SpawnActorDeferred<AEnemy>(Pending.EnemyClass, Pending.SpawnTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if ( Enemy ) {
+			DeferredSpawns.Add({ Enemy, Pending.SpawnTransform });
+		}
+	}
+
+	if ( bDidWork ) {
+		const double FrameMs = ( FPlatformTime::Seconds() - FrameStart ) * 1000.0;
+		Timings.TotalSpawnMs += FrameMs;
+		Timings.MaxFrameSpawnMs = FMath::Max(Timings.MaxFrameSpawnMs, FrameMs);
+		++Timings.FramesSpawning;
+	}
+}
+
+
+bool UWaveDirectorSubsystem::PickSpawnTransform( const TArray<AActor*>& SpawnAreas, FTransform& OutTransform ) const {
+	const AActor* SpawnArea = SpawnAreas[FMath::RandRange(0, SpawnAreas.Num() - 1)];
+	if ( !SpawnArea ) { return false; }
+
+	FVector Origin, Extent;
+	SpawnArea->GetActorBounds(true, Origin, Extent);
+
+	const FVector SpawnLocation(
+		Origin.X + FMath::FRandRange(-Extent.X, Extent.X),
+		Origin.Y + FMath::FRandRange(-Extent.Y, Extent.Y),
+		Origin.Z
+	);
+	OutTransform = FTransform(SpawnArea->GetActorRotation(), SpawnLocation);
+	return true;
+}
+
+
+void UWaveDirectorSubsystem::TrackEnemy( AEnemy* Enemy ) {
+	if ( !Enemy || TrackedEnemies.Contains(Enemy) ) { return; }
+
+	TrackedEnemies.Add(Enemy);
+	Enemy->OnEnemyDied.AddUObject(this, &UWaveDirectorSubsystem::HandleEnemyDied);
+	Enemy->OnDestroyed.AddUniqueDynamic(this, &UWaveDirectorSubsystem::HandleEnemyDestroyed);
+}
+
+
+void UWaveDirectorSubsystem::UntrackEnemy( AEnemy* Enemy ) {
+	if ( !Enemy || TrackedEnemies.RemoveSwap(Enemy, EAllowShrinking::No) == 0 ) { return; }
+
+	// Pooled enemies come back for later waves, so the bindings must not outlive this life
+	Enemy->OnEnemyDied.RemoveAll(this);
+	Enemy->OnDestroyed.RemoveDynamic(this, &UWaveDirectorSubsystem::HandleEnemyDestroyed);
+}
+
+
+void UWaveDirectorSubsystem::HandleEnemyPromoted( AEnemy* Enemy ) {
+	if ( Phase != EWavePhase::Idle ) { TrackEnemy(Enemy); }
+}
+
+
+void UWaveDirectorSubsystem::HandleEnemyDied( AEnemy* Enemy ) {
+	UntrackEnemy(Enemy);
+}
+
+
+void UWaveDirectorSubsystem::HandleEnemyDemoted( AEnemy* Enemy ) {
+	UntrackEnemy(Enemy);
+}
+
+
+void UWaveDirectorSubsystem::HandleEnemyDestroyed( AActor* DestroyedActor ) {
+	UntrackEnemy(Cast<AEnemy>(DestroyedActor));
+}
+
+
+void UWaveDirectorSubsystem::LogWaveTimings() const {
+	for ( const FWaveTimings& Timings : WaveTimings ) {
+		UE_LOG(LogRiotWave, Display, TEXT("Wave %d: Spawned=%d PoolHits=%d Proxies=%d Frames=%d TotalMs=%.2f WorstFrameMs=%.2f SpawnDuration=%.2fs Cleared=%s"),
+			Timings.WaveIndex, Timings.EnemiesSpawned, Timings.PoolHits, Timings.ProxiesSpawned, Timings.FramesSpawning, Timings.TotalSpawnMs, Timings.MaxFrameSpawnMs,
+			Timings.SpawnCompleteTime > 0.0 ? Timings.SpawnCompleteTime - Timings.StartTime : 0.0,
+			Timings.ClearedTime > 0.0 ? *FString::Printf(TEXT("%.2fs"), Timings.ClearedTime - Timings.StartTime) : TEXT("no"));
+	}
+}
@@ -0,0 +1,79 @@
+// FireScheduler.cpp - Implements the shot accumulator and the frame rate check command
+//
+// Tests/FireSchedulerTest.cpp asserts the same timing; the command is for eyeballing other rates of fire.
+
+#include "Weapon/FireScheduler.h"
+
+#include "HAL/IConsoleManager.h"
+#include "RiotWave.h"
+
+static FAutoConsoleCommand GFireRateCheckCommand(
+	TEXT("RiotWave.Weapon.FireRateCheck"),
+	TEXT("Holds a simulated trigger for about one second at several frame rates and prints the shots fired at each. Optional argument: rounds per minute (default 600)."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([]( const TArray<FString>& Args ) {
+		const float RoundsPerMinute = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 600.0f;
+		const float ShotInterval = 60.0f / FMath::Max(RoundsPerMinute, 1.0f);
+
+		// Half an interval past the second, so float rounding cannot move the last shot across the end
+		const float HoldSeconds = 1.0f + ShotInterval * 0.5f;
+		const int32 ExpectedShots = FMath::FloorToInt32(HoldSeconds / ShotInterval) + 1;
+		const float FrameRates[] = { 24.0f, 30.0f, 60.0f, 144.0f, 240.0f, 500.0f };
+
+		for ( const float FrameRate : FrameRates ) {
+			FFireScheduler Scheduler;
+			Scheduler.Configure(RoundsPerMinute, true);
+
+			TArray<float, TInlineAllocator<8>> ShotAges;
+			int32 Shots = Scheduler.Press() ? 1 : 0;
+
+			// Whole frames, then the remainder, so every rate covers exactly HoldSeconds
+			const float FrameTime = 1.0f / FrameRate;
+			float Elapsed = 0.0f;
+			while ( Elapsed < HoldSeconds ) {
+				const float Step = FMath::Min(FrameTime, HoldSeconds - Elapsed);
+				ShotAges.Reset();
+				Scheduler.Advance(Step, ShotAges);
+				Shots += ShotAges.Num();
+				Elapsed += Step;
+			}
+
+			UE_LOG(LogRiotWave, Display, TEXT("FireRateCheck: RPM=%.0f FrameRate=%.0f Shots=%d Expected=%d"),
+				RoundsPerMinute, FrameRate, Shots, ExpectedShots);
+		}
+	})
+);
+
+
+void FFireScheduler::Configure( const float RoundsPerMinute, const bool bInAutomatic ) {
+	ShotInterval = 60.0f / FMath::Max(RoundsPerMinute, 1.0f);
+	bAutomatic = bInAutomatic;
+}
+
+
+bool FFireScheduler::Press() {
+	bHeld = true;
+	if ( TimeUntilReady > 0.0f ) { return false; }
+
+	TimeUntilReady = ShotInterval;
+	return true;
+}
+
+
+void FFireScheduler::Release() {
+	bHeld = false;
+}
+
+
+void FFireScheduler::Advance( const float DeltaTime, TArray<float, TInlineAllocator<8>>& OutShotAges ) {
+	TimeUntilReady -= DeltaTime;
+
+	if ( !bHeld || !bAutomatic ) {
+		TimeUntilReady = FMath::Max(TimeUntilReady, 0.0f);
+		return;
+	}
+
+	while ( TimeUntilReady <= 0.0f ) {
+		OutShotAges.Add(-TimeUntilReady);
+		TimeUntilReady += ShotInterval;
+	}
+}
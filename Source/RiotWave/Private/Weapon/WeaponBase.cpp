@@ -6,19 +6,33 @@
 
 #include "Weapon/WeaponBase.h"
 
+#include "Audio/AudioEventSubsystem.h"
 #include "Components/SphereComponent.h"
+#include "Engine/AssetManager.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
 #include "Interface/Weapon/WeaponDetectionInterface.h"
-#include "Kismet/GameplayStatics.h"
+#include "Proximity/ProximitySubsystem.h"
+#include "RiotWave.h"
+#include "Weapon/WeaponDefinition.h"
 #include "Weapon/WeaponHandlingComponent.h"
 
+static FAutoConsoleCommandWithWorld GWeaponAssetStatsCommand(
+   TEXT("RiotWave.Weapons.AssetStats"),
+   TEXT("Prints each weapon's definition, streaming state, async load time and resident asset memory, with inline and definition totals."),
+   FConsoleCommandWithWorldDelegate::CreateLambda([]( UWorld* World ) {
+      if ( World ) { AWeaponBase::LogAssetStats(World); }
+   })
+);
+
 /**
 * Sets up the base weapon structure and collision.
 * Components are created and configured here to ensure proper editor visualization
 * and consistent behavior across all weapon instances.
 */
 AWeaponBase::AWeaponBase() {
-   // Enable Tick() for potential continuous effects or behavior
-   PrimaryActorTick.bCanEverTick = true;
+   // Pickups are event-driven: overlap or proximity, never per frame
+   PrimaryActorTick.bCanEverTick = false;
 
    // Create component hierarchy
    // Scene root provides a clean transform hierarchy base
@@ -67,14 +81,25 @@ void AWeaponBase::OnWeaponCollisionBeginOverlap(
          // Allow BP customization of pickup behavior
          OnWeaponPicked(OtherActor);
 
-         // Initialize weapon effects in the handling component
-         // Bundled into a struct for cleaner parameter passing
-         const FInitWeaponProperties Effects( MuzzleFlash, ImpactParticle, BeamTraceParticle, FireSound, WeaponSocketName, BaseDamage, HeadshotMultiplier, WeaponFIreMontage );
-         WHComponent->InitializeWeaponProperties(Effects);
+         if ( WeaponDefinition ) {
+            // The handle moves to the component, so the assets stay resident after this actor is destroyed
+            WHComponent->InitializeWeaponDefinition(WeaponDefinition, DefinitionAssetHandle);
+            DefinitionAssetHandle.Reset();
+         } else {
+            // Initialize weapon effects in the handling component
+            // Bundled into a struct for cleaner parameter passing
+            FInitWeaponProperties Effects( MuzzleFlash, ImpactParticle, BeamTraceParticle, FireSound, WeaponSocketName, BaseDamage, HeadshotMultiplier, WeaponFIreMontage, PelletCount, PelletSpread );
+            Effects.ProjectileSpeed = ProjectileSpeed;
+            Effects.ProjectileGravityScale = ProjectileGravityScale;
+            Effects.ProjectileLifetime = ProjectileLifetime;
+            Effects.RoundsPerMinute = RoundsPerMinute;
+            Effects.bAutomatic = bAutomatic;
+            WHComponent->InitializeWeaponProperties(Effects);
+         }
 
          // Play pickup feedback if sound is set
          if ( PickupSound ) {
-            UGameplayStatics::PlaySoundAtLocation(this, PickupSound, GetActorLocation());
+            UAudioEventSubsystem::PostSound(this, PickupSound, GetActorLocation(), RiotWaveSoundTags::Weapon_Pickup);
          }
 
          // Remove pickup actor since weapon is now equipped
@@ -87,18 +112,153 @@ void AWeaponBase::OnWeaponCollisionBeginOverlap(
 * Runtime initialization that binds the overlap event.
 * Done in BeginPlay rather than constructor because delegate binding
 * requires the component to be fully initialized.
+* When the proximity grid is enabled the sphere only provides the pickup radius
+* and the grid reports the player instead of physics overlaps.
 */
 void AWeaponBase::BeginPlay() {
    Super::BeginPlay();
 
+   UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>();
+   if ( Proximity && UProximitySubsystem::IsGridEnabled() ) {
+      if ( WeaponDefinition ) {
+         Proximity->RegisterAgent(this, EProximityChannel::AssetStreaming, FMath::Max(AssetStreamingRadius, WeaponCollision->GetScaledSphereRadius()), WeaponCollision);
+      }
+      Proximity->RegisterAgent(this, EProximityChannel::Pickup, WeaponCollision->GetScaledSphereRadius(), WeaponCollision);
+      WeaponCollision->SetGenerateOverlapEvents(false);
+      WeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+      return;
+   }
+
+   // Without the grid nothing reports an approaching player, so the assets load up front
+   RequestDefinitionAssets();
+
    // Bind overlap detection to our pickup handler
    WeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AWeaponBase::OnWeaponCollisionBeginOverlap);
 }
 
+void AWeaponBase::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+   if ( UProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UProximitySubsystem>() ) {
+      Proximity->UnregisterAgent(this);
+   }
+   StreamingTargetsInRange = 0;
+   ReleaseDefinitionAssets();
+
+   Super::EndPlay(EndPlayReason);
+}
+
+void AWeaponBase::OnProximityBegin(EProximityChannel Channel, AActor* Target) {
+   if ( Channel == EProximityChannel::Pickup ) {
+      OnWeaponCollisionBeginOverlap(WeaponCollision, Target, nullptr, INDEX_NONE, false, FHitResult());
+   } else if ( Channel == EProximityChannel::AssetStreaming ) {
+      ++StreamingTargetsInRange;
+      RequestDefinitionAssets();
+   }
+}
+
+void AWeaponBase::OnProximityEnd(EProximityChannel Channel, AActor* Target) {
+   // Another player still inside the range keeps the assets resident
+   if ( Channel == EProximityChannel::AssetStreaming ) {
+      StreamingTargetsInRange = FMath::Max(StreamingTargetsInRange - 1, 0);
+      if ( StreamingTargetsInRange == 0 ) { ReleaseDefinitionAssets(); }
+   }
+}
+
 /**
-* Frame update handler. Currently minimal as weapon behavior
-* is primarily event-driven. Kept for potential future continuous effects.
+* Streams the definition's FX, sound and montage in through the Asset Manager.
+* Requests are idempotent, so a second player entering the range shares the load.
 */
-void AWeaponBase::Tick(float DeltaTime) {
-   Super::Tick(DeltaTime);
-}
\ No newline at end of file
+void AWeaponBase::RequestDefinitionAssets() {
+   if ( !WeaponDefinition || DefinitionAssetHandle.IsValid() ) { return; }
+
+   TArray<FSoftObjectPath> AssetPaths;
+   WeaponDefinition->GetStreamedAssets(AssetPaths);
+   if ( AssetPaths.IsEmpty() ) { return; }
+
+   AssetRequestSeconds = FPlatformTime::Seconds();
+   DefinitionAssetHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths,
+      FStreamableDelegate::CreateUObject(this, &AWeaponBase::OnDefinitionAssetsLoaded));
+}
+
+/**
+* Drops this weapon's hold on the streamed assets. They stay loaded while anything
+* else references them, e.g. an equipped weapon of the same definition.
+*/
+void AWeaponBase::ReleaseDefinitionAssets() {
+   if ( !DefinitionAssetHandle.IsValid() ) { return; }
+
+   if ( DefinitionAssetHandle->IsLoadingInProgress() ) {
+      DefinitionAssetHandle->CancelHandle();
+   } else {
+      DefinitionAssetHandle->ReleaseHandle();
+   }
+   DefinitionAssetHandle.Reset();
+}
+
+void AWeaponBase::OnDefinitionAssetsLoaded() {
+   AssetLoadMs = ( FPlatformTime::Seconds() - AssetRequestSeconds ) * 1000.0;
+}
+
+/**
+* Sums resident memory per unique asset, so weapons sharing an effect count it once.
+* Inline weapons hold their assets for the whole level; definition weapons only
+* while streamed in, which is the difference the totals show.
+*/
+void AWeaponBase::LogAssetStats(UWorld* World) {
+   TSet<const UObject*> InlineAssets;
+   TSet<const UObject*> StreamedAssets;
+   int32 NumInline = 0;
+   int32 NumDefinition = 0;
+   int32 NumLoaded = 0;
+   double TotalLoadMs = 0.0;
+
+   const auto GetResidentBytes = []( const TSet<const UObject*>& Assets ) {
+      int64 Bytes = 0;
+      for ( const UObject* Asset : Assets ) { Bytes += Asset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal); }
+      return Bytes;
+   };
+
+   for ( TActorIterator<AWeaponBase> It(World); It; ++It ) {
+      const AWeaponBase* Weapon = *It;
+      TSet<const UObject*> WeaponAssets;
+      const auto AddAsset = [&WeaponAssets]( const UObject* Asset ) { if ( Asset ) { WeaponAssets.Add(Asset); } };
+      const TCHAR* State = TEXT("Inline");
+
+      if ( const UWeaponDefinition* Definition = Weapon->WeaponDefinition ) {
+         ++NumDefinition;
+         AddAsset(Definition->MuzzleFlash.Get());
+         AddAsset(Definition->ImpactParticle.Get());
+         AddAsset(Definition->BeamTraceParticle.Get());
+         AddAsset(Definition->FireSound.Get());
+         AddAsset(Definition->FireMontage.Get());
+         StreamedAssets.Append(WeaponAssets);
+
+         if ( !Weapon->DefinitionAssetHandle.IsValid() ) {
+            State = TEXT("Unloaded");
+         } else if ( Weapon->DefinitionAssetHandle->IsLoadingInProgress() ) {
+            State = TEXT("Loading");
+         } else {
+            State = TEXT("Resident");
+         }
+         if ( Weapon->AssetLoadMs >= 0.0 ) {
+            ++NumLoaded;
+            TotalLoadMs += Weapon->AssetLoadMs;
+         }
+      } else {
+         ++NumInline;
+         AddAsset(Weapon->MuzzleFlash);
+         AddAsset(Weapon->ImpactParticle);
+         AddAsset(Weapon->BeamTraceParticle);
+         AddAsset(Weapon->FireSound);
+         AddAsset(Weapon->WeaponFIreMontage);
+         InlineAssets.Append(WeaponAssets);
+      }
+
+      UE_LOG(LogRiotWave, Display, TEXT("Weapon %s: Definition=%s State=%s LoadMs=%.2f ResidentKB=%.1f"),
+         *Weapon->GetName(), Weapon->WeaponDefinition ? *Weapon->WeaponDefinition->GetName() : TEXT("None"), State,
+         FMath::Max(Weapon->AssetLoadMs, 0.0), GetResidentBytes(WeaponAssets) / 1024.0);
+   }
+
+   UE_LOG(LogRiotWave, Display, TEXT("Weapons: Inline=%d InlineResidentKB=%.1f Definition=%d StreamedResidentKB=%.1f Loads=%d AvgLoadMs=%.2f"),
+      NumInline, GetResidentBytes(InlineAssets) / 1024.0, NumDefinition, GetResidentBytes(StreamedAssets) / 1024.0,
+      NumLoaded, NumLoaded > 0 ? TotalLoadMs / NumLoaded : 0.0);
+}
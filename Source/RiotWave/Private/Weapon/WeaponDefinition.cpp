@@ -0,0 +1,31 @@
+// WeaponDefinition.cpp - Implements the weapon definition asset id and property building
+
+#include "Weapon/WeaponDefinition.h"
+
+#include "Weapon/WeaponHandlingComponent.h"
+
+const FPrimaryAssetType UWeaponDefinition::PrimaryAssetType = TEXT("WeaponDefinition");
+
+
+FPrimaryAssetId UWeaponDefinition::GetPrimaryAssetId() const {
+	return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
+
+
+void UWeaponDefinition::GetStreamedAssets( TArray<FSoftObjectPath>& OutPaths ) const {
+	for ( const FSoftObjectPath& Path : { MuzzleFlash.ToSoftObjectPath(), ImpactParticle.ToSoftObjectPath(), BeamTraceParticle.ToSoftObjectPath(),
+		FireSound.ToSoftObjectPath(), FireMontage.ToSoftObjectPath() } ) {
+		if ( !Path.IsNull() ) { OutPaths.Add(Path); }
+	}
+}
+
+
+void UWeaponDefinition::BuildWeaponProperties( FInitWeaponProperties& OutProperties ) const {
+	OutProperties = FInitWeaponProperties(MuzzleFlash.Get(), ImpactParticle.Get(), BeamTraceParticle.Get(), FireSound.Get(), WeaponSocketName,
+		BaseDamage, HeadshotMultiplier, FireMontage.Get(), PelletCount, PelletSpread);
+	OutProperties.ProjectileSpeed = ProjectileSpeed;
+	OutProperties.ProjectileGravityScale = ProjectileGravityScale;
+	OutProperties.ProjectileLifetime = ProjectileLifetime;
+	OutProperties.RoundsPerMinute = RoundsPerMinute;
+	OutProperties.bAutomatic = bAutomatic;
+}
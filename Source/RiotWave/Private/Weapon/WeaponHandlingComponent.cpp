@@ -8,75 +8,247 @@
 
 #include "Weapon/WeaponHandlingComponent.h"
 
+#include "Algo/Count.h"
+#include "Animation/FirstPersonAnimInstance.h"
+#include "Audio/AudioEventSubsystem.h"
+#include "Combat/DamageQueueSubsystem.h"
+#include "Combat/LagCompensationSubsystem.h"
+#include "Combat/ProjectileSubsystem.h"
+#include "Effects/EffectPoolSubsystem.h"
 #include "Enemy/Enemy.h"
+#include "Engine/AssetManager.h"
 #include "Engine/SkeletalMeshSocket.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
 #include "Interface/Weapon/WeaponDetectionInterface.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Player/PlayerCharacter.h"
+#include "Profiling/ShotLatency.h"
+#include "Profiling/TickAudit.h"
+#include "RiotWave.h"
 #include "Weapon/DamageInterface.h"
+#include "Weapon/WeaponDefinition.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Pellet Traces"), STAT_AsyncPelletTraces, STATGROUP_Game);
+
+static FAutoConsoleCommandWithWorldAndArgs GWeaponSwapCheckCommand(
+	TEXT("RiotWave.Weapon.SwapCheck"),
+	TEXT("Swaps through the local player's carried weapons and prints the UObjects, components and registrations created, which should be zero. Optional argument: number of swaps (default 100)."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([]( const TArray<FString>& Args, UWorld* World ) {
+		const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		if ( APlayerCharacter* PlayerCharacter = PlayerController ? Cast<APlayerCharacter>(PlayerController->GetPawn()) : nullptr ) {
+			PlayerCharacter->GetWeaponHandlingComponent()->RunSwapCheck(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 100);
+		}
+	})
+);
+
+static int32 GWeaponAsyncPelletTraces = 1;
+static FAutoConsoleVariableRef CVarWeaponAsyncPelletTraces(
+	TEXT("RiotWave.Weapon.AsyncPelletTraces"),
+	GWeaponAsyncPelletTraces,
+	TEXT("1 = scattered pellets are traced asynchronously and resolved next frame, 0 = every pellet is traced synchronously."),
+	ECVF_Default
+);
+
+namespace {
+	/** Trace length of every shot and pellet */
+	constexpr float WeaponTraceRange = 10000.0f;
+
+	/** Client shots starting farther than this from the shooter are discarded by the server */
+	constexpr float MaxShotOriginDistance = 500.0f;
+}
 
 /**
 * Sets up default component state.
-* Tick enabled to support potential continuous effects or behavior updates.
+* Ticks only from a trigger press until the weapon is ready again after release,
+* since the fire scheduler is the only thing that needs frame time.
 */
 UWeaponHandlingComponent::UWeaponHandlingComponent():
 	BaseDamage(0),
-	HeadshotMultiplier(0) { PrimaryComponentTick.bCanEverTick = true; }
+	HeadshotMultiplier(0) {
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
+	// Needed for ServerFireShot
+	SetIsReplicatedByDefault(true);
+}
 
 
 /**
 * Runtime initialization hook.
-* Currently minimal as most initialization happens during weapon pickup.
+* Binds the pellet trace callback once and creates every weapon slot's mesh component,
+* so nothing is allocated or registered when weapons are picked up or swapped.
+*/
+void UWeaponHandlingComponent::BeginPlay() {
+	Super::BeginPlay();
+
+	PelletTraceDelegate.BindUObject(this, &UWeaponHandlingComponent::OnPelletTraceCompleted);
+	CreateWeaponSlots();
+}
+
+
+/**
+* Releases the streamed assets of carried definition weapons.
 */
-void UWeaponHandlingComponent::BeginPlay() { Super::BeginPlay(); }
+void UWeaponHandlingComponent::EndPlay( const EEndPlayReason::Type EndPlayReason ) {
+	for ( FWeaponSlot& Slot : WeaponSlots ) {
+		if ( Slot.AssetHandle.IsValid() ) { Slot.AssetHandle->ReleaseHandle(); }
+		Slot.AssetHandle.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+/**
+* Creates the slot mesh components, each attached to the player's grip point.
+* Auto activation is off, so hidden slots do not tick or update animation.
+*/
+void UWeaponHandlingComponent::CreateWeaponSlots() {
+	Player = Cast<APlayerCharacter>(GetOwner());
+	if ( !Player || !WeaponSlots.IsEmpty() ) { return; }
+
+	WeaponSlots.SetNum(FMath::Max(NumWeaponSlots, 1));
+	for ( int32 SlotIndex = 0; SlotIndex < WeaponSlots.Num(); ++SlotIndex ) {
+		USkeletalMeshComponent* SlotMesh = NewObject<USkeletalMeshComponent>(this, USkeletalMeshComponent::StaticClass(), *FString::Printf(TEXT("Weapon Mesh %d"), SlotIndex));
+		SlotMesh->bAutoActivate = false;
+		SlotMesh->SetVisibility(false);
+		SlotMesh->RegisterComponent();
+		SlotMesh->AttachToComponent(Player->GetPlayerMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, TEXT("GripPoint"));
+		WeaponSlots[SlotIndex].MeshComponent = SlotMesh;
+	}
+}
 
 
 /**
 * Handles the attachment of a weapon mesh to the player.
-* Creates and configures the weapon mesh component, then attaches it
-* to the player's grip point for proper positioning.
+* Fills a free slot's preattached mesh component, or replaces the equipped weapon
+* when every slot is taken, then equips that slot.
 */
 void UWeaponHandlingComponent::AttachComponentMeshToActor( USkeletalMesh* Mesh ) {
-	// Get and validate player reference
-	Player = Cast<APlayerCharacter>(GetOwner());
-	if ( !WeaponMeshComponent && Player ) {
-		// Create weapon mesh component only when needed
-		WeaponMeshComponent = NewObject<USkeletalMeshComponent>(this, USkeletalMeshComponent::StaticClass(), TEXT("Weapon Mesh") );
-		if ( WeaponMeshComponent ) {
-			// Register and configure the new component
-			WeaponMeshComponent->RegisterComponent();
-			WeaponMeshComponent->SetSkeletalMesh(Mesh);
-			
-			// Attach to player's grip point for proper weapon positioning
-			WeaponMeshComponent->AttachToComponent( Player->GetPlayerMesh(), FAttachmentTransformRules::SnapToTargetNotIncludingScale, TEXT("GripPoint") );
-
-			// Notify player controller of weapon pickup if it implements the interface
-			if ( IWeaponDetectionInterface* WeaponInterface = Cast<IWeaponDetectionInterface>(Player->GetController()) ) { WeaponInterface->OnWeaponPicked(Player); }
-		}
+	// Components created before the owner began play are set up on their first pickup instead
+	CreateWeaponSlots();
+	if ( !Player || WeaponSlots.IsEmpty() ) { return; }
+
+	int32 SlotIndex = WeaponSlots.IndexOfByPredicate([]( const FWeaponSlot& Slot ) { return !Slot.bOccupied; });
+	if ( SlotIndex == INDEX_NONE ) { SlotIndex = WeaponSlots.IsValidIndex(ActiveSlot) ? ActiveSlot : 0; }
+
+	FWeaponSlot& Slot = WeaponSlots[SlotIndex];
+	if ( Slot.AssetHandle.IsValid() ) { Slot.AssetHandle->ReleaseHandle(); }
+	Slot.AssetHandle.Reset();
+	Slot.Definition = nullptr;
+	Slot.Properties = FInitWeaponProperties();
+	Slot.bOccupied = true;
+	Slot.MeshComponent->SetSkeletalMesh(Mesh);
+	EquipSlot(SlotIndex);
+
+	// Notify player controller of weapon pickup if it implements the interface
+	if ( IWeaponDetectionInterface* WeaponInterface = Cast<IWeaponDetectionInterface>(Player->GetController()) ) { WeaponInterface->OnWeaponPicked(Player); }
+}
+
+
+/**
+* Swaps the active weapon. Everything touched here already exists, so the cost
+* is two component activation changes and a struct copy.
+*/
+bool UWeaponHandlingComponent::EquipSlot( const int32 SlotIndex ) {
+	if ( !WeaponSlots.IsValidIndex(SlotIndex) || !WeaponSlots[SlotIndex].bOccupied ) { return false; }
+	if ( SlotIndex == ActiveSlot ) { return true; }
+
+	// A held trigger does not carry over to the new weapon
+	FireScheduler.Release();
+
+	if ( WeaponSlots.IsValidIndex(ActiveSlot) ) { SetSlotMeshActive(WeaponSlots[ActiveSlot], false); }
+	ActiveSlot = SlotIndex;
+	SetSlotMeshActive(WeaponSlots[ActiveSlot], true);
+
+	WeaponMeshComponent = WeaponSlots[ActiveSlot].MeshComponent;
+	ApplyWeaponProperties(WeaponSlots[ActiveSlot].Properties);
+	return true;
+}
+
+
+/**
+* Cycles forward through occupied slots.
+*/
+void UWeaponHandlingComponent::EquipNextSlot() {
+	for ( int32 Offset = 1; Offset < WeaponSlots.Num(); ++Offset ) {
+		if ( EquipSlot(( FMath::Max(ActiveSlot, 0) + Offset ) % WeaponSlots.Num()) ) { return; }
 	}
 }
 
 
+void UWeaponHandlingComponent::SetSlotMeshActive( const FWeaponSlot& Slot, const bool bActive ) {
+	Slot.MeshComponent->SetVisibility(bActive);
+	Slot.MeshComponent->SetActive(bActive);
+}
+
+
 /**
-* Performs line trace from screen center for hit detection.
-* Uses screen-to-world conversion to support accurate aiming
-* from player's view.
+* Counts UObjects and the owner's components and registrations around a run of swaps.
 */
-bool UWeaponHandlingComponent::PerformWorldTrace( FVector& EndTrace, FHitResult& OutHitResult ) const {
+void UWeaponHandlingComponent::RunSwapCheck( const int32 NumSwaps ) {
+	const int32 NumOccupied = Algo::CountIf(WeaponSlots, []( const FWeaponSlot& Slot ) { return Slot.bOccupied; });
+	if ( NumOccupied < 2 ) {
+		UE_LOG(LogRiotWave, Warning, TEXT("SwapCheck: needs at least two carried weapons, carrying %d"), NumOccupied);
+		return;
+	}
+
+	const auto CountRegistered = [this]() {
+		int32 NumRegistered = 0;
+		GetOwner()->ForEachComponent(false, [&NumRegistered]( const UActorComponent* Component ) { NumRegistered += Component->IsRegistered() ? 1 : 0; });
+		return NumRegistered;
+	};
+
+	const int32 StartSlot = ActiveSlot;
+	const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const int32 ComponentsBefore = GetOwner()->GetComponents().Num();
+	const int32 RegisteredBefore = CountRegistered();
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	for ( int32 Swap = 0; Swap < NumSwaps; ++Swap ) { EquipNextSlot(); }
+
+	const double SwapUs = ( FPlatformTime::Seconds() - StartSeconds ) * 1000000.0 / FMath::Max(NumSwaps, 1);
+	const int32 NewObjects = GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore;
+	const int32 NewComponents = GetOwner()->GetComponents().Num() - ComponentsBefore;
+	const int32 NewRegistrations = CountRegistered() - RegisteredBefore;
+	const bool bPassed = NewObjects == 0 && NewComponents == 0 && NewRegistrations == 0;
+	EquipSlot(StartSlot);
+
+	UE_LOG(LogRiotWave, Display, TEXT("SwapCheck: Swaps=%d Weapons=%d AvgSwapUs=%.2f NewObjects=%d NewComponents=%d NewRegistrations=%d Result=%s"),
+		NumSwaps, NumOccupied, SwapUs, NewObjects, NewComponents, NewRegistrations, bPassed ? TEXT("PASS") : TEXT("FAIL"));
+}
+
+
+/**
+* Deprojects the screen center to get the ray the crosshair points along.
+*/
+bool UWeaponHandlingComponent::GetAimRay( FVector& OutStart, FVector& OutDirection ) const {
+	if ( !GetWorld()->GetGameViewport() ) { return false; }
+
 	// Get viewport center for trace origin
 	FVector2D ViewportSize;
 	GetWorld()->GetGameViewport()->GetViewportSize(ViewportSize);
 	const FVector2D CrosshairLocation(ViewportSize.X / 2, ViewportSize.Y / 2);
-	FVector WorldLocation, WorldDirection;
 
 	// Convert screen position to world space for accurate tracing
-	const bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, WorldLocation, WorldDirection);
+	return UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation, OutStart, OutDirection);
+}
 
-	if ( bScreenToWorld ) {
+
+/**
+* Performs line trace from screen center for hit detection.
+* Uses screen-to-world conversion to support accurate aiming
+* from player's view.
+*/
+bool UWeaponHandlingComponent::PerformWorldTrace( FVector& EndTrace, FHitResult& OutHitResult ) const {
+	FVector WorldLocation, WorldDirection;
+	if ( GetAimRay(WorldLocation, WorldDirection) ) {
 		// Perform trace with reasonable length
 		const FVector StartTrace = WorldLocation;
-		EndTrace = StartTrace + ( WorldDirection * 10000 );
+		EndTrace = StartTrace + ( WorldDirection * WeaponTraceRange );
 
 		FCollisionQueryParams CollisionParams;
 		CollisionParams.AddIgnoredActor(GetOwner());
@@ -99,6 +271,17 @@ bool UWeaponHandlingComponent::PerformWorldTrace( FVector& EndTrace, FHitResult&
 * to this handling component.
 */
 void UWeaponHandlingComponent::InitializeWeaponProperties( const FInitWeaponProperties& Effects ) {
+	if ( WeaponSlots.IsValidIndex(ActiveSlot) ) { WeaponSlots[ActiveSlot].Properties = Effects; }
+	ApplyWeaponProperties(Effects);
+	PrewarmWeaponEffects(Effects);
+}
+
+
+/**
+* Copies a weapon's properties into the members read while firing.
+* Plain assignments, so equipping a slot stays free of allocations.
+*/
+void UWeaponHandlingComponent::ApplyWeaponProperties( const FInitWeaponProperties& Effects ) {
 	MuzzleFlash = Effects.MuzzleFlash;
 	ImpactParticle = Effects.ImpactParticle;
 	BeamTraceParticle = Effects.BeamTraceParticle;
@@ -107,49 +290,282 @@ void UWeaponHandlingComponent::InitializeWeaponProperties( const FInitWeaponProp
 	BaseDamage = Effects.Damage;
 	HeadshotMultiplier = Effects.HSMultiplier;
 	WeaponFireMontage = Effects.WeaponFire;
+	PelletCount = FMath::Max(Effects.PelletCount, 1);
+	PelletSpread = Effects.PelletSpread;
+	ProjectileSpeed = Effects.ProjectileSpeed;
+	ProjectileGravityScale = Effects.ProjectileGravityScale;
+	ProjectileLifetime = Effects.ProjectileLifetime;
+	FireScheduler.Configure(Effects.RoundsPerMinute, Effects.bAutomatic);
+}
+
+
+void UWeaponHandlingComponent::PrewarmWeaponEffects( const FInitWeaponProperties& Effects ) const {
+	if ( UEffectPoolSubsystem* EffectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>() ) {
+		EffectPool->PrewarmEffect(Effects.MuzzleFlash, EPooledEffectType::MuzzleFlash);
+		EffectPool->PrewarmEffect(Effects.ImpactParticle, EPooledEffectType::Impact);
+		EffectPool->PrewarmEffect(Effects.BeamTraceParticle, EPooledEffectType::Beam);
+	}
+}
+
+/**
+* Fills the equipped slot from a weapon described by a data asset.
+* The slot's previous handle is only released after the new one is taken,
+* so assets both weapons share are not unloaded and loaded straight back.
+*/
+void UWeaponHandlingComponent::InitializeWeaponDefinition( const UWeaponDefinition* Definition, TSharedPtr<FStreamableHandle> AssetHandle ) {
+	if ( !Definition || !WeaponSlots.IsValidIndex(ActiveSlot) ) { return; }
+
+	if ( !AssetHandle.IsValid() ) {
+		TArray<FSoftObjectPath> AssetPaths;
+		Definition->GetStreamedAssets(AssetPaths);
+		if ( !AssetPaths.IsEmpty() ) {
+			AssetHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetPaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+		}
+	}
+
+	const int32 SlotIndex = ActiveSlot;
+	FWeaponSlot& Slot = WeaponSlots[SlotIndex];
+	if ( Slot.AssetHandle.IsValid() ) { Slot.AssetHandle->ReleaseHandle(); }
+	Slot.AssetHandle = AssetHandle;
+	Slot.Definition = Definition;
+
+	// Whatever is already loaded applies now, so the weapon fires straight away with stats and partial FX
+	FInitWeaponProperties Properties;
+	Definition->BuildWeaponProperties(Properties);
+	InitializeWeaponProperties(Properties);
+
+	if ( Slot.AssetHandle.IsValid() && Slot.AssetHandle->IsLoadingInProgress() ) {
+		Slot.AssetHandle->BindCompleteDelegate(FStreamableDelegate::CreateWeakLambda(this, [this, SlotIndex, Definition]() {
+			// Ignore loads of a definition whose slot was refilled before they finished
+			if ( !WeaponSlots.IsValidIndex(SlotIndex) || WeaponSlots[SlotIndex].Definition != Definition ) { return; }
+
+			FWeaponSlot& LoadedSlot = WeaponSlots[SlotIndex];
+			Definition->BuildWeaponProperties(LoadedSlot.Properties);
+			PrewarmWeaponEffects(LoadedSlot.Properties);
+			if ( SlotIndex == ActiveSlot ) { ApplyWeaponProperties(LoadedSlot.Properties); }
+		}));
+	}
 }
 
 /**
 * Frame update handler.
-* Currently minimal as weapon behavior is primarily event-driven.
+* Advances the fire scheduler, firing every shot that came due during the frame,
+* and stops ticking once the trigger is released and the weapon is ready again.
 */
 void UWeaponHandlingComponent::TickComponent( float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction ) {
+	const FTickAuditScope TickAudit(this);
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	if ( const USkeletalMeshComponent* Mesh = Player->GetPlayerMesh()) {
-		WeaponMeshComponent->SetVisibility(Mesh->IsVisible());
-	}
-		
+	TArray<float, TInlineAllocator<8>> ShotAges;
+	FireScheduler.Advance(DeltaTime, ShotAges);
+	for ( const float ShotAge : ShotAges ) { FIreWeapon(ShotAge); }
+
+	if ( !FireScheduler.IsHeld() && FireScheduler.IsReady() ) { SetComponentTickEnabled(false); }
+}
+
+/**
+* Trigger pressed: fires at once if the weapon is ready, then TickComponent keeps
+* firing at the weapon's rate of fire while the trigger stays held.
+*/
+void UWeaponHandlingComponent::StartFiring() {
+	SetComponentTickEnabled(true);
+	if ( FireScheduler.Press() ) { FIreWeapon(); }
+}
+
+
+/**
+* Trigger released.
+*/
+void UWeaponHandlingComponent::StopFiring() {
+	FireScheduler.Release();
 }
 
+
 /**
 * Handles weapon firing sequence:
-* 1. Traces for potential targets
-* 2. Spawns appropriate effects
+* 1. Traces the center pellet synchronously, so the local player sees the hit and effects this frame
+* 2. Queues async traces for the remaining scattered pellets, resolved next frame
+* 3. On clients, sends every pellet direction to the server, which applies the hits
 */
-void UWeaponHandlingComponent::FIreWeapon() {
+void UWeaponHandlingComponent::FIreWeapon( const float ShotAge ) {
+	FShotLatency::MarkStage(EShotLatencyStage::Fire, GetOwner());
+
 	FVector TraceEndLocation;
 	FHitResult TraceHitResult;
 
-	UGameplayStatics::PlaySoundAtLocation(this, WeaponFireSound, GetOwner()->GetActorLocation());
+	UAudioEventSubsystem::PostSound(this, WeaponFireSound, GetOwner()->GetActorLocation(), RiotWaveSoundTags::Weapon_Fire);
 	
-	Player->GetPlayerMesh()->GetAnimInstance()->Montage_Play(WeaponFireMontage);
+	// Typed call when the arms run the native anim instance, plain montage otherwise
+	if ( UAnimInstance* AnimInstance = Player->GetPlayerMesh()->GetAnimInstance() ) {
+		if ( UFirstPersonAnimInstance* FirstPersonAnimInstance = Cast<UFirstPersonAnimInstance>(AnimInstance) ) {
+			FirstPersonAnimInstance->PlayFireMontage(WeaponFireMontage);
+		} else {
+			AnimInstance->Montage_Play(WeaponFireMontage);
+		}
+	}
 	
+	if ( ProjectileSpeed > 0.0f ) {
+		FireProjectiles(ShotAge);
+		FShotLatency::MarkStage(EShotLatencyStage::Effects, GetOwner());
+		return;
+	}
+
 	// Perform hit detection and spawn effects
 	PerformWorldTrace(TraceEndLocation, TraceHitResult);
+	FShotLatency::MarkStage(EShotLatencyStage::Trace, GetOwner());
+	ResolvePelletHit(TraceHitResult);
+	PlayWeaponEffects(TraceHitResult, TraceEndLocation, EffectSocketName);
+	FShotLatency::MarkStage(EShotLatencyStage::Effects, GetOwner());
+
+	FVector AimStart, AimDirection;
+	if ( !GetAimRay(AimStart, AimDirection) ) { return; }
+
+	// Clients only predict effects; the server confirms each pellet against rewound enemies
+	const bool bHasAuthority = GetOwner()->HasAuthority();
+	TArray<FVector_NetQuantizeNormal> ShotDirections;
+	if ( !bHasAuthority ) { ShotDirections.Add(AimDirection); }
 
-	// Debug message for development feedback
-	if (IDamageInterface* DamageInterface = Cast<IDamageInterface>(TraceHitResult.GetActor())) {
-		DamageInterface->BulletHit(TraceHitResult);
-		PlayWeaponEffects(TraceHitResult, TraceEndLocation, EffectSocketName);
+	const float HalfConeRadians = FMath::DegreesToRadians(PelletSpread * 0.5f);
+	for ( int32 PelletIndex = 1; PelletIndex < PelletCount; ++PelletIndex ) {
+		const FVector PelletDirection = FMath::VRandCone(AimDirection, HalfConeRadians);
+		if ( !bHasAuthority ) { ShotDirections.Add(PelletDirection); }
 
-		if (AEnemy* Enemy = Cast<AEnemy>(TraceHitResult.GetActor())) {
-			UGameplayStatics::ApplyDamage(Enemy, BaseDamage, Player->GetController(), GetOwner(), UDamageType::StaticClass());
+		if ( GWeaponAsyncPelletTraces != 0 ) {
+			QueuePelletTrace(AimStart, PelletDirection);
+			continue;
 		}
+
+		FHitResult PelletHit;
+		FCollisionQueryParams CollisionParams;
+		CollisionParams.AddIgnoredActor(GetOwner());
+		const FVector PelletEnd = AimStart + PelletDirection * WeaponTraceRange;
+		GetWorld()->LineTraceSingleByChannel(PelletHit, AimStart, PelletEnd, ECollisionChannel::ECC_Visibility, CollisionParams);
+		ResolvePelletHit(PelletHit);
+		PlayPelletEffects(PelletHit, PelletHit.bBlockingHit ? PelletHit.ImpactPoint : PelletEnd, EffectSocketName);
+	}
+
+	if ( ShotDirections.Num() > 0 ) {
+		// The enemies were aimed at as the client drew them, which is older than the server's current time
+		const double ViewTime = ULagCompensationSubsystem::GetClientViewTime(Cast<APlayerController>(Player->GetController()));
+		ServerFireShot(AimStart, ShotDirections, ViewTime - ShotAge);
+	}
+}
+
+
+/**
+* Projectile variant of a trigger pull: same pellet directions as hitscan,
+* but each one becomes a bullet in UProjectileSubsystem instead of a trace.
+*/
+void UWeaponHandlingComponent::FireProjectiles( const float ShotAge ) {
+	PlayMuzzleEffects(EffectSocketName);
+
+	FVector AimStart, AimDirection;
+	if ( !GetAimRay(AimStart, AimDirection) ) { return; }
+
+	TArray<FVector_NetQuantizeNormal> Directions;
+	Directions.Add(AimDirection);
+
+	const float HalfConeRadians = FMath::DegreesToRadians(PelletSpread * 0.5f);
+	for ( int32 PelletIndex = 1; PelletIndex < PelletCount; ++PelletIndex ) {
+		Directions.Add(FMath::VRandCone(AimDirection, HalfConeRadians));
+	}
+
+	if ( GetOwner()->HasAuthority() ) {
+		SpawnProjectiles(AimStart, Directions, ShotAge);
 	} else {
-		PlayWeaponEffects(TraceHitResult, TraceEndLocation, EffectSocketName);
+		ServerFireProjectiles(AimStart, Directions, ShotAge);
 	}
+}
+
+
+/**
+* Adds one bullet per direction, capped at the weapon's pellet count.
+* Bullets of a shot that was due ShotAge seconds ago start where they would be by now.
+*/
+void UWeaponHandlingComponent::SpawnProjectiles( const FVector& Start, const TConstArrayView<FVector_NetQuantizeNormal> Directions, const float ShotAge ) {
+	UProjectileSubsystem* Projectiles = GetWorld()->GetSubsystem<UProjectileSubsystem>();
+	if ( !Projectiles ) { return; }
 
+	for ( int32 Index = 0; Index < FMath::Min(Directions.Num(), PelletCount); ++Index ) {
+		const FVector Velocity = FVector(Directions[Index]).GetSafeNormal() * ProjectileSpeed;
+		Projectiles->SpawnProjectile(Start + Velocity * ShotAge, Velocity, ProjectileGravityScale, ProjectileLifetime - ShotAge, BaseDamage, HeadshotMultiplier, GetOwner());
+	}
+}
+
+
+/**
+* Server side of a client's projectile shot.
+*/
+void UWeaponHandlingComponent::ServerFireProjectiles_Implementation( FVector_NetQuantize Start, const TArray<FVector_NetQuantizeNormal>& Directions, const float ShotAge ) {
+	if ( !Player || FVector::DistSquared(Start, Player->GetActorLocation()) > FMath::Square(MaxShotOriginDistance) ) { return; }
+
+	// A shot cannot have been due longer ago than one interval
+	SpawnProjectiles(Start, Directions, FMath::Clamp(ShotAge, 0.0f, FireScheduler.GetShotInterval()));
+}
+
+
+/**
+* Server side of a client shot.
+* Every direction is traced against enemies rewound to ClientTime, then resolved like a local hit.
+*/
+void UWeaponHandlingComponent::ServerFireShot_Implementation( FVector_NetQuantize TraceStart, const TArray<FVector_NetQuantizeNormal>& Directions, const double ClientTime ) {
+	if ( !Player || FVector::DistSquared(TraceStart, Player->GetActorLocation()) > FMath::Square(MaxShotOriginDistance) ) { return; }
+
+	// A client cannot fire more pellets than the weapon has
+	TArray<FVector, TInlineAllocator<16>> Ends;
+	for ( int32 Index = 0; Index < FMath::Min(Directions.Num(), PelletCount); ++Index ) {
+		Ends.Add(TraceStart + Directions[Index].GetSafeNormal() * WeaponTraceRange);
+	}
+
+	TArray<FHitResult> Hits;
+	if ( ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>() ) {
+		LagCompensation->ConfirmShot(TraceStart, Ends, ClientTime, GetOwner(), Hits);
+	}
+
+	for ( const FHitResult& Hit : Hits ) { ResolvePelletHit(Hit); }
+}
+
+
+/**
+* Submits one pellet as an async scene query.
+* The trace end is carried in the datum, so the callback can place the beam on misses.
+*/
+void UWeaponHandlingComponent::QueuePelletTrace( const FVector& Start, const FVector& Direction ) {
+	FCollisionQueryParams CollisionParams(SCENE_QUERY_STAT(WeaponPelletTrace), false, GetOwner());
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, Start + Direction * WeaponTraceRange, ECollisionChannel::ECC_Visibility, CollisionParams, FCollisionResponseParams::DefaultResponseParam, &PelletTraceDelegate);
+	INC_DWORD_STAT(STAT_AsyncPelletTraces);
+}
+
+
+/**
+* Resolves a finished pellet trace.
+* Runs at the start of the next frame, so the shooter or target may be gone by now.
+*/
+void UWeaponHandlingComponent::OnPelletTraceCompleted( const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum ) {
+	if ( !Player ) { return; }
+
+	const FHitResult PelletHit = TraceDatum.OutHits.Num() > 0 ? TraceDatum.OutHits[0] : FHitResult();
+	ResolvePelletHit(PelletHit);
+	PlayPelletEffects(PelletHit, PelletHit.bBlockingHit ? PelletHit.ImpactPoint : TraceDatum.End, EffectSocketName);
+}
+
+
+/**
+* Notifies damageable actors of the hit and queues weapon damage on enemies.
+* Pellets of one shot landing on the same enemy are applied as one TakeDamage at the end of the frame.
+* Only the server applies hits; a client's shots arrive through ServerFireShot.
+*/
+void UWeaponHandlingComponent::ResolvePelletHit( const FHitResult& HitResult ) {
+	if ( !GetOwner()->HasAuthority() ) { return; }
+
+	IDamageInterface* DamageInterface = Cast<IDamageInterface>(HitResult.GetActor());
+	if ( !DamageInterface ) { return; }
+
+	DamageInterface->BulletHit(HitResult);
+
+	if ( Cast<AEnemy>(HitResult.GetActor()) ) {
+		UDamageQueueSubsystem::QueueHit(this, HitResult, BaseDamage, HeadshotMultiplier, Player->GetController(), GetOwner());
+	}
 }
 
 
@@ -160,19 +576,41 @@ void UWeaponHandlingComponent::FIreWeapon() {
 * - Beam/trace effect between barrel and target
 */
 void UWeaponHandlingComponent::PlayWeaponEffects( const FHitResult& HitResult, const FVector& EndEffectLocation, const FName SocketEffectName ) const {
-	if ( WeaponMeshComponent ) {
+	PlayMuzzleEffects(SocketEffectName);
+	PlayPelletEffects(HitResult, EndEffectLocation, SocketEffectName);
+}
+
+
+/**
+* Spawns the muzzle flash at the weapon socket, if one is set.
+*/
+void UWeaponHandlingComponent::PlayMuzzleEffects( const FName SocketEffectName ) const {
+	UEffectPoolSubsystem* EffectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if ( WeaponMeshComponent && MuzzleFlash && EffectPool ) {
 		// Get effect spawn location from weapon socket
 		const FTransform SocketLocationTransform = WeaponMeshComponent->GetSocketByName(SocketEffectName)->GetSocketTransform(WeaponMeshComponent);
+		EffectPool->PlayEffect(MuzzleFlash, SocketLocationTransform.GetLocation(), SocketLocationTransform.Rotator(), EPooledEffectType::MuzzleFlash);
+	}
+}
+
+
+/**
+* Spawns the per-pellet effects:
+* - Impact effect at hit location
+* - Beam/trace effect between barrel and target
+*/
+void UWeaponHandlingComponent::PlayPelletEffects( const FHitResult& HitResult, const FVector& EndEffectLocation, const FName SocketEffectName ) const {
+	UEffectPoolSubsystem* EffectPool = GetWorld()->GetSubsystem<UEffectPoolSubsystem>();
+	if ( WeaponMeshComponent && EffectPool ) {
+		const FTransform SocketLocationTransform = WeaponMeshComponent->GetSocketByName(SocketEffectName)->GetSocketTransform(WeaponMeshComponent);
 
-		// Spawn muzzle flash if set
-		if ( MuzzleFlash ) { UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketLocationTransform, true); }
 		// Spawn impact effect at hit location if we hit something
 		if ( ImpactParticle && HitResult.bBlockingHit ) {
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticle, HitResult.ImpactPoint, HitResult.ImpactNormal.Rotation(), true );
+			EffectPool->PlayEffect(ImpactParticle, HitResult.ImpactPoint, HitResult.ImpactNormal.Rotation(), EPooledEffectType::Impact);
 		}
 		// Spawn beam effect between barrel and target if set
 		if ( BeamTraceParticle ) {
-			if ( UParticleSystemComponent* BeamTrace = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamTraceParticle, SocketLocationTransform) ) {
+			if ( UParticleSystemComponent* BeamTrace = EffectPool->PlayEffect(BeamTraceParticle, SocketLocationTransform.GetLocation(), SocketLocationTransform.Rotator(), EPooledEffectType::Beam) ) {
 				BeamTrace->SetVectorParameter(TEXT("Target"), EndEffectLocation);
 			}
 		}
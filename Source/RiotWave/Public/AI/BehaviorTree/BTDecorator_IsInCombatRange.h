@@ -0,0 +1,28 @@
+// BTDecorator_IsInCombatRange.h - Gates the attack branch on the IsInCombatRange key
+//
+// The decorator never polls. It observes the key and requests re-evaluation only when
+// the value changes, which with the proximity subsystem happens on enter and exit.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Decorators/BTDecorator_BlackboardBase.h"
+#include "BTDecorator_IsInCombatRange.generated.h"
+
+/**
+* Passes while the selected bool key is true (or false when inverted).
+*
+* Design Decisions:
+* - Builds on UBTDecorator_BlackboardBase, which registers the key observer when the node becomes relevant
+* - Aborts both ways by default so leaving range cancels an attack and entering range preempts a chase
+*/
+UCLASS()
+class RIOTWAVE_API UBTDecorator_IsInCombatRange : public UBTDecorator_BlackboardBase {
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_IsInCombatRange();
+
+	virtual bool CalculateRawConditionValue( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) const override;
+	virtual FString GetStaticDescription() const override;
+};
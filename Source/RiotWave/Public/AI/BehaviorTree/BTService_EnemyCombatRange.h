@@ -0,0 +1,43 @@
+// BTService_EnemyCombatRange.h - Low frequency sanity check of the enemy's combat state
+//
+// IsInCombatRange and Target are written by proximity events, which covers every normal
+// transition. This service only catches what events cannot: a target left far behind.
+// It runs on a configurable interval, only while its branch is active.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTService.h"
+#include "BTService_EnemyCombatRange.generated.h"
+
+/**
+* Drops the Target of an engaged enemy once it is out of reach.
+*
+* Design Decisions:
+* - IsInCombatRange is owned by the proximity CombatRange channel, which writes it through AEnemyController::SetInCombatRange
+*   together with AEnemy::bIsInAttackRange; this service never writes it, so the key, the enemy flag and the anim graph
+*   cannot disagree on range or on the distance metric
+* - Placed on the combat branch only, so patrolling enemies never pay for it
+* - Writes go through the blackboard only when the value changes, so observers are not woken for nothing
+* - Interval and RandomDeviation come from UBTService and are editable per node
+*/
+UCLASS()
+class RIOTWAVE_API UBTService_EnemyCombatRange : public UBTService {
+	GENERATED_BODY()
+
+public:
+	UBTService_EnemyCombatRange();
+
+	virtual void InitializeFromAsset( UBehaviorTree& Asset ) override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	virtual void TickNode( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds ) override;
+
+	UPROPERTY(EditAnywhere, Category = "Combat")
+	FBlackboardKeySelector TargetKey;
+
+	/** The target is dropped when it gets farther away than this */
+	UPROPERTY(EditAnywhere, Category = "Combat", meta = (ClampMin = "0"))
+	float LoseTargetDistance = 3000.0f;
+};
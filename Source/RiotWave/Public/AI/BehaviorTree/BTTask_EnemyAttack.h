@@ -0,0 +1,51 @@
+// BTTask_EnemyAttack.h - Plays the enemy attack montage and finishes when it ends
+//
+// The Blueprint attack task played the montage and then waited a fixed delay. This task
+// listens for the montage to end instead, so it finishes exactly when the swing does
+// and never ticks while waiting.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyAttack.generated.h"
+
+class AEnemy;
+class UAnimMontage;
+
+/**
+* Attack task for enemies.
+*
+* Design Decisions:
+* - Instanced per enemy because the montage end event needs to know which tree to finish
+* - Listens on the anim instance's OnMontageEnded, which the native anim instance shares, instead of the per-montage end delegate that only holds one binding
+* - Interrupted montages fail the task so the tree re-evaluates instead of attacking again blindly
+* - Aborting unbinds before stopping the montage, so the abort is not reported twice
+*/
+UCLASS()
+class RIOTWAVE_API UBTTask_EnemyAttack : public UBTTaskNode {
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyAttack();
+
+	virtual EBTNodeResult::Type ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual EBTNodeResult::Type AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+
+protected:
+	/** Blend out time used when the task is aborted mid swing */
+	UPROPERTY(EditAnywhere, Category = "Attack", meta = (ClampMin = "0"))
+	float AbortBlendOutTime = 0.2f;
+
+private:
+	UFUNCTION()
+	void OnMontageEnded( UAnimMontage* Montage, bool bInterrupted );
+
+	/** Unbinds from the anim instance this task is waiting on, if any */
+	void ClearMontageEndDelegate();
+
+	UPROPERTY()
+	TObjectPtr<UBehaviorTreeComponent> OwnerComponent;
+
+	TWeakObjectPtr<AEnemy> AttackingEnemy;
+};
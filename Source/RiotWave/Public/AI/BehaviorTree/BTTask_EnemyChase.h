@@ -0,0 +1,26 @@
+// BTTask_EnemyChase.h - Moves an enemy to its target actor
+//
+// A preconfigured MoveTo: the goal is the Target key and the move follows the actor,
+// so the path is updated by path following instead of the tree restarting the task.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_MoveTo.h"
+#include "BTTask_EnemyChase.generated.h"
+
+/**
+* Chase task for enemies.
+*
+* Design Decisions:
+* - Derives from UBTTask_MoveTo to keep its message-driven completion and gameplay task handling
+* - Only actor keys are accepted, so the move always tracks the target instead of a stale location
+* - Finishes once inside AcceptableRadius; the combat range decorator takes over from there
+*/
+UCLASS()
+class RIOTWAVE_API UBTTask_EnemyChase : public UBTTask_MoveTo {
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyChase( const FObjectInitializer& ObjectInitializer );
+};
@@ -0,0 +1,50 @@
+// BTTask_EnemyFlowChase.h - Chases the target by steering along the shared flow field
+//
+// Chasers sample UFlowFieldSubsystem for a direction each tick and feed it to movement
+// input, so a horde chasing one player shares a single search instead of running one
+// path query per enemy. Enemies outside the field fall back to a regular MoveTo.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyFlowChase.generated.h"
+
+/**
+* Flow field chase task for enemies.
+*
+* Design Decisions:
+* - Sampling is a grid lookup, so the per-tick cost does not depend on distance or obstacles
+* - Pathfinding is only started when the sample misses, and dropped again once the enemy is back on the field
+* - Succeeds inside AcceptableRadius, matching the Enemy Chase task so the two are interchangeable in the tree
+*/
+UCLASS()
+class RIOTWAVE_API UBTTask_EnemyFlowChase : public UBTTaskNode {
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyFlowChase();
+
+	virtual EBTNodeResult::Type ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual EBTNodeResult::Type AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual void InitializeFromAsset( UBehaviorTree& Asset ) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+
+protected:
+	virtual void TickTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds ) override;
+
+	UPROPERTY(EditAnywhere, Category = "Chase")
+	FBlackboardKeySelector TargetKey;
+
+	UPROPERTY(EditAnywhere, Category = "Chase", meta = (ClampMin = "0"))
+	float AcceptableRadius = 150.0f;
+
+private:
+	struct FFlowChaseMemory {
+		/** True while a fallback MoveTo is running */
+		bool bPathfinding = false;
+	};
+
+	/** Returns Succeeded when the chase is over, Failed when it cannot go on, InProgress otherwise */
+	EBTNodeResult::Type UpdateChase( UBehaviorTreeComponent& OwnerComp, FFlowChaseMemory& Memory ) const;
+};
@@ -0,0 +1,65 @@
+// BTTask_EnemyPatrol.h - Walks an enemy along its patrol route
+//
+// Replaces the Blueprint patrol task, which ticked every frame to poll whether the
+// move had finished. This task issues one move request and sleeps until the path
+// following component reports the result. Legs are walked on paths cached by
+// UPatrolRouteSubsystem, so steady-state patrolling makes no path queries.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyPatrol.generated.h"
+
+/**
+* Walks one leg of the enemy's patrol route per execution.
+* The route is the enemy's APatrolRoute if set, otherwise its two patrol points.
+*
+* Design Decisions:
+* - No tick: completion arrives through AIMessage_MoveFinished, so an idle patrolling enemy costs nothing in the BT
+* - Which leg is walked lives in node memory, so one task instance serves every enemy
+* - An enemy away from its route (first run, after a chase) rejoins with one regular MoveTo, the only path query it makes
+* - Both patrol keys are selectors and default to the names in EnemyBlackboardKeys
+*/
+UCLASS()
+class RIOTWAVE_API UBTTask_EnemyPatrol : public UBTTaskNode {
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyPatrol();
+
+	virtual EBTNodeResult::Type ExecuteTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual EBTNodeResult::Type AbortTask( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory ) override;
+	virtual void OnMessage( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message, int32 RequestID, bool bSuccess ) override;
+	virtual void InitializeFromAsset( UBehaviorTree& Asset ) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+	virtual void InitializeMemory( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType ) const override;
+	virtual void CleanupMemory( UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType ) const override;
+	virtual FString GetStaticDescription() const override;
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Patrol")
+	FBlackboardKeySelector PatrolPointKey;
+
+	UPROPERTY(EditAnywhere, Category = "Patrol")
+	FBlackboardKeySelector PatrolPoint2Key;
+
+	UPROPERTY(EditAnywhere, Category = "Patrol", meta = (ClampMin = "0"))
+	float AcceptanceRadius = 50.0f;
+
+	/** Farther than this from the start of its leg, the enemy rejoins the route with a regular MoveTo */
+	UPROPERTY(EditAnywhere, Category = "Patrol", meta = (ClampMin = "0"))
+	float RejoinDistance = 200.0f;
+
+private:
+	struct FPatrolMemory {
+		/** Leg walked next, INDEX_NONE until the enemy reached the route's first stop */
+		int32 LegIndex = INDEX_NONE;
+
+		/** Leg to continue with once the running move succeeds */
+		int32 PendingLegIndex = INDEX_NONE;
+	};
+
+	/** Regular MoveTo used to get back onto the route */
+	EBTNodeResult::Type RejoinRoute( UBehaviorTreeComponent& OwnerComp, FPatrolMemory& Memory, const FVector& Goal, int32 NextLegIndex ) const;
+};
@@ -0,0 +1,22 @@
+// EnemyBlackboardKeys.h - Names of the keys in the enemy blackboard asset
+//
+// Native code and the behavior tree nodes refer to blackboard keys through these names
+// only once, to resolve key IDs. Every later read or write goes through the cached IDs.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace EnemyBlackboardKeys {
+	/** Object: the player the enemy is chasing or attacking */
+	inline const FName Target(TEXT("Target"));
+
+	/** Vector: first patrol point in world space */
+	inline const FName PatrolPoint(TEXT("PatrolPoint"));
+
+	/** Vector: second patrol point in world space */
+	inline const FName PatrolPoint2(TEXT("PatrolPoint2"));
+
+	/** Bool: the target is inside the enemy's combat range */
+	inline const FName IsInCombatRange(TEXT("IsInCombatRange"));
+}
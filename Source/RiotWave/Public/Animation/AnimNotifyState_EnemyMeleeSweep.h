@@ -0,0 +1,28 @@
+// AnimNotifyState_EnemyMeleeSweep.h - Marks the frames of an enemy attack that can hit
+//
+// Replaces the Blueprint notifies that called ActivateWeaponCollision and
+// DeactivateWeaponCollision by name. Place it over the active frames of an attack
+// montage; while it is active the enemy's weapon shape is swept every frame.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "AnimNotifyState_EnemyMeleeSweep.generated.h"
+
+/**
+* Notify state that opens and closes an enemy's melee swing.
+*
+* Design Decisions:
+* - Goes through AEnemy's weapon collision calls, so notifies and existing Blueprint calls share one code path
+* - Does nothing on meshes not owned by an AEnemy, e.g. in the animation editor preview
+*/
+UCLASS(meta = (DisplayName = "Enemy Melee Sweep"))
+class RIOTWAVE_API UAnimNotifyState_EnemyMeleeSweep : public UAnimNotifyState {
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference ) override;
+	virtual void NotifyEnd( USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference ) override;
+	virtual FString GetNotifyName_Implementation() const override;
+};
@@ -0,0 +1,85 @@
+// EnemyAnimInstance.h - Native anim instance for AEnemy
+//
+// The enemy Anim Blueprint used to pull its state in the event graph, which runs on the
+// game thread for every enemy. This class copies the raw actor state in NativeUpdateAnimation
+// and derives everything else in NativeThreadSafeUpdateAnimation, so the graph update can run
+// on worker threads; the Anim Blueprint only reads the exposed properties in its anim graph.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "EnemyAnimInstance.generated.h"
+
+class AEnemy;
+class UCharacterMovementComponent;
+
+/**
+* Anim instance base for enemy Anim Blueprints.
+*
+* Design Decisions:
+* - Owner and movement component are cached on the game thread in NativeInitializeAnimation
+* - Actor and component fields are only read in NativeUpdateAnimation on the game thread, while gameplay cannot write them;
+*   the worker thread pass works on those copies alone
+* - Attacking is tracked by the montage API and OnMontageEnded, so the worker thread never queries montage instances;
+*   those run on the game thread and write a shadow flag, never the graph variable the worker pass reads
+* - Enemy Anim Blueprints reparented to this class should leave their event graph empty to stay on worker threads
+*/
+UCLASS()
+class RIOTWAVE_API UEnemyAnimInstance : public UAnimInstance {
+	GENERATED_BODY()
+
+public:
+	/**
+	* Plays an attack montage and marks the enemy as attacking until it ends.
+	*
+	* @return Montage length in seconds, 0 when it could not be played
+	*/
+	float PlayAttackMontage( UAnimMontage* Montage, float PlayRate = 1.0f );
+
+	/** Blends out the attack montage if one is playing */
+	void StopAttackMontage( float BlendOutTime = 0.2f );
+
+	bool IsAttacking() const { return bGameThreadAttacking; }
+
+protected:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeUpdateAnimation( float DeltaSeconds ) override;
+	virtual void NativeThreadSafeUpdateAnimation( float DeltaSeconds ) override;
+
+	/** Ground speed in units per second */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Animation")
+	float Speed = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Animation")
+	bool bIsInCombatRange = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Animation")
+	bool bIsAttacking = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Animation")
+	bool bIsDead = false;
+
+private:
+	UFUNCTION()
+	void OnAttackMontageEnded( UAnimMontage* Montage, bool bInterrupted );
+
+	UPROPERTY(Transient)
+	TObjectPtr<AEnemy> Enemy;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UCharacterMovementComponent> MovementComponent;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UAnimMontage> ActiveAttackMontage;
+
+	/** Copied from the movement component on the game thread */
+	FVector GameThreadVelocity = FVector::ZeroVector;
+
+	bool bGameThreadInAttackRange = false;
+
+	bool bGameThreadDead = false;
+
+	/** Set by the montage API on the game thread, copied into bIsAttacking by the worker thread pass */
+	bool bGameThreadAttacking = false;
+};
@@ -0,0 +1,113 @@
+// EnemyAnimationBudgetSubsystem.h - Distance and visibility based animation budget for enemy meshes
+//
+// Every AEnemy mesh used to evaluate its animation graph at full rate, including the ones
+// far away or behind the player. Enemy meshes are now budgeted skeletal mesh components:
+// this subsystem rates each one by distance to the closest player and whether it was
+// rendered, and the Animation Budget Allocator spends a fixed number of milliseconds per
+// frame on them, reducing tick rate and interpolating the least significant first.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyAnimationBudgetSubsystem.generated.h"
+
+class AEnemy;
+
+/** Update rate tiers reported by RiotWave.AnimBudget.Stats */
+enum class EAnimRateTier : uint8 {
+	/** Evaluated every frame */
+	Full,
+	/** Every second frame */
+	Half,
+	/** Every third or fourth frame */
+	Quarter,
+	/** Every fifth frame or less often */
+	Low,
+	Num
+};
+
+/**
+* World subsystem that feeds enemy mesh significance to the animation budget.
+*
+* Design Decisions:
+* - Significance falls off linearly with distance to the closest player and is scaled down while the mesh is off screen
+* - Meshes with an active DamageCollision are marked never-skip and tick off screen too, since the hit box follows a bone
+* - With RiotWave.AnimBudget.Enabled 0 the allocator is switched off and meshes fall back to plain update rate optimizations
+* - Pose sharing followers are unregistered from the allocator while they follow, so it neither ticks nor budgets them
+* - Counters are rebuilt every tick from the rate each mesh actually ran at, not from the requested significance
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UEnemyAnimationBudgetSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when enemy meshes are budgeted by the allocator (RiotWave.AnimBudget.Enabled) */
+	static bool IsBudgetEnabled();
+
+	void RegisterEnemy( AEnemy* Enemy );
+
+	void UnregisterEnemy( AEnemy* Enemy );
+
+	/** Applies Enemy's significance right away, e.g. when its weapon collision was just switched on */
+	void RefreshEnemy( AEnemy* Enemy );
+
+	/**
+	* Takes Enemy's mesh out of the allocator, called when it starts following a shared leader pose.
+	* A registered mesh has its tick toggled by the allocator, which would fight the follower's disabled tick.
+	*/
+	void SuspendEnemy( AEnemy* Enemy );
+
+	/** Hands a mesh taken out by SuspendEnemy back to the allocator */
+	void ResumeEnemy( AEnemy* Enemy );
+
+	/** Writes the number of enemy meshes per update rate tier to the log */
+	void LogStats() const;
+
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	/** Pushes the budget and enable state to the world's allocator when they changed */
+	void ApplyAllocatorSettings();
+
+	void ApplySignificance( AEnemy& Enemy, const TArray<FVector>& PlayerLocations ) const;
+
+	/** Frames between two evaluations of Enemy's mesh during the last update */
+	static int32 GetUpdateRate( const AEnemy& Enemy );
+
+	TArray<TWeakObjectPtr<AEnemy>> Enemies;
+
+	/** Enemies whose mesh was unregistered from the allocator by SuspendEnemy */
+	TArray<TWeakObjectPtr<AEnemy>> SuspendedEnemies;
+
+	int32 TierCounts[static_cast<int32>(EAnimRateTier::Num)] = {};
+
+	/** Parked enemies and pose sharing followers, which do not evaluate their own mesh */
+	int32 InactiveCount = 0;
+
+	/** Settings last pushed to the allocator, negative until the first push */
+	float AppliedBudgetMs = -1.0f;
+
+	int32 AppliedEnabled = INDEX_NONE;
+
+	/** Animation time per frame the allocator may spend on enemy meshes, overridden by RiotWave.AnimBudget.BudgetMs */
+	UPROPERTY(Config)
+	float BudgetMs = 1.0f;
+
+	/** Distance to the closest player at which significance reaches zero */
+	UPROPERTY(Config)
+	float MaxSignificanceDistance = 6000.0f;
+
+	/** Significance multiplier for meshes that were not rendered recently */
+	UPROPERTY(Config)
+	float OffscreenSignificanceScale = 0.25f;
+
+	/** Seconds since the last render after which a mesh counts as off screen */
+	UPROPERTY(Config)
+	float RecentlyRenderedTolerance = 0.2f;
+};
@@ -0,0 +1,110 @@
+// EnemyPoseSharingSubsystem.h - Far enemies copy their pose from shared leader meshes
+//
+// Budgeting (UEnemyAnimationBudgetSubsystem) lowers how often a mesh is evaluated, but every
+// enemy still runs its own anim graph. Beyond ShareDistance that is wasted work: nobody can
+// tell two walking enemies apart from that far. Such enemies stop ticking their mesh and
+// follow a leader mesh instead, one per skeletal mesh and animation state, so a crowd of
+// hundreds evaluates a handful of skeletons.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "EnemyPoseSharingSubsystem.generated.h"
+
+class AEnemy;
+class UAnimSequenceBase;
+class USkeletalMesh;
+class USkeletalMeshComponent;
+
+/**
+* World subsystem that moves distant enemy meshes onto shared leader poses.
+*
+* Design Decisions:
+* - Leaders play a looping sequence per state (idle, patrol, chase) set on the enemy class; states without one are never shared
+* - Attacking, dying and parked enemies always evaluate their own graph, since attacks and death are driven by its montages and notifies
+* - Sharing starts beyond ShareDistance and ends inside UnshareDistance, so enemies do not toggle at the boundary
+* - Followers keep their collision and components; only the pose is borrowed, so hits and death work unchanged
+* - Followers are taken out of the animation budget allocator while following and handed back when they stop
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UEnemyPoseSharingSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when distant enemies follow leader poses (RiotWave.PoseSharing.Enabled) */
+	static bool IsPoseSharingEnabled();
+
+	void RegisterEnemy( AEnemy* Enemy );
+
+	/** Gives Enemy its own pose back and forgets it */
+	void UnregisterEnemy( AEnemy* Enemy );
+
+	/** Gives Enemy its own pose back right away but keeps it registered, e.g. when it dies */
+	void StopSharing( AEnemy* Enemy );
+
+	/** Writes leader, follower and locally evaluated skeleton counts to the log */
+	void LogStats() const;
+
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FLeaderKey {
+		TObjectKey<USkeletalMesh> Mesh;
+		TObjectKey<UAnimSequenceBase> Animation;
+
+		bool operator==( const FLeaderKey& Other ) const { return Mesh == Other.Mesh && Animation == Other.Animation; }
+
+		friend uint32 GetTypeHash( const FLeaderKey& Key ) { return HashCombine(GetTypeHash(Key.Mesh), GetTypeHash(Key.Animation)); }
+	};
+
+	struct FSharedEnemy {
+		TWeakObjectPtr<AEnemy> Enemy;
+
+		/** Leader currently followed, null while the enemy evaluates its own pose */
+		TWeakObjectPtr<USkeletalMeshComponent> Leader;
+	};
+
+	/** Animation the enemy should borrow right now, or null when it has to evaluate its own pose */
+	UAnimSequenceBase* SelectSharedAnimation( const AEnemy& Enemy, float ClosestDistSquared, bool bIsSharing ) const;
+
+	USkeletalMeshComponent* FindOrAddLeader( USkeletalMesh* Mesh, UAnimSequenceBase* Animation );
+
+	void Follow( FSharedEnemy& Shared, USkeletalMeshComponent* Leader );
+
+	/** Returns the enemy to its own pose. Its mesh only resumes ticking while the enemy is in play */
+	void StopFollowing( FSharedEnemy& Shared );
+
+	TArray<FSharedEnemy> Enemies;
+
+	TMap<FLeaderKey, TObjectPtr<USkeletalMeshComponent>> Leaders;
+
+	/** Hosts the leader components */
+	UPROPERTY()
+	TObjectPtr<AActor> LeaderActor;
+
+	int32 FollowerCount = 0;
+
+	int32 LocalCount = 0;
+
+	/** Bones evaluated per frame by locally animated enemies and by leaders, the CPU side of the comparison */
+	int32 EvaluatedBones = 0;
+
+	/** Enemies farther than this from every player start following a leader */
+	UPROPERTY(Config)
+	float ShareDistance = 2500.0f;
+
+	/** Following enemies closer than this to any player evaluate their own pose again */
+	UPROPERTY(Config)
+	float UnshareDistance = 2000.0f;
+
+	/** Ground speed below which an enemy without a target counts as idle rather than patrolling */
+	UPROPERTY(Config)
+	float IdleSpeedThreshold = 10.0f;
+};
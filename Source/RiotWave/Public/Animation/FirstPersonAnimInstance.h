@@ -0,0 +1,78 @@
+// FirstPersonAnimInstance.h - Native anim instance for the player's first-person arms
+//
+// Same idea as UEnemyAnimInstance: actor state is copied in NativeUpdateAnimation, derived
+// in NativeThreadSafeUpdateAnimation, and the fire montage is triggered through a typed call instead of reaching into the
+// mesh's anim instance from weapon code.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "FirstPersonAnimInstance.generated.h"
+
+class APlayerCharacter;
+class UCharacterMovementComponent;
+
+/**
+* Anim instance base for the first-person arms Anim Blueprint (APlayerCharacter::PlayerMesh).
+*
+* Design Decisions:
+* - The arms mesh is not the character's main mesh, so the owner is resolved through the owning actor rather than the pawn's mesh
+* - Firing is tracked by the montage API and OnMontageEnded, never by querying montages on the worker thread;
+*   the game thread writes a shadow flag that the worker thread pass copies into bIsFiring
+*/
+UCLASS()
+class RIOTWAVE_API UFirstPersonAnimInstance : public UAnimInstance {
+	GENERATED_BODY()
+
+public:
+	/**
+	* Plays a weapon fire montage and marks the arms as firing until it ends.
+	*
+	* @return Montage length in seconds, 0 when it could not be played
+	*/
+	float PlayFireMontage( UAnimMontage* Montage, float PlayRate = 1.0f );
+
+	bool IsFiring() const { return bGameThreadFiring; }
+
+protected:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeUpdateAnimation( float DeltaSeconds ) override;
+	virtual void NativeThreadSafeUpdateAnimation( float DeltaSeconds ) override;
+
+	/** Ground speed in units per second, drives weapon sway and bob */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "First Person Animation")
+	float Speed = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "First Person Animation")
+	bool bIsFalling = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "First Person Animation")
+	bool bIsFiring = false;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "First Person Animation")
+	bool bIsDead = false;
+
+private:
+	UFUNCTION()
+	void OnFireMontageEnded( UAnimMontage* Montage, bool bInterrupted );
+
+	UPROPERTY(Transient)
+	TObjectPtr<APlayerCharacter> Player;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UCharacterMovementComponent> MovementComponent;
+
+	UPROPERTY(Transient)
+	TObjectPtr<UAnimMontage> ActiveFireMontage;
+
+	/** Copied from the player and its movement component on the game thread */
+	FVector GameThreadVelocity = FVector::ZeroVector;
+
+	bool bGameThreadFalling = false;
+
+	bool bGameThreadDead = false;
+
+	/** Set by the montage API on the game thread, copied into bIsFiring by the worker thread pass */
+	bool bGameThreadFiring = false;
+};
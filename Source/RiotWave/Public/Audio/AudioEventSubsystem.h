@@ -0,0 +1,145 @@
+// AudioEventSubsystem.h - Budgeted one-shot sounds routed by gameplay tag
+//
+// Gameplay code used to fire every sound through UGameplayStatics::PlaySoundAtLocation,
+// which creates a new audio component per shot, hit and pickup. In a large fight that is
+// hundreds of voices a second, most of them inaudible under each other. Sounds are now
+// posted as events tagged from the Sound tag tree; the router merges repeats, applies
+// per-category concurrency and rate limits and plays survivors on pooled components.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "NativeGameplayTags.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "AudioEventSubsystem.generated.h"
+
+class UAudioComponent;
+class USoundBase;
+
+/** Events posted by gameplay code. Categories in the config can name these or any parent, e.g. Sound.Enemy */
+namespace RiotWaveSoundTags {
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Weapon_Fire);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Weapon_Pickup);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Enemy_Impact);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Enemy_Attack);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Player_Impact);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Player_Death);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Item_Pickup);
+	RIOTWAVE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Item_Drop);
+}
+
+/** Limits for every event at or below Category in the tag tree */
+USTRUCT()
+struct FAudioCategoryLimits {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGameplayTag Category;
+
+	/** Voices of the category playing at once; the oldest is stolen beyond this. 0 = no limit */
+	UPROPERTY()
+	int32 MaxConcurrent = 0;
+
+	/** Events started per second, extra ones are dropped. 0 = no limit */
+	UPROPERTY()
+	float MaxPerSecond = 0.0f;
+
+	/** The same sound posted again within this many seconds and MergeRadius is merged into the first */
+	UPROPERTY()
+	float MergeWindow = 0.0f;
+
+	UPROPERTY()
+	float MergeRadius = 100.0f;
+};
+
+/**
+* World subsystem that routes one-shot sound events to a pool of audio components.
+*
+* Design Decisions:
+* - Events are tagged, and limits are looked up by category tag, so tuning lives in config next to the Sound tag table
+* - The first category in Categories matching an event wins, so specific categories are listed before their parents
+* - Concurrency steals the oldest voice of the category, since a new shot or hit is more relevant than a fading one
+* - With RiotWave.Audio.Router 0 events go straight to PlaySoundAtLocation, for comparison
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UAudioEventSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Posts Sound at Location through WorldContextObject's router, or plays it directly when there is none */
+	static void PostSound( const UObject* WorldContextObject, USoundBase* Sound, const FVector& Location, FGameplayTag Event );
+
+	/** Merges, rate limits and plays Sound as Event. Returns false when it was merged or dropped */
+	bool PostSoundEvent( USoundBase* Sound, const FVector& Location, FGameplayTag Event );
+
+	/** Writes submitted, merged, dropped, stolen and played counts to the log */
+	void LogStats() const;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FVoice {
+		TObjectPtr<UAudioComponent> Component;
+		FGameplayTag Category;
+		double StartTime = 0.0;
+	};
+
+	struct FRecentEvent {
+		TObjectKey<USoundBase> Sound;
+		FVector Location;
+		double Time = 0.0;
+		float MergeWindow = 0.0f;
+		float MergeRadius = 0.0f;
+	};
+
+	struct FCategoryState {
+		/** Token bucket for MaxPerSecond */
+		float Tokens = 0.0f;
+		double LastRefillTime = -1.0;
+	};
+
+	const FAudioCategoryLimits* FindLimits( const FGameplayTag& Event ) const;
+
+	/** True when the same sound played close by within the category's merge window */
+	bool MergeEvent( USoundBase* Sound, const FVector& Location, double Now );
+
+	/** Spends one rate token of the category. False when it has none left */
+	bool ConsumeRateToken( const FGameplayTag& Category, float MaxPerSecond, double Now );
+
+	/** Free pooled component, a new one below MaxVoices, or the stolen oldest voice of the category or of all */
+	UAudioComponent* AcquireVoice( const FGameplayTag& Category, int32 MaxConcurrent );
+
+	UAudioComponent* CreateVoice();
+
+	TArray<FVoice> Voices;
+
+	TArray<FRecentEvent> RecentEvents;
+
+	TMap<FGameplayTag, FCategoryState> CategoryStates;
+
+	/** Hosts the pooled components */
+	UPROPERTY()
+	TObjectPtr<AActor> AudioActor;
+
+	int32 TotalSubmitted = 0;
+
+	int32 TotalMerged = 0;
+
+	int32 TotalDropped = 0;
+
+	int32 TotalStolen = 0;
+
+	int32 TotalPlayed = 0;
+
+	/** Pooled audio components, and so the most router voices playing at once */
+	UPROPERTY(Config)
+	int32 MaxVoices = 48;
+
+	UPROPERTY(Config)
+	TArray<FAudioCategoryLimits> Categories;
+};
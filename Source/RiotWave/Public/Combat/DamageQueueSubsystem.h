@@ -0,0 +1,115 @@
+// DamageQueueSubsystem.h - Per-frame batched damage with bone damage zones
+//
+// Every pellet, bullet and melee swing used to call UGameplayStatics::ApplyDamage the
+// moment it hit, so a shotgun blast into one enemy ran TakeDamage once per pellet.
+// Hits are now queued during the frame and applied once per damaged actor, with head
+// and limb multipliers looked up from a bone index table built once per skeletal mesh.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "DamageQueueSubsystem.generated.h"
+
+class USkeletalMesh;
+
+/** Region of a skeleton a hit landed on, which picks its damage multiplier */
+enum class EDamageZone : uint8 {
+	Body,
+	Head,
+	Limb
+};
+
+/**
+* World subsystem that collects damage events and applies them once per actor per frame.
+*
+* Design Decisions:
+* - The zone of a hit is resolved when it is queued, from the physics body's bone index, so no bone names are compared per hit
+* - Zone tables are per skeletal mesh since hit bone indices are mesh indices; a bone inherits its parent's zone unless listed itself
+* - Head hits use the weapon's headshot multiplier, limb hits LimbMultiplier, everything else no multiplier
+* - Coalesced damage goes to the actor's TakeDamage with the instigator and causer of the last event, so TakeDamage stays the one consumer
+* - With RiotWave.Damage.Batching 0 every event is applied as soon as it is queued, for comparison
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UDamageQueueSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	* Queues a weapon hit on HitResult's actor, scaled by the zone of the bone that was hit.
+	* Applied at once when WorldContextObject's world has no queue.
+	*/
+	static void QueueHit( const UObject* WorldContextObject, const FHitResult& HitResult, float Damage, float HeadshotMultiplier, AController* EventInstigator, AActor* DamageCauser );
+
+	/** Queues damage without a hit location, e.g. a melee swing. Applied at once when there is no queue */
+	static void QueueDamage( const UObject* WorldContextObject, AActor* Target, float Damage, AController* EventInstigator, AActor* DamageCauser );
+
+	/** Zone of BoneIndex on Mesh, building the mesh's table on first use */
+	EDamageZone GetDamageZone( const USkeletalMesh* Mesh, int32 BoneIndex );
+
+	/** Writes queued, applied and coalesced counts to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FQueuedDamage {
+		TWeakObjectPtr<AActor> Target;
+		TWeakObjectPtr<AController> EventInstigator;
+		TWeakObjectPtr<AActor> DamageCauser;
+
+		/** Already scaled by the zone multiplier */
+		float Damage = 0.0f;
+
+		/** Mesh bone the hit landed on, INDEX_NONE for hits without a bone */
+		int32 BoneIndex = INDEX_NONE;
+
+		EDamageZone Zone = EDamageZone::Body;
+	};
+
+	void Enqueue( const FQueuedDamage& Event );
+
+	/** Calls TakeDamage on the event's target, skipping targets that cannot be damaged */
+	void ApplyEvent( const FQueuedDamage& Event );
+
+	/** Sums the queued events per target and calls TakeDamage once for each */
+	void ApplyQueuedDamage();
+
+	float GetZoneMultiplier( EDamageZone Zone, float HeadshotMultiplier ) const;
+
+	/** Events of the current frame, reused every frame */
+	TArray<FQueuedDamage> QueuedEvents;
+
+	/** Scratch for ApplyQueuedDamage: index into AppliedEvents per target */
+	TMap<TObjectKey<AActor>, int32> TargetIndices;
+
+	/** Scratch for ApplyQueuedDamage: one summed event per target */
+	TArray<FQueuedDamage> AppliedEvents;
+
+	/** Zone per bone index, per skeletal mesh */
+	TMap<TObjectKey<USkeletalMesh>, TArray<EDamageZone>> ZoneTables;
+
+	int32 TotalQueued = 0;
+
+	int32 TotalApplied = 0;
+
+	int32 TotalHeadHits = 0;
+
+	int32 TotalLimbHits = 0;
+
+	/** Bones that start the head zone; their children are head too */
+	UPROPERTY(Config)
+	TArray<FName> HeadBones;
+
+	/** Bones that start a limb zone, e.g. upper arms and thighs */
+	UPROPERTY(Config)
+	TArray<FName> LimbBones;
+
+	UPROPERTY(Config)
+	float LimbMultiplier = 0.75f;
+};
@@ -0,0 +1,126 @@
+// LagCompensationSubsystem.h - Server side hitbox history for validating client shots
+//
+// A client fires at enemies as it saw them, which on the server is already a round trip in
+// the past. The server records every enemy's transform into a fixed size ring buffer and,
+// when a shot arrives, moves the enemies near the shot back to where they were at the
+// client's timestamp, traces, and puts them back before anything else runs.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LagCompensationSubsystem.generated.h"
+
+class AEnemy;
+class APlayerController;
+
+/**
+* World subsystem that records enemy hitbox history and traces shots against rewound enemies.
+*
+* Design Decisions:
+* - Only the actor transform is recorded; capsule and physics asset bodies move with it, bone poses are not rewound
+* - Every enemy owns one ring buffer sized from HistorySeconds and RecordRate when it registers, so memory per enemy is fixed
+* - Only enemies whose rewound bounds come near the shot are moved, which bounds the rewind cost by the crowd around the ray
+* - Timestamps older than the history are clamped to the oldest record instead of being rejected
+* - Recording and rewinding only happen where the world has authority; clients never touch enemy transforms
+* - Shot times are the server time of the enemy poses the client was rendering, see GetClientViewTime, not when the shot arrived
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API ULagCompensationSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	* Server time of the enemy poses PlayerController's client is rendering right now: its estimate of the
+	* server clock, less half the round trip the state took to arrive and the proxies' interpolation delay.
+	* This is the time ConfirmShot expects. Where the world has authority it is the current time.
+	*/
+	static double GetClientViewTime( const APlayerController* PlayerController );
+
+	void RegisterEnemy( AEnemy* Enemy );
+
+	void UnregisterEnemy( AEnemy* Enemy );
+
+	/**
+	* Traces one line per entry of Ends from Start against the enemies as they were at ShotTime,
+	* the server time of the poses the shooter saw (GetClientViewTime minus the shot's age).
+	* OutHits receives one result per end, in the same order. Enemies are restored before returning.
+	*/
+	void ConfirmShot( const FVector& Start, TConstArrayView<FVector> Ends, double ShotTime, const AActor* Shooter, TArray<FHitResult>& OutHits );
+
+	/** Writes history memory and rewind cost to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FHitboxSnapshot {
+		double Time = 0.0;
+		FVector Location = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+	};
+
+	struct FHitboxHistory {
+		TWeakObjectPtr<AEnemy> Enemy;
+
+		/** Allocated once at Capacity, then overwritten in place */
+		TArray<FHitboxSnapshot> Snapshots;
+
+		/** Slot the next snapshot is written to */
+		int32 Head = 0;
+
+		int32 Num = 0;
+	};
+
+	/** A rewound enemy and the transform it gets back afterwards */
+	struct FRewoundEnemy {
+		AEnemy* Enemy = nullptr;
+		FTransform RestoreTransform;
+	};
+
+	/** Snapshot slots per enemy, derived from HistorySeconds and RecordRate */
+	int32 GetCapacity() const;
+
+	void Record( FHitboxHistory& History, double Time ) const;
+
+	/** Enemy transform at Time, interpolated between the two surrounding snapshots. False without history */
+	bool SampleHistory( const FHitboxHistory& History, double Time, FVector& OutLocation, FQuat& OutRotation ) const;
+
+	TArray<FHitboxHistory> Histories;
+
+	/** Seconds since the last snapshot was recorded */
+	float TimeSinceRecord = 0.0f;
+
+	int32 TotalShots = 0;
+
+	int32 TotalRewoundEnemies = 0;
+
+	int32 MaxRewoundEnemies = 0;
+
+	double TotalRewindSeconds = 0.0;
+
+	double MaxRewindSeconds = 0.0;
+
+	/** How far back shots can be rewound */
+	UPROPERTY(Config)
+	float HistorySeconds = 0.5f;
+
+	/** Snapshots recorded per second */
+	UPROPERTY(Config)
+	float RecordRate = 60.0f;
+
+	/**
+	* How far behind the latest replicated state simulated enemies are drawn, from network smoothing.
+	* Subtracted from client shot times together with half the round trip
+	*/
+	UPROPERTY(Config)
+	float ClientInterpolationDelay = 0.1f;
+
+	/** Added to an enemy's capsule half height when deciding whether a shot passes close enough to rewind it */
+	UPROPERTY(Config)
+	float CandidateMargin = 50.0f;
+};
@@ -0,0 +1,77 @@
+// MeleeSweepSubsystem.h - Swept melee hit detection for enemy attacks
+//
+// Enemy melee used to switch the DamageCollision box between NoCollision and QueryOnly and
+// wait for overlap events. That rebuilt the box's physics state on every swing, could report
+// the same player several times, and a fast swing at a low frame rate could jump over the
+// player between two frames. Swinging enemies are now registered here and their weapon box
+// is swept from last frame's transform to this frame's, for all of them in one pass per tick.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MeleeSweepSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+* World subsystem that sweeps the weapon shape of every swinging enemy.
+*
+* Design Decisions:
+* - DamageCollision stays as the authored shape and socket but never has collision itself, so swings cause no physics state churn
+* - Sweeps run after all actors ticked, so the weapon socket already holds this frame's pose
+* - Long or strongly rotating frames are split into sub-steps, which keeps arcs from being cut short by a single straight sweep
+* - Every actor is damaged at most once per swing, however many frames it stays inside the arc
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UMeleeSweepSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Starts sweeping Enemy's DamageCollision shape from its current transform */
+	void BeginSwing( AEnemy* Enemy );
+
+	void EndSwing( AEnemy* Enemy );
+
+	/** Writes swing, sweep and hit totals to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FMeleeSwing {
+		TWeakObjectPtr<AEnemy> Enemy;
+
+		/** Weapon shape transform at the end of the previous sweep */
+		FTransform PreviousTransform;
+
+		/** Actors already damaged by this swing */
+		TArray<TWeakObjectPtr<AActor>, TInlineAllocator<4>> HitActors;
+	};
+
+	/** Sweeps one swing from its previous to its current transform and damages new hits */
+	void SweepSwing( FMeleeSwing& Swing );
+
+	TArray<FMeleeSwing> Swings;
+
+	int32 TotalSwings = 0;
+
+	int32 TotalSweeps = 0;
+
+	int32 TotalHits = 0;
+
+	/** A frame's movement is split into sub-steps of at most this many world units */
+	UPROPERTY(Config)
+	float MaxSubstepDistance = 40.0f;
+
+	/** A frame's movement is split into sub-steps of at most this many degrees of weapon rotation */
+	UPROPERTY(Config)
+	float MaxSubstepAngle = 30.0f;
+
+	UPROPERTY(Config)
+	int32 MaxSubsteps = 4;
+};
@@ -0,0 +1,107 @@
+// ProjectileSubsystem.h - Batched ballistic projectile simulation
+//
+// Weapons with a ProjectileSpeed fire bullets that take time to arrive and drop with gravity.
+// A bullet is a row in a few parallel arrays, not an actor or component: the whole set is
+// integrated in one tight loop, each step is swept as a line segment on the Projectile
+// channel, and hits are resolved through IDamageInterface like hitscan shots.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileSubsystem.generated.h"
+
+/** The "Projectile" object channel from DefaultEngine.ini. Enemy capsules ignore it so bullets reach the mesh bodies */
+constexpr ECollisionChannel ECC_Projectile = ECC_GameTraceChannel1;
+
+/**
+* World subsystem that owns and simulates every live projectile.
+*
+* Design Decisions:
+* - Structure of arrays, so the integration loop streams through contiguous positions and velocities only
+* - Segment traces run in parallel since they only read the scene; hits are applied afterwards on the game thread
+* - Dead bullets are swap-removed from every array at once, so the arrays stay dense and unordered
+* - Spawning beyond MaxProjectiles is refused rather than evicting live bullets; BudgetMs is the step time 10k bullets must fit in
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UProjectileSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/**
+	* Adds a bullet at Location moving with Velocity.
+	* GravityScale multiplies the world gravity. Returns false when MaxProjectiles are already in flight.
+	*/
+	bool SpawnProjectile( const FVector& Location, const FVector& Velocity, float GravityScale, float Lifetime, float Damage, float HeadshotMultiplier, AActor* Owner );
+
+	int32 GetNumProjectiles() const { return Positions.Num(); }
+
+	/** Writes live bullet count, step time against BudgetMs and hit totals to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	/** Moves every bullet by DeltaTime and writes where it wants to be to NextPositions */
+	void Integrate( float DeltaTime );
+
+	/** Traces every bullet from its position to NextPositions, filling Hits and bHasHit */
+	void SweepSegments();
+
+	/** Applies hits, advances survivors and removes expired or hit bullets */
+	void ResolveAndCompact();
+
+	void RemoveProjectile( int32 Index );
+
+	TArray<FVector> Positions;
+
+	TArray<FVector> Velocities;
+
+	/** Z acceleration per bullet, world gravity times the bullet's gravity scale */
+	TArray<float> GravityZ;
+
+	/** Seconds each bullet has left before it is dropped */
+	TArray<float> Lifetimes;
+
+	TArray<float> Damages;
+
+	TArray<float> HeadshotMultipliers;
+
+	TArray<TWeakObjectPtr<AActor>> Owners;
+
+	/** Per step scratch, sized with the bullet arrays */
+	TArray<FVector> NextPositions;
+
+	TArray<FHitResult> Hits;
+
+	TArray<bool> bHasHit;
+
+	double LastStepMs = 0.0;
+
+	double MaxStepMs = 0.0;
+
+	int32 PeakProjectiles = 0;
+
+	int32 TotalSpawned = 0;
+
+	int32 TotalRejected = 0;
+
+	int32 TotalHits = 0;
+
+	/** Upper bound of bullets in flight */
+	UPROPERTY(Config)
+	int32 MaxProjectiles = 10000;
+
+	/** Step time the simulation is expected to stay under at MaxProjectiles, reported by RiotWave.Projectiles.Stats */
+	UPROPERTY(Config)
+	float BudgetMs = 2.0f;
+
+	/** Bullets per parallel trace batch */
+	UPROPERTY(Config)
+	int32 SweepBatchSize = 64;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "BehaviorTree/Blackboard/BlackboardKey.h"
 #include "EnemyController.generated.h"
 
 class UBehaviorTreeComponent;
@@ -21,12 +23,53 @@ protected:
 	virtual void BeginPlay() override;
 
 public:
-	// Called every frame
+	/**
+	* Only turns the pawn towards its focus, so the tick is enabled just while there is a
+	* target or focal point to face; see RefreshTickEnabled.
+	*/
 	virtual void Tick( float DeltaTime ) override;
 
+	/** Focus changes come from gameplay and from path following, and decide whether the controller ticks */
+	virtual void SetFocus( AActor* NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay ) override;
+
+	virtual void SetFocalPoint( FVector NewFocus, EAIFocusPriority::Type InPriority = EAIFocusPriority::Gameplay ) override;
+
+	virtual void ClearFocus( EAIFocusPriority::Type InPriority ) override;
+
 	virtual void OnPossess(APawn* InPawn) override;
 
+	/** Typed blackboard writes through key IDs cached in OnPossess. Unknown keys are ignored */
+	void SetTargetActor( AActor* Target );
+
+	void SetPatrolPoints( const FVector& InPatrolPoint, const FVector& InPatrolPoint2 );
+
+	void SetInCombatRange( bool bInCombatRange );
+
+	/** Current target from the blackboard, null when there is none or the key is unknown */
+	AActor* GetTargetActor() const;
+
+protected:
+	/** Counts every path query enemies make, see RiotWave.Patrol.Stats */
+	virtual void FindPathForMoveRequest( const FAIMoveRequest& MoveRequest, FPathFindingQuery& Query, FNavPathSharedPtr& OutPath ) const override;
+
 private:
+	/** Resolves the key IDs of EnemyBlackboardKeys against the current blackboard asset */
+	void CacheBlackboardKeys();
+
+	/** Blackboard observer of the target key, however it was written */
+	EBlackboardNotificationResult OnTargetKeyChanged( const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID );
+
+	/** Enables the actor tick while there is a target or a focal point, disables it otherwise */
+	void RefreshTickEnabled();
+
+	FBlackboard::FKey TargetKey = FBlackboard::InvalidKey;
+
+	FBlackboard::FKey PatrolPointKey = FBlackboard::InvalidKey;
+
+	FBlackboard::FKey PatrolPoint2Key = FBlackboard::InvalidKey;
+
+	FBlackboard::FKey IsInCombatRangeKey = FBlackboard::InvalidKey;
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "AIBehaviour", meta=(AllowPrivateAccess = "true"))
 	TObjectPtr<UBlackboardComponent> BlackboardComponent;
 
@@ -29,6 +29,13 @@ class RIOTWAVE_API APlayerCharacterController : public APlayerController, public
     GENERATED_BODY()
 
 protected:
+    /**
+     * Binds every input action exactly once, when the input component is created.
+     * Possessing a new pawn or picking up another weapon only changes mapping contexts,
+     * so callbacks never stack up.
+     */
+    virtual void SetupInputComponent() override;
+
     /** 
      * Initializes controller-character relationship and input mappings when possessing a pawn.
      * Called automatically by the engine when this controller takes control of a pawn.
@@ -66,8 +73,14 @@ protected:
     /**
      * Processes weapon firing input.
      * Only active when WeaponHandlingMappingContext is enabled (i.e., player has a weapon).
+     * Press and release only; the weapon's fire scheduler decides when shots happen.
      */
-    void HandleWeapWeaponFireAction();
+    void HandleWeaponFireStarted();
+
+    void HandleWeaponFireCompleted();
+
+    /** Equips the next carried weapon. Swapping only toggles preloaded meshes, so it is safe to spam */
+    void HandleSwitchWeaponAction();
 
 private:
     // Reference to the controlled character, cached for performance
@@ -101,6 +114,9 @@ private:
     UPROPERTY(EditAnywhere, Category = "Input")
     TObjectPtr<UInputAction> WeaponFireAction;
 
+    UPROPERTY(EditAnywhere, Category = "Input")
+    TObjectPtr<UInputAction> SwitchWeaponAction;
+
 public:
     /**
      * Implements IWeaponDetectionInterface.
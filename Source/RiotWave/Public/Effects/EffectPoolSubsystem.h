@@ -0,0 +1,132 @@
+// EffectPoolSubsystem.h - Pooled and budgeted particle effects for weapons and hits
+//
+// Every shot used to spawn up to three emitters (muzzle flash, impact, beam) and every
+// enemy hit one more, each allocating and registering a new particle system component that
+// destroyed itself when done. Effects now come from per-asset pools of components that are
+// created up front and reactivated in place, with a cap on how many of an asset play at once.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "EffectPoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+/** What an effect is used for, which decides its cap and whether it can be culled or merged */
+enum class EPooledEffectType : uint8 {
+	/** Attached to the shooter's weapon, never culled */
+	MuzzleFlash,
+	/** Culled by distance and view, merged with other impacts at the same point in the same frame */
+	Impact,
+	/** Barrel to target trail, never culled since its end may be in view even if its start is not */
+	Beam,
+	Num
+};
+
+/**
+* World subsystem that plays particle effects from pools of reusable components.
+*
+* Design Decisions:
+* - One pool per effect asset, prewarmed when a weapon is picked up or an enemy begins play
+* - A full pool reuses its oldest component instead of allocating, so the cap per asset is also the component count
+* - Impacts are only played within MaxImpactDistance of a local player's view and inside its view cone
+* - With RiotWave.FX.Pooling 0 effects are spawned through UGameplayStatics as before, for comparison
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UEffectPoolSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when effects come from the pools (RiotWave.FX.Pooling) */
+	static bool IsPoolingEnabled();
+
+	/**
+	* Plays Template at Location. Returns the component playing it, e.g. to set a beam's target,
+	* or null when the effect was culled, merged into another impact or Template is null.
+	*/
+	UParticleSystemComponent* PlayEffect( UParticleSystem* Template, const FVector& Location, const FRotator& Rotation, EPooledEffectType Type );
+
+	/** Creates the pool for Template up front, so the first shot does not allocate */
+	void PrewarmEffect( UParticleSystem* Template, EPooledEffectType Type );
+
+	/** Writes pool sizes and play, reuse, cull and merge totals to the log */
+	void LogStats() const;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FEffectPool {
+		TArray<TObjectPtr<UParticleSystemComponent>> Components;
+
+		/** Component reused next when all are playing, which is the one that started longest ago */
+		int32 NextReuse = 0;
+
+		int32 Cap = 0;
+	};
+
+	FEffectPool& FindOrAddPool( UParticleSystem* Template, EPooledEffectType Type );
+
+	/** A free component of Pool, a new one while under the cap, otherwise the oldest playing one */
+	UParticleSystemComponent* AcquireComponent( FEffectPool& Pool, UParticleSystem* Template );
+
+	UParticleSystemComponent* CreateComponent( UParticleSystem* Template );
+
+	/** False when no local player is close enough to Location or looking towards it */
+	bool IsImpactVisible( const FVector& Location ) const;
+
+	/** True when an impact of Template already played within MergeRadius of Location this frame */
+	bool MergeImpact( UParticleSystem* Template, const FVector& Location );
+
+	int32 GetCap( EPooledEffectType Type ) const;
+
+	TMap<TObjectKey<UParticleSystem>, FEffectPool> Pools;
+
+	/** Hosts the pooled components */
+	UPROPERTY()
+	TObjectPtr<AActor> EffectActor;
+
+	/** Impacts played this frame, for merging */
+	TArray<TPair<TObjectKey<UParticleSystem>, FVector>> FrameImpacts;
+
+	uint64 FrameImpactsFrame = 0;
+
+	int32 TotalPlayed = 0;
+
+	int32 TotalCreated = 0;
+
+	int32 TotalStolen = 0;
+
+	int32 TotalCulled = 0;
+
+	int32 TotalMerged = 0;
+
+	UPROPERTY(Config)
+	int32 MaxMuzzleFlashes = 4;
+
+	UPROPERTY(Config)
+	int32 MaxImpacts = 24;
+
+	UPROPERTY(Config)
+	int32 MaxBeams = 16;
+
+	/** Components created per pool by PrewarmEffect */
+	UPROPERTY(Config)
+	int32 PrewarmCount = 4;
+
+	UPROPERTY(Config)
+	float MaxImpactDistance = 5000.0f;
+
+	/** Impacts behind this angle from a player's view direction are culled. Wider than the FOV so edges do not pop */
+	UPROPERTY(Config)
+	float ImpactViewAngle = 75.0f;
+
+	/** Impacts of the same asset closer than this in one frame play once, e.g. shotgun pellets on one wall */
+	UPROPERTY(Config)
+	float MergeRadius = 20.0f;
+};
@@ -0,0 +1,119 @@
+// CorpseSubsystem.h - Budgeted ragdolls and corpse lifetime for dead enemies
+//
+// Dead enemies used to vanish into the pool on the frame they died. They now stay as
+// corpses: a limited number fall as ragdolls, every corpse is frozen into a static pose
+// once its bodies sleep or it simulated for too long, and the oldest corpses go back to
+// the pool once there are too many, so big waves never pay for hundreds of ragdolls.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CorpseSubsystem.generated.h"
+
+class AEnemy;
+
+/** Corpse counters of the last tick, printed by RiotWave.Corpse.Stats */
+struct FCorpseStats {
+	int32 SimulatingCorpses = 0;
+
+	int32 FrozenCorpses = 0;
+
+	/** Physics bodies of simulating corpses */
+	int32 SimulatedBodies = 0;
+
+	/** Bodies still awake, which is what the physics step actually pays for */
+	int32 AwakeBodies = 0;
+
+	/**
+	* Game thread time spent starting, checking and freezing ragdolls since the previous tick, in milliseconds.
+	* The rigid body step itself runs in the physics scene and shows up under stat physics
+	*/
+	double RagdollWorkMs = 0.0;
+
+	double MaxRagdollWorkMs = 0.0;
+
+	/** Dead enemies that did not get a ragdoll because the body budget was used up */
+	int32 RagdollsDenied = 0;
+
+	int32 Recycled = 0;
+};
+
+/**
+* World subsystem that owns dead enemies until they are returned to the pool.
+*
+* Design Decisions:
+* - The ragdoll budget counts physics bodies rather than corpses, since body count is what drives the physics step
+* - A new ragdoll freezes the oldest simulating corpses to make room; if it still does not fit it is frozen in its death pose
+* - Freezing stops physics and the mesh tick, so the last simulated pose stays on screen at no cost
+* - Corpses leave through UEnemyPoolSubsystem, oldest first, when MaxCorpses is exceeded or after CorpseLifetime
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UCorpseSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when dead enemies may become ragdolls (RiotWave.Corpse.Ragdolls) */
+	static bool AreRagdollsEnabled();
+
+	/** Takes over a dead enemy. Called by AEnemy::Death after its death events were broadcast */
+	void AddCorpse( AEnemy* Enemy );
+
+	/** Writes corpse counts, the ragdoll bodies they keep simulating and the time spent on them to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FCorpse {
+		TWeakObjectPtr<AEnemy> Enemy;
+
+		double DeathTime = 0.0;
+
+		/** Physics bodies in the ragdoll, 0 once frozen */
+		int32 SimulatedBodies = 0;
+	};
+
+	/** Starts simulating Corpse if the body budget allows, freezing older ragdolls as needed */
+	bool TryStartRagdoll( FCorpse& Corpse );
+
+	void FreezeCorpse( FCorpse& Corpse );
+
+	/** Hands the enemy back to the pool, or destroys it when there is no pool */
+	void RecycleCorpse( const FCorpse& Corpse );
+
+	/** Oldest first */
+	TArray<FCorpse> Corpses;
+
+	/** Bodies currently simulated over all corpses */
+	int32 SimulatedBodies = 0;
+
+	/** Ragdoll work measured since the last tick published it to Stats */
+	uint64 RagdollWorkCycles = 0;
+
+	FCorpseStats Stats;
+
+	/** Upper bound of ragdoll bodies simulated at once */
+	UPROPERTY(Config)
+	int32 MaxSimulatedBodies = 200;
+
+	/** Corpses kept in the world at once; the oldest is recycled beyond this */
+	UPROPERTY(Config)
+	int32 MaxCorpses = 40;
+
+	/** Seconds a ragdoll may simulate before it is frozen even if still moving */
+	UPROPERTY(Config)
+	float MaxSimulationTime = 4.0f;
+
+	/** Seconds after death at which a corpse is recycled */
+	UPROPERTY(Config)
+	float CorpseLifetime = 20.0f;
+
+	/** Collision profile applied to the mesh while it is a ragdoll */
+	UPROPERTY(Config)
+	FName RagdollCollisionProfile = TEXT("Ragdoll");
+};
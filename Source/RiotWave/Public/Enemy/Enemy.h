@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "Interface/Proximity/ProximityListenerInterface.h"
 #include "Weapon/DamageInterface.h"
 #include "Enemy.generated.h"
 
@@ -12,26 +13,82 @@ class UBoxComponent;
 class USphereComponent;
 class AEnemyController;
 class UBehaviorTree;
+class APatrolRoute;
+class UAnimSequenceBase;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnEnemyDiedSignature, AEnemy*);
 
 UCLASS()
-class RIOTWAVE_API AEnemy : public ACharacter, public IDamageInterface {
+class RIOTWAVE_API AEnemy : public ACharacter, public IDamageInterface, public IProximityListenerInterface {
 	GENERATED_BODY()
 
 public:
 	// Sets default values for this character's properties
-	AEnemy();
+	AEnemy( const FObjectInitializer& ObjectInitializer );
 
 public:
 	void Death();
+
+	/** Restores a parked enemy to full health at SpawnTransform and restarts its behavior tree */
+	void OnAcquiredFromPool( const FTransform& SpawnTransform );
+
+	/** Stops AI, movement and collision and hides the enemy at ParkLocation */
+	void OnReturnedToPool( const FVector& ParkLocation );
+
+	/** Stops AI and movement and clears the capsule's collision, leaving the mesh to UCorpseSubsystem */
+	void EnterCorpseState();
+
+	/**
+	* Continues the life of a horde proxy that was promoted to a full enemy.
+	* Patrol points are already in world space since the proxy kept walking its route.
+	*/
+	void ApplyHordeState( float InHealth, const FVector& InWorldPatrolPoint, const FVector& InWorldPatrolPoint2 );
+
+	/** Plays AttackMontage. Returns false when there is no montage or anim instance to play it on */
+	UFUNCTION(BlueprintCallable) 
+	bool PlayAttackMontage();
+
+	/** Blends out AttackMontage if it is playing, e.g. when the attack task is aborted */
+	void StopAttackMontage( float BlendOutTime );
+
+	/** Opens a melee swing: DamageCollision's shape is swept every frame until DeactivateWeaponCollision */
+	UFUNCTION(BlueprintCallable)
+	void ActivateWeaponCollision();
+
+	UFUNCTION(BlueprintCallable)
+	void DeactivateWeaponCollision();
+
+	/** True during the active frames of an attack */
+	bool IsWeaponCollisionActive() const { return bIsWeaponCollisionActive; }
+
+	/** Applies melee damage to OtherActor if it is a player. Called by UMeleeSweepSubsystem once per actor and swing */
+	void DoDamage( AActor* OtherActor );
+
+	/** Broadcast once per life, before the enemy is handed back to the pool */
+	FOnEnemyDiedSignature OnEnemyDied;
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 	void InitPatrolPoint();
 
+	/** Mesh responses on top of its collision profile */
+	void InitMeshCollision();
+
+	/** Stops the behavior tree, movement, proximity queries and the weapon. Shared by parking and dying */
+	void StopActing();
+
+	/** Undoes what UCorpseSubsystem did to the mesh and capsule, before a pooled enemy is reused */
+	void ResetCorpseState();
+
 	
 	void InitOverlapEvents();
 
+	/** Hands the agro and combat range checks to UProximitySubsystem and turns the spheres' overlaps off */
+	void InitProximityEvents();
+
 	UFUNCTION()
 	void AgroSphereOnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult );
 
@@ -47,23 +104,6 @@ protected:
 	UFUNCTION()
 	void CombatRangeSphereOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex );
 
-	UFUNCTION(BlueprintCallable) 
-	void PlayAttackMontage();
-
-	UFUNCTION()
-	void DamageCollisionOnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult );
-
-	UFUNCTION()
-	void DamageCollisionOnOverlapEnd( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex );
-
-	UFUNCTION(BlueprintCallable)
-	void ActivateWeaponCollision();
-
-	UFUNCTION(BlueprintCallable)
-	void DeactivateWeaponCollision();
-
-	void DoDamage( AActor* OtherActor );
-	
 protected:
 	UPROPERTY(EditAnywhere, Category = "Enemy Properties", BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<UParticleSystem> ImpactParticle;
@@ -80,13 +120,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Enemy Properties", BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<USoundBase> AttackSound;
 
-public:
-	// Called every frame
-	virtual void Tick( float DeltaTime ) override;
+	UPROPERTY(VisibleAnywhere, Category = "Enemy Properties", BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
+	bool bIsDead;
 
-	virtual void BulletHit( FHitResult HitResult ) override;
+public:
+	virtual void BulletHit( const FHitResult& HitResult ) override;
 
+	/** Receives the frame's summed hits from UDamageQueueSubsystem, once per frame */
 	virtual float TakeDamage( float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser ) override;
+
+	virtual void OnProximityBegin( EProximityChannel Channel, AActor* Target ) override;
+
+	virtual void OnProximityEnd( EProximityChannel Channel, AActor* Target ) override;
 private:
 	
 private:
@@ -98,6 +143,29 @@ private:
 
 	UPROPERTY(EditAnywhere, Category = "Enemy Properties|AI", BlueprintReadWrite, meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
 	FVector PatrolPoint2;
+
+	/** Shared route walked instead of PatrolPoint and PatrolPoint2 when set */
+	UPROPERTY(EditAnywhere, Category = "Enemy Properties|AI", BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<APatrolRoute> PatrolRoute;
+
+	/** Patrol points resolved to world space by InitPatrolPoint */
+	FVector WorldPatrolPoint;
+
+	FVector WorldPatrolPoint2;
+
+	/** Instanced mesh drawn for this enemy while it is simulated as a distant horde proxy. No mesh disables proxies for the class */
+	UPROPERTY(EditDefaultsOnly, Category = "Enemy Properties|Horde", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UStaticMesh> HordeProxyMesh;
+
+	/** Looping sequences distant enemies borrow from shared leader meshes. States left empty always evaluate the anim graph */
+	UPROPERTY(EditDefaultsOnly, Category = "Enemy Properties|Pose Sharing", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UAnimSequenceBase> SharedIdleAnimation;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Enemy Properties|Pose Sharing", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UAnimSequenceBase> SharedPatrolAnimation;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Enemy Properties|Pose Sharing", meta = (AllowPrivateAccess = "true"))
+	TObjectPtr<UAnimSequenceBase> SharedChaseAnimation;
 	
 	UPROPERTY()
 	TObjectPtr<AEnemyController> EnemyController;
@@ -114,12 +182,37 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Enemy Properties|Combat", BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<UAnimMontage> AttackMontage;
 
+	/** Weapon shape swept by UMeleeSweepSubsystem during swings. It has no collision of its own */
 	UPROPERTY(VisibleAnywhere, Category = "Enemy Properties|Combat", BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	TObjectPtr<UBoxComponent> DamageCollision;
 
+	bool bIsWeaponCollisionActive = false;
+
+	/** Mesh and capsule setup from BeginPlay, restored by ResetCorpseState */
+	FTransform DefaultMeshRelativeTransform;
+
+	FName DefaultMeshCollisionProfile;
+
+	TEnumAsByte<ECollisionEnabled::Type> DefaultCapsuleCollision = ECollisionEnabled::QueryAndPhysics;
+
 	UPROPERTY(EditAnywhere, Category = "Enemy Properties|Collectable", BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	TSubclassOf<AItemBase> ItemToSpawnOnDeath;
 
 public:
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+	FORCEINLINE bool IsDead() const { return bIsDead; }
+	FORCEINLINE bool IsInAttackRange() const { return bIsInAttackRange; }
+	FORCEINLINE float GetHealth() const { return Health; }
+	FORCEINLINE float GetMaxHealth() const { return MaxHealth; }
+	FORCEINLINE const FVector& GetPatrolPoint() const { return PatrolPoint; }
+	FORCEINLINE const FVector& GetPatrolPoint2() const { return PatrolPoint2; }
+	FORCEINLINE const FVector& GetWorldPatrolPoint() const { return WorldPatrolPoint; }
+	FORCEINLINE const FVector& GetWorldPatrolPoint2() const { return WorldPatrolPoint2; }
+	FORCEINLINE UStaticMesh* GetHordeProxyMesh() const { return HordeProxyMesh; }
+	FORCEINLINE UAnimSequenceBase* GetSharedIdleAnimation() const { return SharedIdleAnimation; }
+	FORCEINLINE UAnimSequenceBase* GetSharedPatrolAnimation() const { return SharedPatrolAnimation; }
+	FORCEINLINE UAnimSequenceBase* GetSharedChaseAnimation() const { return SharedChaseAnimation; }
+	FORCEINLINE UAnimMontage* GetAttackMontage() const { return AttackMontage; }
+	FORCEINLINE UBoxComponent* GetDamageCollision() const { return DamageCollision; }
+	FORCEINLINE APatrolRoute* GetPatrolRoute() const { return PatrolRoute; }
 };
@@ -0,0 +1,131 @@
+// EnemyPoolSubsystem.h - Recycles enemy actors between waves
+//
+// Spawning an AEnemy is expensive: the character, its overlap spheres, the damage box,
+// the AI controller, blackboard and behavior tree are all created and initialized.
+// Destroying it afterwards feeds the garbage collector. This subsystem keeps dead enemies
+// parked and hidden so the next wave can reuse them instead of spawning new actors.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyPoolSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+* Counters for a single pooled enemy class.
+* Hits and misses are counted on acquire so designers can tune pre-warm counts.
+*/
+USTRUCT(BlueprintType)
+struct FEnemyPoolStats {
+	GENERATED_BODY()
+
+	/** Acquire requests served from the free list */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Pool")
+	int32 Hits = 0;
+
+	/** Acquire requests that found the free list empty */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Pool")
+	int32 Misses = 0;
+
+	/** Enemies handed back to the pool after death */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Pool")
+	int32 Releases = 0;
+
+	/** Enemies spawned ahead of time by PrewarmPool */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enemy Pool")
+	int32 Prewarmed = 0;
+};
+
+/** Free list and counters for one enemy class */
+USTRUCT()
+struct FEnemyPoolBucket {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AEnemy>> FreeEnemies;
+
+	UPROPERTY()
+	FEnemyPoolStats Stats;
+};
+
+/** Config entry describing how many enemies of a class to spawn when the world begins play */
+USTRUCT()
+struct FEnemyPoolPrewarmEntry {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category = "Enemy Pool")
+	TSoftClassPtr<AEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, Category = "Enemy Pool")
+	int32 Count = 0;
+};
+
+/**
+* World subsystem that pools AEnemy actors per class.
+*
+* Design Decisions:
+* - Pooled enemies keep their controller, blackboard and components; only gameplay state is reset
+* - Parked enemies are hidden, collision-less and moved to ParkLocation so they cost nothing
+* - Pre-warm counts come from config so each map can size its pool without code changes
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UEnemyPoolSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Spawns the configured pre-warm counts once actors can be spawned */
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+
+	/** Destroys parked enemies so nothing outlives the world */
+	virtual void Deinitialize() override;
+
+	/**
+	* Returns a pooled enemy moved to SpawnTransform, or nullptr if the pool for this class is empty.
+	* Counts a hit or a miss either way.
+	*/
+	AEnemy* TryAcquireEnemy( TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform );
+
+	/** Returns a pooled enemy if one is free, otherwise spawns a new one */
+	UFUNCTION(BlueprintCallable, Category = "Enemy Pool")
+	AEnemy* AcquireEnemy( TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform );
+
+	/** Deactivates a dead enemy and parks it for reuse. Destroys it if the pool is full */
+	void ReleaseEnemy( AEnemy* Enemy );
+
+	/** Spawns Count parked enemies of EnemyClass ahead of time */
+	UFUNCTION(BlueprintCallable, Category = "Enemy Pool")
+	void PrewarmPool( TSubclassOf<AEnemy> EnemyClass, int32 Count );
+
+	/** Returns the counters for a class, or empty stats if it was never pooled */
+	UFUNCTION(BlueprintCallable, Category = "Enemy Pool")
+	FEnemyPoolStats GetPoolStats( TSubclassOf<AEnemy> EnemyClass ) const;
+
+	/** Writes the counters for every pooled class to the log */
+	void LogPoolStats() const;
+
+protected:
+	/** Pool only exists in worlds that actually play */
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	/** Spawns an enemy directly at the park location for the free list */
+	AEnemy* SpawnParkedEnemy( TSubclassOf<AEnemy> EnemyClass );
+
+	/** Free lists keyed by enemy class */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FEnemyPoolBucket> Buckets;
+
+	/** Enemies spawned when the world begins play */
+	UPROPERTY(Config)
+	TArray<FEnemyPoolPrewarmEntry> PrewarmEntries;
+
+	/** Where parked enemies wait. Kept well above KillZ so they are never culled by the world */
+	UPROPERTY(Config)
+	FVector ParkLocation = FVector(0.0f, 0.0f, -50000.0f);
+
+	/** Upper bound of parked enemies per class; extra releases are destroyed */
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass = 256;
+};
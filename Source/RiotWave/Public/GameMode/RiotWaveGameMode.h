@@ -0,0 +1,47 @@
+// RiotWaveGameMode.h - Native game mode that owns the wave configuration
+//
+// Wave content lives here so designers edit it on the game mode Blueprint,
+// while the spawning itself is handled by UWaveDirectorSubsystem.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "Wave/WaveDirectorSubsystem.h"
+#include "RiotWaveGameMode.generated.h"
+
+/**
+* Base game mode for RiotWave maps.
+*
+* Design Decisions:
+* - Derives from AGameModeBase so the existing first person game mode Blueprint can be reparented onto it
+* - Only holds data and hands it to the wave director, so the spawn loop does not depend on the game mode
+*/
+UCLASS()
+class RIOTWAVE_API ARiotWaveGameMode : public AGameModeBase {
+	GENERATED_BODY()
+
+public:
+	/** Pre-warms the enemy pool and starts the first wave */
+	virtual void StartPlay() override;
+
+protected:
+	/** Waves played in order once the match starts */
+	UPROPERTY(EditDefaultsOnly, Category = "Waves")
+	TArray<FWaveDefinition> Waves;
+
+	/** Starts the wave loop automatically when play begins */
+	UPROPERTY(EditDefaultsOnly, Category = "Waves")
+	bool bStartWavesOnPlay = true;
+
+	/**
+	* Spawns enough pooled enemies for the largest wave while the map loads,
+	* so the waves themselves never pay for spawning.
+	*/
+	UPROPERTY(EditDefaultsOnly, Category = "Waves")
+	bool bPrewarmEnemyPool = true;
+
+private:
+	/** Finds the peak count per enemy class across all waves and pre-warms that many */
+	void PrewarmEnemyPool() const;
+};
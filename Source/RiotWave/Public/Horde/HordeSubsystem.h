@@ -0,0 +1,180 @@
+// HordeSubsystem.h - Lightweight simulation of distant enemies
+//
+// A full AEnemy is a character with movement, a skeletal mesh, an AI controller and a
+// behavior tree. Far away from every player none of that is visible, so distant horde
+// members are kept here as plain data and drawn with instanced static meshes. An enemy is
+// promoted to a real AEnemy (through the enemy pool) when a player gets close, and demoted
+// back to data when every player is far away again.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HordeSubsystem.generated.h"
+
+class AEnemy;
+class UInstancedStaticMeshComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnHordeEnemyChangedSignature, AEnemy*);
+
+/**
+* Per-entity state stored as structure-of-arrays.
+*
+* Every array has one entry per proxy and all of them are swap-removed together,
+* so the update loop walks contiguous memory per field.
+*/
+struct FHordeFragments {
+	TArray<FVector> Positions;
+	TArray<float> Health;
+	TArray<FVector> PatrolPoints;
+	TArray<FVector> PatrolPoints2;
+
+	/** Patrol leg currently walked: 0 towards PatrolPoints, 1 towards PatrolPoints2 */
+	TArray<uint8> PatrolLegs;
+
+	/** Index into UHordeSubsystem's archetypes (one per enemy class) */
+	TArray<int32> Archetypes;
+
+	/** Instance index in the archetype's instanced mesh */
+	TArray<int32> Instances;
+
+	int32 Num() const { return Positions.Num(); }
+
+	int32 Add();
+
+	void RemoveAtSwap( int32 Index );
+};
+
+/**
+* World subsystem that owns horde proxies and moves enemies between the two representations.
+*
+* Design Decisions:
+* - Fragment layout mirrors what a MassEntity archetype would hold, without pulling the Mass plugins into the project
+* - Promotion and demotion go through UEnemyPoolSubsystem, so switching representation never spawns in steady state
+* - Instance slots are recycled through a free list instead of RemoveInstance, keeping instance indices stable
+* - Demotion uses a larger radius than promotion so enemies do not flicker between the two at the boundary
+* - Chasing proxies steer by the shared flow field when it covers them; every step is projected on the navmesh,
+*   so proxies stop at walls and follow the floor height instead of walking a straight line through the level
+* - Promotion spawns on the navmesh and only where the capsule fits; otherwise the proxy stays a proxy and retries
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UHordeSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when horde proxies are enabled (RiotWave.Horde.Enabled) */
+	static bool IsHordeEnabled();
+
+	/** Whether an enemy of this class spawned here should start as a proxy rather than a full actor */
+	bool ShouldSpawnAsProxy( TSubclassOf<AEnemy> EnemyClass, const FVector& Location ) const;
+
+	/** Creates a proxy for EnemyClass, with patrol points resolved from the class defaults */
+	void AddProxy( TSubclassOf<AEnemy> EnemyClass, const FTransform& SpawnTransform );
+
+	/**
+	* Drops every proxy and forgets the promoted enemies, which stay full enemies from then on.
+	* Called when the wave director stops, since every proxy belongs to its run.
+	*/
+	void ClearProxies();
+
+	/** Number of enemies currently simulated as proxies */
+	int32 GetProxyCount() const { return Fragments.Num(); }
+
+	/** Writes proxy counts and promotion totals to the log */
+	void LogStats() const;
+
+	/** Fired after a proxy became a full enemy */
+	FOnHordeEnemyChangedSignature OnEnemyPromoted;
+
+	/** Fired right before a full enemy is turned back into a proxy and returned to the pool */
+	FOnHordeEnemyChangedSignature OnEnemyDemoted;
+
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	/** Shared data for every proxy of one enemy class */
+	struct FHordeArchetype {
+		TSubclassOf<AEnemy> EnemyClass;
+		TWeakObjectPtr<UInstancedStaticMeshComponent> InstancedMesh;
+		TArray<int32> FreeInstances;
+		float MoveSpeed = 0.0f;
+
+		/** Capsule half height: proxy positions are capsule centers like actor locations */
+		float MeshHeightOffset = 0.0f;
+
+		float CapsuleRadius = 0.0f;
+
+		/** Set when an instance moved this tick, so the render state is only dirtied when needed */
+		bool bInstancesDirty = false;
+	};
+
+	/** Finds or creates the archetype for a class, or INDEX_NONE if the class has no proxy mesh */
+	int32 FindOrAddArchetype( TSubclassOf<AEnemy> EnemyClass );
+
+	int32 AcquireInstance( int32 ArchetypeIndex, const FTransform& Transform );
+
+	void ReleaseInstance( int32 ArchetypeIndex, int32 InstanceIndex );
+
+	/** Moves every proxy towards its target or along its patrol route */
+	void SimulateProxies( float DeltaTime, const TArray<AActor*>& Players, const TArray<FVector>& PlayerLocations );
+
+	/**
+	* Finds a navmesh location for a proxy at Location.
+	*
+	* @param HorizontalExtent - How far sideways the navmesh may be; small values make walls block
+	* @return False when the navmesh has no point nearby; OutLocation is then left untouched. Levels without a navmesh pass Location through
+	*/
+	bool ProjectToNavMesh( const FHordeArchetype& Archetype, const FVector& Location, float HorizontalExtent, FVector& OutLocation ) const;
+
+	/** Promotes proxies near players and demotes full enemies far from all of them */
+	void UpdateRepresentations( const TArray<FVector>& PlayerLocations );
+
+	void PromoteProxy( int32 ProxyIndex );
+
+	void DemoteEnemy( AEnemy* Enemy );
+
+	void RemoveProxyAt( int32 ProxyIndex );
+
+	/** Squared distance to the closest player, or MAX_flt when there are none */
+	static float ClosestPlayerDistSquared( const FVector& Location, const TArray<FVector>& PlayerLocations, int32* OutPlayerIndex = nullptr );
+
+	FHordeFragments Fragments;
+
+	TArray<FHordeArchetype> Archetypes;
+
+	/** Full enemies that came from proxies and may be demoted again */
+	TArray<TWeakObjectPtr<AEnemy>> PromotedEnemies;
+
+	/** Hosts the instanced mesh components */
+	UPROPERTY()
+	TObjectPtr<AActor> RenderActor;
+
+	/** Proxies closer than this to any player become full enemies */
+	UPROPERTY(Config)
+	float PromoteRadius = 3000.0f;
+
+	/** Promoted enemies farther than this from every player become proxies again */
+	UPROPERTY(Config)
+	float DemoteRadius = 4000.0f;
+
+	/** Proxies start walking towards a player inside this radius instead of patrolling */
+	UPROPERTY(Config)
+	float ChaseRadius = 8000.0f;
+
+	/** Sideways reach of the per-step navmesh projection; a step into a wall thicker than twice this finds no navmesh and stops */
+	UPROPERTY(Config)
+	float StepProjectionExtent = 25.0f;
+
+	/** Sideways reach of the navmesh projection when a proxy is promoted */
+	UPROPERTY(Config)
+	float PromoteProjectionExtent = 100.0f;
+
+	int32 TotalPromotions = 0;
+
+	int32 TotalDemotions = 0;
+};
@@ -0,0 +1,56 @@
+// Copyright notice...
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "ProximityListenerInterface.generated.h"
+
+/**
+ * Ranges tracked by UProximitySubsystem.
+ * Each one replaces a sphere component that used to generate overlap events.
+ */
+UENUM(BlueprintType)
+enum class EProximityChannel : uint8 {
+	Aggro,
+	CombatRange,
+	Pickup,
+	/** Outer range at which a weapon streams in its FX and montage ahead of pickup */
+	AssetStreaming,
+
+	Count UMETA(Hidden)
+};
+
+/**
+ * Interface declaration required by UE's reflection system.
+ */
+UINTERFACE()
+class UProximityListenerInterface : public UInterface {
+	GENERATED_BODY()
+};
+
+/**
+ * Interface for actors registered as agents with UProximitySubsystem.
+ *
+ * The subsystem reports enter/exit transitions here instead of through sphere overlap
+ * delegates, so implementers typically forward to the handlers they already had for
+ * OnComponentBeginOverlap / OnComponentEndOverlap.
+ */
+class RIOTWAVE_API IProximityListenerInterface {
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Called when a target enters the agent's range on a channel.
+	 *
+	 * @param Channel - The range that was entered
+	 * @param Target - The registered target (usually the player character)
+	 */
+	virtual void OnProximityBegin(EProximityChannel Channel, AActor* Target) {}
+
+	/**
+	 * Called when a target leaves the agent's range on a channel,
+	 * or when the agent is disabled while the target was inside.
+	 */
+	virtual void OnProximityEnd(EProximityChannel Channel, AActor* Target) {}
+};
@@ -4,12 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Interface/Proximity/ProximityListenerInterface.h"
 #include "ItemBase.generated.h"
 
 class USphereComponent;
 
 UCLASS()
-class RIOTWAVE_API AItemBase : public AActor {
+class RIOTWAVE_API AItemBase : public AActor, public IProximityListenerInterface {
 	GENERATED_BODY()
 
 public:
@@ -19,6 +20,8 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
 	
 	UFUNCTION()
 	void OnOverlapBegin( UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult );
@@ -29,14 +32,23 @@ protected:
 	UFUNCTION(BlueprintImplementableEvent)
 	void ItemPicked();
 
+	/** Plays the drop sound and sends the item flying, on a computed arc or as a rigid body */
 	void DropItem();
 
-	virtual void NotifyHit(class UPrimitiveComponent* MyComp, AActor* Other, class UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
-
-	void DIsablePhysics();
 public:
-	// Called every frame
-	virtual void Tick( float DeltaTime ) override;
+	virtual void OnProximityBegin( EProximityChannel Channel, AActor* Target ) override;
+
+	/** Moves a parked item to SpawnTransform, makes it visible and pickable again and drops it */
+	void OnAcquiredFromPool( const FTransform& SpawnTransform );
+
+	/** Hides the item, stops its physics and pickup detection and moves it out of the way */
+	void OnReturnedToPool( const FVector& ParkLocation );
+
+	FORCEINLINE UStaticMeshComponent* GetMesh() const { return Mesh; }
+
+	FORCEINLINE USphereComponent* GetCollisionSphere() const { return CollisionSphere; }
+
+	FORCEINLINE USoundBase* GetPickupSound() const { return PickupSound; }
 
 private:
 	UPROPERTY(VisibleAnywhere, Category = "Item")
@@ -54,5 +66,9 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Item", BlueprintReadOnly, meta=(AllowPrivateAccess = true))
 	TObjectPtr<USoundBase> PickupSound;
 
+	/** Drops as a simulated rigid body with a random impulse instead of flying a computed arc */
+	UPROPERTY(EditAnywhere, Category = "Item", BlueprintReadOnly, meta=(AllowPrivateAccess = true))
+	bool bSimulateDropPhysics = false;
+
 	
 };
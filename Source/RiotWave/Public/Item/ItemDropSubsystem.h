@@ -0,0 +1,223 @@
+// ItemDropSubsystem.h - Pooled item drops that follow a computed arc
+//
+// Every dropped item used to become a rigid body with a random impulse, and re-armed a
+// four second timer on each contact until it came to rest. In big waves the drops alone
+// filled the physics scene. Drops now fly a closed-form ballistic arc to a point found with
+// one ground trace, play a short settle bounce and come from per-class pools of parked items.
+// Once at rest they stop being actors: each item class draws its resting items as instances
+// of one hierarchical instanced static mesh, and they are picked up by instance index.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ItemDropSubsystem.generated.h"
+
+class AItemBase;
+class UHierarchicalInstancedStaticMeshComponent;
+class USoundBase;
+
+/** Free list of one item class */
+USTRUCT()
+struct FItemPoolBucket {
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AItemBase>> FreeItems;
+};
+
+/**
+* World subsystem that spawns, launches and recycles dropped items.
+*
+* Design Decisions:
+* - The landing point is picked first and traced once against world static geometry; the arc is then solved to hit it
+* - A second trace from the drop point to the landing point keeps arcs out of walls; blocked points are pulled back in front of the wall
+* - Arcs are evaluated in one tick over all items and moved without sweeps, since nothing may stop an item mid-flight
+* - Items with bSimulateDropPhysics, or every item with RiotWave.Items.ArcDrops 0, simulate as before but are frozen
+*   here once asleep or after MaxPhysicsTime instead of by a timer per contact
+* - Picked up items are parked hidden and collision-less like pooled enemies, and reused by the next drop of their class
+* - Items that came to rest become an instance of their class's HISM and their actor is parked, so only moving items are actors
+* - Instances keep their index for life; a picked up instance is scaled to zero and its index reused by the next item to land
+* - Resting items are picked up by a distance check against player pawns, since instances have no collision or proximity agent
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UItemDropSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when drops fly computed arcs (RiotWave.Items.ArcDrops) */
+	static bool AreArcsEnabled();
+
+	/** True when resting items are drawn as instances instead of actors (RiotWave.Items.Instancing) */
+	static bool IsInstancingEnabled();
+
+	/** Drops an item of ItemClass at Transform from WorldContextObject's pool, or spawns one when there is no pool */
+	static AItemBase* SpawnItem( const UObject* WorldContextObject, TSubclassOf<AItemBase> ItemClass, const FTransform& Transform );
+
+	/** Returns a parked item moved to Transform and dropped, or spawns a new one */
+	AItemBase* AcquireItem( TSubclassOf<AItemBase> ItemClass, const FTransform& Transform );
+
+	/** Stops a picked up item's drop and parks it for reuse. Destroys it if the pool is full */
+	void ReleaseItem( AItemBase* Item );
+
+	/** Starts Item on an arc from its current location. Called by AItemBase::DropItem */
+	void LaunchItem( AItemBase* Item );
+
+	/** Watches a simulating item and stops its physics once it sleeps or simulated for MaxPhysicsTime */
+	void AddPhysicsDrop( AItemBase* Item );
+
+	/** Picks up the resting instance Index of ItemClass: plays its pickup sound and frees the index */
+	void PickUpInstance( TSubclassOf<AItemBase> ItemClass, int32 Index );
+
+	/** Drops Count items of ItemClass on a grid around the first player, for comparing resting item cost */
+	void SpawnTestItems( TSubclassOf<AItemBase> ItemClass, int32 Count );
+
+	/** Writes arc, physics body, pool, instance and primitive counts to the log, followed by the world's timer listing */
+	void LogStats() const;
+
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	struct FItemArc {
+		TWeakObjectPtr<AItemBase> Item;
+
+		FVector Start = FVector::ZeroVector;
+
+		FVector Velocity = FVector::ZeroVector;
+
+		FRotator StartRotation = FRotator::ZeroRotator;
+
+		/** Downward acceleration, positive */
+		float Gravity = 0.0f;
+
+		/** Seconds from launch to touching the ground */
+		float FlightTime = 0.0f;
+
+		double LaunchTime = 0.0;
+	};
+
+	struct FPhysicsDrop {
+		TWeakObjectPtr<AItemBase> Item;
+
+		double StartTime = 0.0;
+	};
+
+	/** Resting items of one class */
+	struct FInstanceBucket {
+		TObjectPtr<UHierarchicalInstancedStaticMeshComponent> Component;
+
+		/** Pickup sphere centers by instance index */
+		TArray<FVector> PickupLocations;
+
+		/** Set for indices that hold a resting item, clear for picked up ones */
+		TBitArray<> Resting;
+
+		/** Indices of picked up instances, reused before adding new ones */
+		TArray<int32> FreeIndices;
+
+		float PickupRadius = 0.0f;
+
+		TObjectPtr<USoundBase> PickupSound;
+	};
+
+	/** Replaces a resting item actor with an instance and parks the actor. False when the item has no mesh */
+	bool ConvertToInstance( AItemBase* Item );
+
+	FInstanceBucket& FindOrAddInstanceBucket( const AItemBase* Item );
+
+	/** Picks up every resting instance a player pawn touches */
+	void PickUpTouchedInstances();
+
+	/** Location and rotation of Arc Time seconds after launch, including the settle bounce after landing */
+	void EvaluateArc( const FItemArc& Arc, float Time, FVector& OutLocation, FRotator& OutRotation ) const;
+
+	/**
+	* Drops Start + Offset onto the ground and checks the straight line from Start to the landing point for walls.
+	*
+	* @param OutClearFraction Share of the line from Start that is free of walls
+	* @return False when a wall blocks the line
+	*/
+	bool TraceLanding( const AItemBase* Item, const FVector& Start, const FVector2D& Offset, float PivotHeight, float& OutLandZ, float& OutClearFraction ) const;
+
+	/** Forgets any arc or physics drop of Item */
+	void StopDrop( const AItemBase* Item );
+
+	TArray<FItemArc> Arcs;
+
+	TArray<FPhysicsDrop> PhysicsDrops;
+
+	TMap<TObjectKey<UClass>, FInstanceBucket> InstanceBuckets;
+
+	/** Hosts the instanced mesh components */
+	UPROPERTY()
+	TObjectPtr<AActor> InstanceActor;
+
+	/** Parked items keyed by class */
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FItemPoolBucket> Buckets;
+
+	int32 TotalLaunched = 0;
+
+	int32 TotalPhysicsDrops = 0;
+
+	int32 TotalReused = 0;
+
+	int32 TotalSpawned = 0;
+
+	int32 TotalReleased = 0;
+
+	int32 TotalInstanced = 0;
+
+	int32 TotalInstancePickups = 0;
+
+	/** Landing points that had a wall in the way and were pulled back */
+	int32 TotalBlockedLandings = 0;
+
+	/** Horizontal distance from the drop point to the landing point */
+	UPROPERTY(Config)
+	float MinDropDistance = 60.0f;
+
+	UPROPERTY(Config)
+	float MaxDropDistance = 180.0f;
+
+	/** Height of the arc above the drop point */
+	UPROPERTY(Config)
+	float ApexHeight = 90.0f;
+
+	/** How far below the drop point the ground trace looks before the item lands at the drop height */
+	UPROPERTY(Config)
+	float GroundTraceDepth = 1000.0f;
+
+	/** Distance kept from a wall when a landing point is pulled back in front of it */
+	UPROPERTY(Config)
+	float WallClearance = 30.0f;
+
+	/** Seconds of damped bouncing after landing */
+	UPROPERTY(Config)
+	float SettleTime = 0.35f;
+
+	UPROPERTY(Config)
+	float SettleBounceHeight = 12.0f;
+
+	/** Yaw spin while in the air */
+	UPROPERTY(Config)
+	float SpinDegreesPerSecond = 360.0f;
+
+	/** Seconds a physics drop may simulate before it is frozen even if still moving */
+	UPROPERTY(Config)
+	float MaxPhysicsTime = 4.0f;
+
+	/** Where parked items wait */
+	UPROPERTY(Config)
+	FVector ParkLocation = FVector(0.0f, 0.0f, -50000.0f);
+
+	/** Upper bound of parked items per class; extra releases are destroyed */
+	UPROPERTY(Config)
+	int32 MaxPooledPerClass = 64;
+};
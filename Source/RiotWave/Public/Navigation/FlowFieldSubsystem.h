@@ -0,0 +1,199 @@
+// FlowFieldSubsystem.h - Shared flow fields towards players for chasing enemies
+//
+// A chasing enemy used to run its own MoveTo towards the player, so a horde of N chasers
+// meant N path queries, re-planned whenever the player moved. This subsystem builds one
+// grid per chased actor, fills it with the distance to that actor by a breadth-first
+// search over navmesh-projected cells, and stores the step towards the goal in every cell.
+// Chasers read their steering direction from the cell they stand in.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlowFieldSubsystem.generated.h"
+
+class ANavigationData;
+
+/** Aggregated flow field counters, printed by RiotWave.FlowField.Stats */
+struct FFlowFieldStats {
+	int32 Samples = 0;
+
+	/** Samples outside every field or on an unreachable cell; the caller falls back to pathfinding */
+	int32 SampleMisses = 0;
+
+	int32 Rebuilds = 0;
+
+	/** Ticks on which a field had a moved goal or new projections but the search was held back by the rate limits */
+	int32 DeferredSearches = 0;
+
+	double TotalRebuildMs = 0.0;
+
+	double MaxRebuildMs = 0.0;
+
+	/** Navmesh rebuilds that invalidated the cell cache */
+	int32 NavRebuilds = 0;
+
+	/** World time the counters started at, to report rates */
+	double StartTime = 0.0;
+
+	int32 NavProjections = 0;
+};
+
+/**
+* World subsystem that owns one flow field per chased actor.
+*
+* Design Decisions:
+* - Fields are created on the first sample for a target and dropped when nobody sampled them for a while
+* - Cell walkability is projected on the navmesh once and cached by world cell, so recentering only projects uncovered cells
+* - Projections are time-sliced per tick; the search itself only reruns when walkability changed or the goal moved
+* - A search is a full BFS over the grid (6561 cells at the default size), so every rerun is rate-limited and a field
+*   searches at most once per tick for all of its reasons together; LogStats reports searches and milliseconds per second
+* - Goal moves rerun the search once the target is GoalHysteresisCells away from the goal cell, smaller moves every
+*   GoalSearchInterval seconds; neither sooner than MinSearchInterval after the last search
+* - Projection batches are folded into one search when the field's queue drains, or every GoalSearchInterval while a
+*   large batch (a recenter or a navmesh rebuild) is still being worked off
+* - A recentered field searches on the same tick, since its old distances no longer match the grid
+* - The cell cache is dropped and every field re-projected when navmesh generation finishes
+* - The grid is a single layer around the target's height, which matches the arena layouts this game uses
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UFlowFieldSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** True when chasers should steer by flow field (RiotWave.FlowField.Enabled) */
+	static bool IsFlowFieldEnabled();
+
+	/**
+	* Looks up the steering direction towards Target at Location.
+	* Creates the target's field on first use; it becomes usable once its first search ran.
+	*
+	* @return False when Location is not covered by a reachable cell, callers should pathfind instead
+	*/
+	bool SampleDirection( AActor* Target, const FVector& Location, FVector& OutDirection );
+
+	/** Writes field counts, search cost per search and per second, and sample hit rate to the log */
+	void LogStats() const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+
+	virtual void Deinitialize() override;
+
+private:
+	enum class ECellState : uint8 {
+		Unknown,
+		Blocked,
+		Walkable
+	};
+
+	struct FFlowField {
+		TWeakObjectPtr<AActor> Target;
+
+		/** World cell of grid index (0, 0) */
+		FIntPoint OriginCell = FIntPoint::ZeroValue;
+
+		/** World cell the last search started from */
+		FIntPoint GoalCell = FIntPoint(MAX_int32, MAX_int32);
+
+		double LastSearchTime = 0.0;
+
+		/** Height the navmesh projections are centered on */
+		float CenterZ = 0.0f;
+
+		TArray<ECellState> States;
+
+		TArray<float> Heights;
+
+		/** Steps to the goal cell, MAX_uint16 when unreachable */
+		TArray<uint16> Distances;
+
+		/** Index into the neighbour offsets of the step towards the goal, INDEX_NONE on the goal or unreachable cells */
+		TArray<int8> Directions;
+
+		/** Grid indices still waiting for a navmesh projection */
+		TArray<int32> PendingCells;
+
+		double LastSampledTime = 0.0;
+
+		bool bNeedsSearch = true;
+
+		bool bHasSearched = false;
+	};
+
+	int32 GetFieldSize() const { return FieldHalfExtentCells * 2 + 1; }
+
+	FIntPoint ToCell( const FVector& Location ) const;
+
+	/** Moves the grid so it is centered on CenterCell, keeping known cells and queueing the new ones */
+	void RecenterField( FFlowField& Field, const FIntPoint& CenterCell ) const;
+
+	/** Orders pending cells so the ones closest to the field center are projected first */
+	void SortPendingCells( FFlowField& Field ) const;
+
+	/** Projects up to Budget pending cells on the navmesh, returns the number of projections done */
+	int32 ResolvePendingCells( FFlowField& Field, int32 Budget );
+
+	/** Breadth-first search from the goal cell over walkable cells, then picks a step direction per cell */
+	void SearchField( FFlowField& Field );
+
+	/** Drops the cell cache and queues every cell of every field for re-projection on the new navmesh */
+	UFUNCTION()
+	void HandleNavigationGenerationFinished( ANavigationData* NavData );
+
+	TArray<FFlowField> Fields;
+
+	/** Walkability per world cell, shared by all fields. Blocked cells hold -MAX_flt */
+	TMap<FIntPoint, float> CellHeightCache;
+
+	FFlowFieldStats Stats;
+
+	/** Edge length of a cell in world units */
+	UPROPERTY(Config)
+	float CellSize = 100.0f;
+
+	/** Cells from the center to the edge of a field; the field covers (2 * this + 1) cells per side */
+	UPROPERTY(Config)
+	int32 FieldHalfExtentCells = 40;
+
+	/** The field is recentered once its target walks this many cells away from the center */
+	UPROPERTY(Config)
+	int32 RecenterCells = 10;
+
+	/** Navmesh projections allowed per tick over all fields */
+	UPROPERTY(Config)
+	int32 MaxProjectionsPerTick = 512;
+
+	/** A search for a moved target runs at once when the target is this many cells away from the last goal cell */
+	UPROPERTY(Config)
+	int32 GoalHysteresisCells = 2;
+
+	/** Smaller goal moves and unfinished projection batches rerun the search at most this often, in seconds */
+	UPROPERTY(Config)
+	float GoalSearchInterval = 0.25f;
+
+	/** No search of a field reruns sooner than this after its last one, in seconds, except after a recenter */
+	UPROPERTY(Config)
+	float MinSearchInterval = 0.1f;
+
+	/** Height difference two neighbouring cells may have and still connect */
+	UPROPERTY(Config)
+	float MaxStepHeight = 60.0f;
+
+	/** Vertical half-extent of the navmesh projection around the field's height */
+	UPROPERTY(Config)
+	float ProjectionHalfHeight = 300.0f;
+
+	/** Seconds without samples after which a field is dropped */
+	UPROPERTY(Config)
+	float IdleFieldTimeout = 5.0f;
+
+	/** The cell cache is cleared when it grows past this many cells */
+	UPROPERTY(Config)
+	int32 MaxCachedCells = 200000;
+};
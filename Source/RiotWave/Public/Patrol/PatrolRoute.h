@@ -0,0 +1,41 @@
+// PatrolRoute.h - Level-placed patrol route shared by any number of enemies
+//
+// Enemies used to carry exactly two patrol points of their own. A route is a spline whose
+// control points are the stops; its navigation paths are computed once by
+// UPatrolRouteSubsystem and reused by every enemy walking it.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PatrolRoute.generated.h"
+
+class USplineComponent;
+
+/**
+* Patrol route actor.
+*
+* Design Decisions:
+* - Only the spline's control points are stops; the spline curve is an editing aid, the navmesh decides the actual path
+* - A closed spline loops, an open one is walked back and forth
+* - Paths are built in BeginPlay so the first enemy on the route does not pay for them
+*/
+UCLASS()
+class RIOTWAVE_API APatrolRoute : public AActor {
+	GENERATED_BODY()
+
+public:
+	APatrolRoute();
+
+	/** World space stops in walking order */
+	void GetRoutePoints( TArray<FVector>& OutPoints ) const;
+
+	bool IsClosedLoop() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	UPROPERTY(VisibleAnywhere, Category = "Patrol")
+	TObjectPtr<USplineComponent> Spline;
+};
@@ -0,0 +1,146 @@
+// PatrolRouteSubsystem.h - Computes patrol paths once and hands out copies
+//
+// The patrol branch used to pathfind on every leg, although the stops never move. Routes
+// are now resolved to navigation paths the first time they are used and every later leg
+// starts a move on a copy of the cached path, which costs no path query at all.
+// The subsystem also counts path queries made by enemies, to verify that claim.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AITypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PatrolRouteSubsystem.generated.h"
+
+class AAIController;
+class ANavigationData;
+class APatrolRoute;
+
+/**
+* Stops of a route and the cached path of every leg.
+*
+* Open routes are walked back and forth: legs 0 .. N-2 go forward and the remaining
+* legs walk the same paths in reverse. Closed routes have one leg per stop.
+*/
+struct RIOTWAVE_API FPatrolRoutePath {
+	TArray<FVector> Points;
+
+	/** Path points per leg. Empty when the navmesh had no path for that leg */
+	TArray<TArray<FVector>> Legs;
+
+	bool bClosedLoop = false;
+
+	int32 NumLegs() const { return Legs.Num(); }
+
+	int32 GetNextLeg( const int32 LegIndex ) const { return ( LegIndex + 1 ) % FMath::Max(Legs.Num(), 1); }
+
+	FVector GetLegStart( int32 LegIndex ) const;
+
+	FVector GetLegEnd( int32 LegIndex ) const;
+};
+
+/**
+* World subsystem that caches patrol paths and counts enemy path queries.
+*
+* Design Decisions:
+* - Route actors are cached by actor; loose point lists (the two patrol points on AEnemy) by their quantized points
+* - Reverse legs of open routes reuse the forward paths, so a route of N stops costs at most N queries ever
+* - Moves are started with RequestMove on a per-move copy, since path following may modify the path it walks
+* - Returned route pointers are only valid until the next FindOrBuildRoute call
+* - The loose point cache is bounded by MaxCachedPointRoutes and evicts its least recently used route when full,
+*   so the routes of enemies still patrolling survive a wave of one-off spawn points
+* - Only routes with at least one leg path are cached, so a request made before the navmesh exists is retried;
+*   routes with missing legs are dropped again whenever navmesh generation finishes
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UPatrolRouteSubsystem : public UWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Cached paths of a route actor, built on first use. Null when the route has fewer than two stops or no leg has a path yet */
+	const FPatrolRoutePath* FindOrBuildRoute( const APatrolRoute* Route );
+
+	/** Cached paths through loose world points, shared by every caller passing (nearly) the same points */
+	const FPatrolRoutePath* FindOrBuildRoute( const TArray<FVector>& Points, bool bClosedLoop );
+
+	/**
+	* Starts moving Controller along a cached leg.
+	*
+	* @return The move request id, invalid when the leg has no cached path or the move was rejected
+	*/
+	FAIRequestID RequestLegMove( AAIController* Controller, const FPatrolRoutePath& Route, int32 LegIndex, float AcceptanceRadius );
+
+	/** Called by AEnemyController whenever a move request needed a path query */
+	void RecordPathQuery();
+
+	/** Writes route and path query counts, including queries per second since the previous call, to the log */
+	void LogStats();
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+
+	virtual void Deinitialize() override;
+
+private:
+	/** Quantized stops identifying a loose point route */
+	struct FPointRouteKey {
+		TArray<FIntVector> Points;
+		bool bClosedLoop = false;
+
+		bool operator==( const FPointRouteKey& Other ) const { return bClosedLoop == Other.bClosedLoop && Points == Other.Points; }
+
+		friend uint32 GetTypeHash( const FPointRouteKey& Key ) {
+			uint32 Hash = GetTypeHash(Key.bClosedLoop);
+			for ( const FIntVector& Point : Key.Points ) { Hash = HashCombine(Hash, GetTypeHash(Point)); }
+			return Hash;
+		}
+	};
+
+	struct FPointRouteEntry {
+		FPatrolRoutePath Route;
+
+		/** Value of PointRouteUseCounter when the route was last found or built */
+		uint64 LastUse = 0;
+	};
+
+	/**
+	* Runs one path query per forward leg and fills Route.Legs.
+	*
+	* @return False when there is no navmesh yet or no leg found a path; the route must not be cached then
+	*/
+	bool BuildLegs( FPatrolRoutePath& Route );
+
+	UFUNCTION()
+	void HandleNavigationGenerationFinished( ANavigationData* NavData );
+
+	TMap<TObjectKey<APatrolRoute>, FPatrolRoutePath> ActorRoutes;
+
+	TMap<FPointRouteKey, FPointRouteEntry> PointRoutes;
+
+	/** Bumped on every loose point lookup, orders PointRoutes by recency */
+	uint64 PointRouteUseCounter = 0;
+
+	int32 EvictedPointRoutes = 0;
+
+	int32 RouteBuildQueries = 0;
+
+	int32 EnemyPathQueries = 0;
+
+	int32 CachedLegMoves = 0;
+
+	/** Snapshot taken by LogStats to report a rate */
+	int32 EnemyPathQueriesAtLastLog = 0;
+
+	double LastLogTime = 0.0;
+
+	/** Loose point routes are quantized to this many world units when matched */
+	UPROPERTY(Config)
+	float PointQuantization = 10.0f;
+
+	/** The loose point cache evicts its least recently used route beyond this many routes */
+	UPROPERTY(Config)
+	int32 MaxCachedPointRoutes = 1024;
+};
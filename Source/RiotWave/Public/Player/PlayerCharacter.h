@@ -54,12 +54,8 @@ protected:
      */
     virtual void BeginPlay() override;
 
-public: 
-    /** 
-     * Handles per-frame updates for continuous character behavior.
-     * @param DeltaTime - Time elapsed since last frame, used for smooth updates
-     */
-    virtual void Tick(float DeltaTime) override;
+    /** Removes the character from the proximity grid's targets */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
     /** 
@@ -109,6 +105,8 @@ private:
 
 public:
     void Death();
+
+    /** Receives enemy attacks through UDamageQueueSubsystem, summed once per frame */
     virtual float TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
     
 
@@ -119,4 +117,7 @@ public:
      * for animations and visual effects.
      */
     FORCEINLINE USkeletalMeshComponent* GetPlayerMesh() const { return PlayerMesh; }
+
+    /** Read by the first-person anim instance on worker threads, so kept to a plain field read */
+    FORCEINLINE bool IsDead() const { return Health <= 0.0f; }
 };
\ No newline at end of file
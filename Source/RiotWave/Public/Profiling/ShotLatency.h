@@ -0,0 +1,47 @@
+// ShotLatency.h - Input to shot latency markers and histograms
+//
+// How long a trigger press takes to become a trace, applied damage and visible effects is
+// the game's main responsiveness number. The fire path marks each stage of the first shot
+// after a press. Markers go to Unreal Insights as bookmarks and counters, and the latency of
+// every stage is aggregated into a histogram printed by RiotWave.ShotLatency.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Points on the path from a trigger press to a visible shot, in the order they happen */
+enum class EShotLatencyStage : uint8 {
+	/** UWeaponHandlingComponent::FIreWeapon started the shot */
+	Fire,
+	/** The center pellet's trace returned */
+	Trace,
+	/** The shot's queued damage was applied with TakeDamage */
+	Damage,
+	/** Muzzle, impact and beam effects were started */
+	Effects,
+	Num
+};
+
+/**
+* Records shot latency samples and prints their distribution.
+*
+* Design Decisions:
+* - Only the first shot after a press is measured; later shots of a held trigger come from the fire rate, not input
+* - Each shooter has at most one shot in flight, ended by its next shot or press, so a miss never leaves a stale damage stage open
+* - Histograms use fixed log-scale buckets, so recording is O(1) with no allocation and percentiles are exact to one 25% wide bucket
+* - Damage is applied where the server runs, so on a remote client only the Fire, Trace and Effects stages are recorded
+*/
+class RIOTWAVE_API FShotLatency {
+public:
+	/** A trigger press reached the player controller. Starts a new measured shot for Shooter */
+	static void MarkInput( const AActor* Shooter );
+
+	/** Shooter's measured shot reached Stage. Does nothing when no press is pending or the stage was already recorded */
+	static void MarkStage( EShotLatencyStage Stage, const AActor* Shooter );
+
+	/** Clears every histogram */
+	static void Reset();
+
+	/** Writes count, p50, p95, p99 and max latency of every stage to the log */
+	static void LogStats();
+};
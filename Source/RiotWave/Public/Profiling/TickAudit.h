@@ -0,0 +1,58 @@
+// TickAudit.h - Runtime report of registered tick functions and their cost
+//
+// A class that ticks every frame without needing to is easy to add and hard to notice
+// until there are hundreds of instances. RiotWave.TickAudit lists every registered tick
+// function and tickable world subsystem in the world, grouped by the RiotWave class that
+// owns it, and over a capture of a few frames times the RiotWave tick bodies against the
+// world's whole actor tick.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Captures and prints the tick audit.
+*
+* Design Decisions:
+* - Tick functions are grouped by the nearest native RiotWave class of their actor, so Blueprint subclasses roll up into the C++ class
+* - Components are listed under their owner's group by component class, since an enemy's movement and mesh ticks are part of its cost
+* - Tickable world subsystems tick outside the actor tick groups, so they are listed under their own WorldSubsystem group by class
+* - RiotWave tick bodies time themselves with FTickAuditScope; engine components are counted, their time is in the actor tick total
+* - Nothing is measured outside a capture, so the scopes can stay in shipping tick paths
+*/
+class RIOTWAVE_API FTickAudit {
+public:
+	/** True while RiotWave.TickAudit is capturing */
+	static bool IsCapturing();
+
+	/** Times the next Frames frames of World, then logs the report. 0 frames logs the listing at once */
+	static void StartCapture( UWorld* World, int32 Frames );
+
+	/** Adds one timed tick of Object to the running capture */
+	static void AddSample( const UObject* Object, uint64 Cycles );
+
+	/** Writes grouped tick functions of World and captured costs per frame to the log */
+	static void LogReport( UWorld* World );
+};
+
+/**
+* Times the enclosing tick body into a running tick audit, attributed to Object.
+* Costs one branch when no capture is running.
+*/
+struct FTickAuditScope {
+	explicit FTickAuditScope( const UObject* InObject ) {
+		if ( FTickAudit::IsCapturing() ) {
+			Object = InObject;
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	~FTickAuditScope() {
+		if ( Object ) { FTickAudit::AddSample(Object, FPlatformTime::Cycles64() - StartCycles); }
+	}
+
+private:
+	const UObject* Object = nullptr;
+
+	uint64 StartCycles = 0;
+};
@@ -0,0 +1,159 @@
+// ProximitySubsystem.h - Batched range checks between agents and targets on a uniform grid
+//
+// Enemies, weapons and items used to carry sphere components whose only job was to notice
+// the player walking into range. Every sphere generated overlap events against every pawn,
+// enemies included, which grows quadratically with horde size. This subsystem replaces
+// those spheres with one pass per tick over a spatial hash of the (few) targets.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interface/Proximity/ProximityListenerInterface.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ProximitySubsystem.generated.h"
+
+/**
+* Uniform 2D spatial hash of integer ids.
+*
+* Kept free of UObjects so the subsystem tick and the benchmark command share exactly
+* the same code path. Height is ignored for bucketing; callers do the exact 3D test.
+*/
+struct RIOTWAVE_API FProximityGrid {
+	explicit FProximityGrid( float InCellSize = 1000.0f ) : CellSize(InCellSize) {}
+
+	/** Clears all cells but keeps their allocations for the next rebuild */
+	void Reset();
+
+	void Add( int32 Id, const FVector& Location );
+
+	/** Visits every id whose cell overlaps the square around Center with half-size Radius */
+	template <typename VisitorType>
+	void ForEachInRadius( const FVector& Center, float Radius, VisitorType&& Visit ) const {
+		const FIntPoint Min = ToCell(Center - FVector(Radius));
+		const FIntPoint Max = ToCell(Center + FVector(Radius));
+		for ( int32 X = Min.X; X <= Max.X; ++X ) {
+			for ( int32 Y = Min.Y; Y <= Max.Y; ++Y ) {
+				if ( const TArray<int32>* Cell = Cells.Find(FIntPoint(X, Y)) ) {
+					for ( const int32 Id : *Cell ) { Visit(Id); }
+				}
+			}
+		}
+	}
+
+	FIntPoint ToCell( const FVector& Location ) const {
+		return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+	}
+
+	float CellSize;
+
+	TMap<FIntPoint, TArray<int32>> Cells;
+};
+
+/**
+* World subsystem that computes enter/exit transitions for registered agents.
+*
+* Design Decisions:
+* - Targets (players) are few and move every frame, so the grid is rebuilt over targets each tick
+* - Each agent keeps a bitmask of targets inside each channel; transitions are the XOR with the new mask
+* - Transitions are collected first and dispatched after the pass, so listeners may unregister or destroy freely
+* - Agents report positions through a scene component so physics-simulated meshes are tracked correctly
+*/
+UCLASS(Config = Game)
+class RIOTWAVE_API UProximitySubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Upper bound of targets, one bit per target in the per-agent masks */
+	static constexpr int32 MaxTargets = 64;
+
+	/** True when the grid should be used instead of overlap spheres (RiotWave.Proximity.UseGrid) */
+	static bool IsGridEnabled();
+
+	/** Applies the configured cell size to the grid */
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+
+	/**
+	* Registers or updates a range on an agent.
+	* The agent must implement IProximityListenerInterface to receive transitions.
+	*
+	* @param Agent - Actor that owns the range
+	* @param Channel - Which range this is
+	* @param Radius - Range in world units, measured to the edge of the target's radius
+	* @param LocationSource - Component whose location is used; defaults to the root component
+	*/
+	void RegisterAgent( AActor* Agent, EProximityChannel Channel, float Radius, USceneComponent* LocationSource = nullptr );
+
+	/** Removes an agent and all of its ranges. No end transitions are fired */
+	void UnregisterAgent( AActor* Agent );
+
+	/**
+	* Pauses or resumes an agent, e.g. while it is parked in a pool.
+	* Disabling fires end transitions for targets currently inside.
+	*/
+	void SetAgentEnabled( AActor* Agent, bool bEnabled );
+
+	/** Registers an actor that agents react to, usually a player character */
+	void RegisterTarget( AActor* Target, float Radius );
+
+	/** Removes a target. Fires end transitions for every agent range it is inside and frees its slot */
+	void UnregisterTarget( AActor* Target );
+
+	/** Runs the benchmark printed by RiotWave.Proximity.Benchmark */
+	void RunBenchmark( const TArray<int32>& AgentCounts ) const;
+
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	static constexpr int32 NumChannels = static_cast<int32>(EProximityChannel::Count);
+
+	struct FAgent {
+		TObjectKey<AActor> Key;
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<USceneComponent> LocationSource;
+		float Radius[NumChannels] = {};
+		uint64 InsideMask[NumChannels] = {};
+		bool bEnabled = true;
+	};
+
+	struct FTarget {
+		TWeakObjectPtr<AActor> Actor;
+		float Radius = 0.0f;
+	};
+
+	struct FTransition {
+		TWeakObjectPtr<AActor> Agent;
+		TWeakObjectPtr<AActor> Target;
+		EProximityChannel Channel;
+		bool bBegin;
+	};
+
+	void RemoveAgentAt( int32 AgentIndex );
+
+	/** Queues begin or end transitions for every bit set in Mask */
+	void QueueTransitions( const FAgent& Agent, EProximityChannel Channel, uint64 Mask, bool bBegin );
+
+	void DispatchTransitions();
+
+	TArray<FAgent> Agents;
+
+	TMap<TObjectKey<AActor>, int32> AgentIndexByActor;
+
+	/** Slot array; index is the bit used in FAgent::InsideMask */
+	TArray<FTarget> Targets;
+
+	TArray<FTransition> PendingTransitions;
+
+	FProximityGrid TargetGrid;
+
+	/** Largest registered target radius, added to query extents */
+	float MaxTargetRadius = 0.0f;
+
+	/** Grid cell edge in world units. Roughly the largest agent radius works best */
+	UPROPERTY(Config)
+	float CellSize = 1000.0f;
+};
@@ -0,0 +1,210 @@
+// WaveDirectorSubsystem.h - Drives enemy waves from native wave definitions
+//
+// Waves used to be spawned in one frame from Blueprint, so a large wave meant one long
+// game-thread hitch. The director turns every wave into a spawn queue and drains it under
+// a per-frame millisecond budget. Enemies are constructed with deferred spawning and finished
+// on a later frame, which spreads BeginPlay, InitPatrolPoint and InitOverlapEvents across frames.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WaveDirectorSubsystem.generated.h"
+
+class AEnemy;
+
+/** One batch of enemies of the same class within a wave */
+USTRUCT(BlueprintType)
+struct FWaveSpawnGroup {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave")
+	TSubclassOf<AEnemy> EnemyClass;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave", meta = (ClampMin = "0"))
+	int32 Count = 10;
+
+	/** Actors carrying this tag are used as spawn areas; enemies spawn at random points inside their bounds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave")
+	FName SpawnAreaTag = TEXT("EnemySpawnArea");
+
+	/** Seconds after the wave starts before the first enemy of this group is queued */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave", meta = (ClampMin = "0"))
+	float StartDelay = 0.0f;
+
+	/** Seconds between two enemies of this group. Zero lets the spawn budget decide the pace */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave", meta = (ClampMin = "0"))
+	float SpawnInterval = 0.0f;
+};
+
+/** A full wave: every group is queued when the wave starts */
+USTRUCT(BlueprintType)
+struct FWaveDefinition {
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave")
+	TArray<FWaveSpawnGroup> SpawnGroups;
+
+	/** Break before this wave starts, counted from the moment the previous wave is cleared */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Wave", meta = (ClampMin = "0"))
+	float DelayBeforeWave = 5.0f;
+};
+
+/**
+* Spawn cost measurements for one wave.
+* Used to prove that no single frame pays for the whole wave.
+*/
+USTRUCT(BlueprintType)
+struct FWaveTimings {
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	int32 WaveIndex = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	int32 EnemiesSpawned = 0;
+
+	/** Enemies served by the enemy pool instead of being spawned */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	int32 PoolHits = 0;
+
+	/** Enemies that started as horde proxies because they spawned far from every player */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	int32 ProxiesSpawned = 0;
+
+	/** Frames that did any spawn work for this wave */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	int32 FramesSpawning = 0;
+
+	/** Game-thread milliseconds spent spawning, summed over all frames */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	double TotalSpawnMs = 0.0;
+
+	/** Worst single frame; this is the hitch players would feel */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	double MaxFrameSpawnMs = 0.0;
+
+	/** World times in seconds */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	double StartTime = 0.0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	double SpawnCompleteTime = 0.0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wave")
+	double ClearedTime = 0.0;
+};
+
+/**
+* World subsystem that runs the wave loop and the time-sliced spawn queue.
+*
+* Design Decisions:
+* - Spawning is split into two steps (deferred construction, then FinishSpawning) that run on separate passes
+* - Pooled enemies from UEnemyPoolSubsystem are used first since reusing them is far cheaper than spawning
+* - The per-frame budget is a console variable so it can be tuned live while profiling
+* - Enemies spawned far from every player become UHordeSubsystem proxies and count as alive until killed
+*/
+UCLASS()
+class RIOTWAVE_API UWaveDirectorSubsystem : public UTickableWorldSubsystem {
+	GENERATED_BODY()
+
+public:
+	/** Starts running the given waves in order, replacing any waves in progress */
+	UFUNCTION(BlueprintCallable, Category = "Wave")
+	void StartWaves( const TArray<FWaveDefinition>& InWaves );
+
+	/** Stops the wave loop and drops pending spawns and horde proxies. Full enemies already alive are left alone but no longer counted */
+	UFUNCTION(BlueprintCallable, Category = "Wave")
+	void StopWaves();
+
+	UFUNCTION(BlueprintCallable, Category = "Wave")
+	int32 GetCurrentWaveIndex() const { return CurrentWaveIndex; }
+
+	/** Full enemies and horde proxies still alive in the current wave */
+	UFUNCTION(BlueprintCallable, Category = "Wave")
+	int32 GetAliveEnemyCount() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Wave")
+	TArray<FWaveTimings> GetWaveTimings() const { return WaveTimings; }
+
+	/** Writes the timings of every wave run so far to the log */
+	void LogWaveTimings() const;
+
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType( const EWorldType::Type WorldType ) const override;
+
+private:
+	/** A queued enemy waiting for its spawn time */
+	struct FPendingSpawn {
+		TSubclassOf<AEnemy> EnemyClass;
+		FTransform SpawnTransform;
+		double ReadyTime = 0.0;
+	};
+
+	/** An enemy that was constructed but has not run FinishSpawning yet */
+	struct FDeferredSpawn {
+		TWeakObjectPtr<AEnemy> Enemy;
+		FTransform SpawnTransform;
+	};
+
+	enum class EWavePhase : uint8 {
+		Idle,
+		WaitingForWave,
+		Spawning,
+		InProgress
+	};
+
+	/** Builds the spawn queue for the current wave */
+	void BeginWave();
+
+	/** Drains deferred and pending spawns until the frame budget runs out */
+	void ProcessSpawnQueue( double WorldTime );
+
+	/** Picks a random point inside one of the tagged spawn areas */
+	bool PickSpawnTransform( const TArray<AActor*>& SpawnAreas, FTransform& OutTransform ) const;
+
+	/** Starts tracking an enemy for wave completion */
+	void TrackEnemy( AEnemy* Enemy );
+
+	/** Stops counting Enemy and drops the bindings made by TrackEnemy. Safe to call for untracked enemies */
+	void UntrackEnemy( AEnemy* Enemy );
+
+	/** Promotions only count while a wave run is active; proxies promoted after StopWaves belong to no wave */
+	void HandleEnemyPromoted( AEnemy* Enemy );
+
+	void HandleEnemyDied( AEnemy* Enemy );
+
+	/** A demoted enemy lives on as a proxy, so it stops counting as a full enemy without dying */
+	void HandleEnemyDemoted( AEnemy* Enemy );
+
+	/** Enemies destroyed without dying (level scripts, kill volumes) would otherwise hold the wave open forever */
+	UFUNCTION()
+	void HandleEnemyDestroyed( AActor* DestroyedActor );
+
+	UPROPERTY()
+	TArray<FWaveDefinition> Waves;
+
+	TArray<FPendingSpawn> PendingSpawns;
+
+	/** First entry of PendingSpawns that has not been processed, avoids shifting the array */
+	int32 PendingSpawnCursor = 0;
+
+	TArray<FDeferredSpawn> DeferredSpawns;
+
+	UPROPERTY()
+	TArray<FWaveTimings> WaveTimings;
+
+	EWavePhase Phase = EWavePhase::Idle;
+
+	int32 CurrentWaveIndex = INDEX_NONE;
+
+	/** Full enemies alive in the current wave; proxies are counted by UHordeSubsystem */
+	TArray<TWeakObjectPtr<AEnemy>> TrackedEnemies;
+
+	/** World time at which the next wave starts while waiting */
+	double NextWaveTime = 0.0;
+};
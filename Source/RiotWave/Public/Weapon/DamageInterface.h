@@ -21,5 +21,5 @@ class RIOTWAVE_API IDamageInterface {
 	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
 public:
 	UFUNCTION( Category = "Damage" )
-	virtual void BulletHit( FHitResult HitResult ) {};	
+	virtual void BulletHit( const FHitResult& HitResult ) {};	
 };
@@ -0,0 +1,51 @@
+// FireScheduler.h - Frame rate independent trigger timing
+//
+// Firing used to happen once per frame while the trigger was held, so the rate of fire
+// followed the frame rate. The scheduler instead accumulates frame time against the
+// weapon's shot interval: a frame can produce zero, one or several shots, each with the
+// time that has passed since it was actually due.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Shot timing for one trigger.
+*
+* Design Decisions:
+* - Plain struct with no engine dependencies, so automation tests and RiotWave.Weapon.FireRateCheck can drive it with synthetic frame times
+* - Pressing fires at once when the weapon is ready; holding an automatic weapon fires on the interval after that
+* - Releasing the trigger does not bank time, so tapping can never fire faster than the rate of fire
+*/
+struct RIOTWAVE_API FFireScheduler {
+	/** Sets the rate of fire. Semi-automatic weapons fire once per press, still limited to RoundsPerMinute */
+	void Configure( float RoundsPerMinute, bool bInAutomatic );
+
+	/** Trigger pressed. Returns true when a shot is due right now */
+	bool Press();
+
+	void Release();
+
+	/**
+	* Advances the clock by DeltaTime and appends, for every shot that became due,
+	* how many seconds ago it was due. Ages are appended oldest first.
+	*/
+	void Advance( float DeltaTime, TArray<float, TInlineAllocator<8>>& OutShotAges );
+
+	bool IsHeld() const { return bHeld; }
+
+	/** True when a press would fire at once, i.e. the last shot's interval has run out */
+	bool IsReady() const { return TimeUntilReady <= 0.0f; }
+
+	float GetShotInterval() const { return ShotInterval; }
+
+private:
+	float ShotInterval = 0.1f;
+
+	/** Seconds until the next shot may fire, zero or less when ready */
+	float TimeUntilReady = 0.0f;
+
+	bool bHeld = false;
+
+	bool bAutomatic = true;
+};
@@ -9,10 +9,13 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Interface/Proximity/ProximityListenerInterface.h"
 #include "WeaponBase.generated.h"
 
 class APlayerCharacter;
 class USphereComponent;
+class UWeaponDefinition;
+struct FStreamableHandle;
 
 /**
 * Base weapon actor that handles core weapon functionality.
@@ -25,7 +28,7 @@ class USphereComponent;
 * - Networked weapon replication
 */
 UCLASS()
-class RIOTWAVE_API AWeaponBase : public AActor {
+class RIOTWAVE_API AWeaponBase : public AActor, public IProximityListenerInterface {
    GENERATED_BODY()
 
 public:
@@ -59,6 +62,9 @@ protected:
     */
    virtual void BeginPlay() override;
 
+   /** Removes the weapon from the proximity grid */
+   virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
    /**
     * Blueprint event for weapon pickup customization.
     * Made BlueprintImplementableEvent to allow designers to:
@@ -72,13 +78,44 @@ protected:
 
 public:
    /** 
-    * Frame update handler.
-    * Kept virtual to allow derived weapons to add continuous behaviors
-    * like automatic fire, heat management, or charge-up effects.
+    * Pickup notification from UProximitySubsystem.
+    * Forwards to the same handler the pickup sphere overlap uses.
+    */
+   virtual void OnProximityBegin(EProximityChannel Channel, AActor* Target) override;
+
+   /** Releases the definition's streamed assets once the last player leaves the streaming range */
+   virtual void OnProximityEnd(EProximityChannel Channel, AActor* Target) override;
+
+   /** 
+    * Logs every weapon in World with its definition, streaming state, async load time
+    * and resident asset memory, with totals for inline and definition weapons.
+    * Backs RiotWave.Weapons.AssetStats.
     */
-   virtual void Tick(float DeltaTime) override;
+   static void LogAssetStats(UWorld* World);
 
 private:
+   /** Starts the async load of the definition's soft assets unless it is already running or done */
+   void RequestDefinitionAssets();
+
+   /** Cancels or releases the streamed assets so they can be garbage collected */
+   void ReleaseDefinitionAssets();
+
+   /** Streamable callback, records how long the load took */
+   void OnDefinitionAssetsLoaded();
+
+   /** Keeps the definition's assets resident while the player is near. Handed to the player's weapon component on pickup */
+   TSharedPtr<FStreamableHandle> DefinitionAssetHandle;
+
+   /** When the current load was requested, from FPlatformTime::Seconds */
+   double AssetRequestSeconds = 0.0;
+
+   /** Players inside the AssetStreaming range; the assets are released when it drops back to zero */
+   int32 StreamingTargetsInRange = 0;
+
+   /** Duration of the last completed load, negative until one completes */
+   double AssetLoadMs = -1.0;
+
+
    /** Root scene component for transform hierarchy */
    UPROPERTY(VisibleAnywhere)
    TObjectPtr<USceneComponent> DefaultSceneRoot;
@@ -109,6 +146,21 @@ private:
    UPROPERTY(EditAnywhere, Category = "Weapon")
    TObjectPtr<USoundBase> PickupSound;
 
+   /** 
+    * Data asset with this weapon's stats and soft FX and montage references.
+    * When set it replaces every inline property below, and its assets are only
+    * loaded while a player is within AssetStreamingRadius or holds the weapon.
+    */
+   UPROPERTY(EditAnywhere, Category = "Weapon")
+   TObjectPtr<UWeaponDefinition> WeaponDefinition;
+
+   /** 
+    * Distance at which the definition's assets start streaming in. Large enough that
+    * they are resident before a running player reaches the pickup sphere.
+    */
+   UPROPERTY(EditAnywhere, Category = "Weapon", meta = (ClampMin = "0"))
+   float AssetStreamingRadius = 3000.0f;
+
    // Weapon firing effects - separated for easy customization per weapon type
    /** Particle system for barrel flash when firing */
    UPROPERTY(EditAnywhere, Category = "Weapon|WeaponFX")
@@ -140,6 +192,40 @@ private:
    UPROPERTY(EditAnywhere, Category = "Weapon")
    float HeadshotMultiplier;
 
+   /** 
+    * Traces per trigger pull. Above 1 the weapon fires a spread of pellets,
+    * each dealing BaseDamage, e.g. a shotgun.
+    */
+   UPROPERTY(EditAnywhere, Category = "Weapon", meta = (ClampMin = "1"))
+   int32 PelletCount = 1;
+
+   /** Full cone angle in degrees the pellets are scattered over. The first pellet always flies straight */
+   UPROPERTY(EditAnywhere, Category = "Weapon", meta = (ClampMin = "0", ClampMax = "90"))
+   float PelletSpread = 0.0f;
+
+   /** 
+    * Muzzle velocity of simulated bullets in units per second.
+    * 0 keeps the weapon hitscan; above 0 every pellet becomes a projectile in UProjectileSubsystem.
+    */
+   UPROPERTY(EditAnywhere, Category = "Weapon|Projectile", meta = (ClampMin = "0"))
+   float ProjectileSpeed = 0.0f;
+
+   /** Multiplier on world gravity for this weapon's bullets */
+   UPROPERTY(EditAnywhere, Category = "Weapon|Projectile")
+   float ProjectileGravityScale = 1.0f;
+
+   /** Seconds a bullet flies before it is dropped without hitting anything */
+   UPROPERTY(EditAnywhere, Category = "Weapon|Projectile", meta = (ClampMin = "0"))
+   float ProjectileLifetime = 3.0f;
+
    UPROPERTY(EditAnywhere, Category = "Weapon")
    TObjectPtr<UAnimMontage> WeaponFIreMontage;
+
+   /** Shots per minute while the trigger is held, independent of frame rate */
+   UPROPERTY(EditAnywhere, Category = "Weapon", meta = (ClampMin = "1"))
+   float RoundsPerMinute = 600.0f;
+
+   /** Keeps firing while the trigger is held. Semi-automatic weapons fire once per press */
+   UPROPERTY(EditAnywhere, Category = "Weapon")
+   bool bAutomatic = true;
 };
\ No newline at end of file
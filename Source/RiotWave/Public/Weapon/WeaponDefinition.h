@@ -0,0 +1,86 @@
+// WeaponDefinition.h - Data asset describing one weapon type
+//
+// Stats and FX used to be hard pointers on every placed AWeaponBase, so loading a map
+// loaded every effect, sound and montage of every weapon in it. A weapon now points at a
+// definition whose assets are soft references: AWeaponBase streams them in through the
+// Asset Manager when a player comes near and lets them go again when the player leaves.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WeaponDefinition.generated.h"
+
+class UAnimMontage;
+class UParticleSystem;
+class USoundBase;
+struct FInitWeaponProperties;
+
+/**
+* Primary data asset with the stats and soft asset references of a weapon type.
+*
+* Design Decisions:
+* - Stats are plain values since they cost nothing to keep loaded; everything with a render or audio payload is soft
+* - Registered with the Asset Manager as WeaponDefinition, so definitions can be listed and audited without loading the assets
+* - The definition only describes; loading and releasing is owned by the weapon that needs the assets
+*/
+UCLASS(BlueprintType)
+class RIOTWAVE_API UWeaponDefinition : public UPrimaryDataAsset {
+	GENERATED_BODY()
+
+public:
+	static const FPrimaryAssetType PrimaryAssetType;
+
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+	/** Soft paths of every asset the weapon needs once fired, for a streamable request */
+	void GetStreamedAssets( TArray<FSoftObjectPath>& OutPaths ) const;
+
+	/** Fills OutProperties from the stats and whichever soft assets are currently loaded */
+	void BuildWeaponProperties( FInitWeaponProperties& OutProperties ) const;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|WeaponFX")
+	TSoftObjectPtr<UParticleSystem> MuzzleFlash;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|WeaponFX")
+	TSoftObjectPtr<UParticleSystem> ImpactParticle;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|WeaponFX")
+	TSoftObjectPtr<UParticleSystem> BeamTraceParticle;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|WeaponFX")
+	TSoftObjectPtr<USoundBase> FireSound;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	TSoftObjectPtr<UAnimMontage> FireMontage;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|WeaponFX")
+	FName WeaponSocketName = "Barrel Socket";
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float BaseDamage = 0.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	float HeadshotMultiplier = 1.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = "1"))
+	int32 PelletCount = 1;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = "0", ClampMax = "90"))
+	float PelletSpread = 0.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = "1"))
+	float RoundsPerMinute = 600.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon")
+	bool bAutomatic = true;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|Projectile", meta = (ClampMin = "0"))
+	float ProjectileSpeed = 0.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|Projectile")
+	float ProjectileGravityScale = 1.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon|Projectile", meta = (ClampMin = "0"))
+	float ProjectileLifetime = 3.0f;
+};
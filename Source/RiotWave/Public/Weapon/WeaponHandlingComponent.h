@@ -8,6 +8,9 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Weapon/FireScheduler.h"
+#include "WorldCollision.h"
 #include "WeaponHandlingComponent.generated.h"
 
 /**
@@ -32,14 +35,21 @@ struct FInitWeaponProperties {
 		Damage = 0.0f;
 		HSMultiplier = 1.0f;
 		WeaponFire = nullptr;
+		PelletCount = 1;
+		PelletSpread = 0.0f;
+		ProjectileSpeed = 0.0f;
+		ProjectileGravityScale = 1.0f;
+		ProjectileLifetime = 3.0f;
+		RoundsPerMinute = 600.0f;
+		bAutomatic = true;
 	}
 
 	/** 
 	* Convenience constructor for initializing all properties at once.
 	* Parameters named distinctly from members to avoid shadowing.
 	*/
-	FInitWeaponProperties( UParticleSystem* MFlash, UParticleSystem* IParticle, UParticleSystem* BTParticle, USoundBase* FSound, const FName SocketName, float WDamage, float HMultiplier, UAnimMontage* WFIre ) :
-		WeaponSocketName(SocketName), MuzzleFlash(MFlash), ImpactParticle(IParticle), BeamTraceParticle(BTParticle), FireSound(FSound), Damage(WDamage), HSMultiplier(HMultiplier), WeaponFire(WFIre)  {}
+	FInitWeaponProperties( UParticleSystem* MFlash, UParticleSystem* IParticle, UParticleSystem* BTParticle, USoundBase* FSound, const FName SocketName, float WDamage, float HMultiplier, UAnimMontage* WFIre, int32 PCount = 1, float PSpread = 0.0f ) :
+		WeaponSocketName(SocketName), MuzzleFlash(MFlash), ImpactParticle(IParticle), BeamTraceParticle(BTParticle), FireSound(FSound), Damage(WDamage), HSMultiplier(HMultiplier), WeaponFire(WFIre), PelletCount(PCount), PelletSpread(PSpread)  {}
 
 	/** Socket name for effect spawn location */
 	FName WeaponSocketName;
@@ -68,9 +78,63 @@ struct FInitWeaponProperties {
 
 	UPROPERTY()
 	TObjectPtr<UAnimMontage> WeaponFire;
+
+	/** Traces per trigger pull */
+	UPROPERTY()
+	int32 PelletCount;
+
+	/** Full cone angle in degrees the extra pellets are scattered over */
+	UPROPERTY()
+	float PelletSpread;
+
+	/** Bullet speed, 0 for hitscan */
+	UPROPERTY()
+	float ProjectileSpeed;
+
+	UPROPERTY()
+	float ProjectileGravityScale;
+
+	UPROPERTY()
+	float ProjectileLifetime;
+
+	UPROPERTY()
+	float RoundsPerMinute;
+
+	UPROPERTY()
+	bool bAutomatic;
 };
 
 class APlayerCharacter;
+class UWeaponDefinition;
+struct FStreamableHandle;
+
+/**
+* One carried weapon: its attachment mesh and everything needed to fire it.
+*
+* The mesh component is created and registered when the handling component begins play,
+* so picking up and swapping weapons only changes which slot's mesh is active.
+*/
+USTRUCT()
+struct FWeaponSlot {
+	GENERATED_BODY()
+
+	/** Attached to the grip point up front, hidden and inactive while the slot is not equipped */
+	UPROPERTY()
+	TObjectPtr<USkeletalMeshComponent> MeshComponent;
+
+	/** Stats and FX applied to the handling component when the slot is equipped */
+	UPROPERTY()
+	FInitWeaponProperties Properties;
+
+	/** Definition the slot was filled from, null for weapons set up from inline properties */
+	UPROPERTY()
+	TObjectPtr<const UWeaponDefinition> Definition;
+
+	/** Keeps the definition's streamed FX and montage resident for as long as the weapon is carried */
+	TSharedPtr<FStreamableHandle> AssetHandle;
+
+	bool bOccupied = false;
+};
 
 /**
 * Component that manages weapon functionality when equipped by a player.
@@ -89,21 +153,65 @@ public:
 	/** Sets up default component state */
 	UWeaponHandlingComponent();
 
-	/** Handles weapon firing logic and effect triggering */
-	void FIreWeapon();
+	/** Trigger pressed; shots then follow the weapon's rate of fire until StopFiring */
+	void StartFiring();
+
+	void StopFiring();
+
+	/** 
+	* Fires one shot: handles weapon firing logic and effect triggering.
+	* ShotAge is how many seconds ago the scheduler had this shot due, within the current frame.
+	*/
+	void FIreWeapon( float ShotAge = 0.0f );
 
-	/** Attaches weapon mesh to the owning actor */
+	/** 
+	* Puts a picked up weapon's mesh into the first free slot, or the equipped slot when all are full,
+	* and equips that slot. The following Initialize call fills in the slot's properties.
+	*/
 	void AttachComponentMeshToActor( USkeletalMesh* Mesh );
 
-	/** Sets up all weapon effects from provided data */
+	/** Sets up all weapon effects of the equipped slot from provided data */
 	void InitializeWeaponProperties( const FInitWeaponProperties& Effects );
 
+	/** 
+	* Sets up the equipped slot from a definition. Stats apply at once; FX and the montage apply
+	* when AssetHandle completes, and stay resident for as long as the weapon is carried.
+	* A null handle starts a new load, e.g. when the pickup was never streamed in.
+	*/
+	void InitializeWeaponDefinition( const UWeaponDefinition* Definition, TSharedPtr<FStreamableHandle> AssetHandle );
+
+	/** 
+	* Makes a carried weapon the active one. Only toggles mesh visibility and activation and
+	* copies the slot's properties, so it never allocates or registers components.
+	* Returns false when the slot is empty or out of range.
+	*/
+	bool EquipSlot( int32 SlotIndex );
+
+	/** Equips the next occupied slot after the active one, wrapping around */
+	void EquipNextSlot();
+
+	/** Index of the equipped slot, INDEX_NONE until the first pickup */
+	int32 GetActiveSlot() const { return ActiveSlot; }
+
+	/** 
+	* Swaps through every carried weapon NumSwaps times and logs the UObjects, components and
+	* registrations created meanwhile, which should all be zero. Backs RiotWave.Weapon.SwapCheck,
+	* a manual check in a live game; Tests/WeaponSwapTest.cpp asserts the same.
+	*/
+	void RunSwapCheck( int32 NumSwaps );
+
 	/** 
 	* Performs trace to determine bullet impact point.
 	* Returns true if trace hit something, false otherwise.
 	*/
 	bool PerformWorldTrace( FVector& EndTrace, FHitResult& OutHitResult ) const;
 
+	/** 
+	* Computes the ray through the crosshair.
+	* Returns false when there is no viewport or player controller to aim with.
+	*/
+	bool GetAimRay( FVector& OutStart, FVector& OutDirection ) const;
+
 	/** Handles playing all weapon effects at appropriate locations */
 	void PlayWeaponEffects(
 			const FHitResult& HitResult,
@@ -111,12 +219,21 @@ public:
 			FName SocketEffectName
 			) const;
 
+	/** Muzzle flash at the effect socket */
+	void PlayMuzzleEffects( FName SocketEffectName ) const;
+
+	/** Impact and beam effects of a single pellet, without the muzzle flash */
+	void PlayPelletEffects( const FHitResult& HitResult, const FVector& EndEffectLocation, FName SocketEffectName ) const;
+
 protected:
-	/** Runtime initialization and player reference setup */
+	/** Runtime initialization and player reference setup, creates the weapon slots */
 	virtual void BeginPlay() override;
 
+	/** Lets go of every carried weapon's streamed assets */
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 public:
-	/** Frame update for continuous weapon behavior */
+	/** Advances the fire scheduler; only enabled from StartFiring until the trigger is released and the weapon has cycled */
 	virtual void TickComponent(
 			float DeltaTime,
 			ELevelTick TickType,
@@ -124,7 +241,69 @@ public:
 			) override;
 
 private:
-	/** Visual mesh for the equipped weapon */
+	/** Creates, registers and attaches one hidden mesh component per slot */
+	void CreateWeaponSlots();
+
+	/** Copies a slot's properties into the cached members used while firing */
+	void ApplyWeaponProperties( const FInitWeaponProperties& Effects );
+
+	/** Creates the effect pools of a weapon, so its first shot does not allocate */
+	void PrewarmWeaponEffects( const FInitWeaponProperties& Effects ) const;
+
+	/** Shows and activates, or hides and deactivates, a slot's mesh */
+	static void SetSlotMeshActive( const FWeaponSlot& Slot, bool bActive );
+
+	/** 
+	* Applies a pellet's hit: BulletHit on damageable actors and damage on enemies.
+	* Shared by the synchronous center pellet and the async pellets.
+	*/
+	void ResolvePelletHit( const FHitResult& HitResult );
+
+	/** 
+	* Queues an async trace for one scattered pellet.
+	* All pellets of a trigger pull are submitted in the same frame, so the engine batches them.
+	*/
+	void QueuePelletTrace( const FVector& Start, const FVector& Direction );
+
+	/** 
+	* Sent by clients instead of applying hits locally. The server traces every direction
+	* against enemies rewound to ClientTime, so it judges the shot as the client saw it.
+	* ClientTime is the server time of the enemy poses on the client's screen when the shot was due,
+	* from ULagCompensationSubsystem::GetClientViewTime.
+	*/
+	UFUNCTION(Server, Reliable)
+	void ServerFireShot( FVector_NetQuantize TraceStart, const TArray<FVector_NetQuantizeNormal>& Directions, double ClientTime );
+
+	/** Fires one simulated bullet per pellet instead of tracing, for weapons with a ProjectileSpeed */
+	void FireProjectiles( float ShotAge );
+
+	/** Hands the bullets to UProjectileSubsystem. Authority only */
+	void SpawnProjectiles( const FVector& Start, TConstArrayView<FVector_NetQuantizeNormal> Directions, float ShotAge );
+
+	/** Sent by clients firing a projectile weapon, since bullets are only simulated where hits can be applied */
+	UFUNCTION(Server, Reliable)
+	void ServerFireProjectiles( FVector_NetQuantize Start, const TArray<FVector_NetQuantizeNormal>& Directions, float ShotAge );
+
+	/** Async trace callback, runs on the game thread during the frame after the shot */
+	void OnPelletTraceCompleted( const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum );
+
+	/** Turns trigger state and frame time into shots at the weapon's rate of fire */
+	FFireScheduler FireScheduler;
+
+	/** Bound once and reused by every pellet trace */
+	FTraceDelegate PelletTraceDelegate;
+
+	/** How many weapons the player can carry. Every slot's mesh component exists from BeginPlay */
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon", meta = (ClampMin = "1"))
+	int32 NumWeaponSlots = 3;
+
+	UPROPERTY()
+	TArray<FWeaponSlot> WeaponSlots;
+
+	/** Index into WeaponSlots of the equipped weapon, INDEX_NONE until the first pickup */
+	int32 ActiveSlot = INDEX_NONE;
+
+	/** Visual mesh for the equipped weapon, the active slot's mesh component */
 	UPROPERTY(VisibleAnywhere, Category = "Weapon")
 	TObjectPtr<USkeletalMeshComponent> WeaponMeshComponent;
 
@@ -158,6 +337,21 @@ private:
 	UPROPERTY()
 	TObjectPtr<UAnimMontage> WeaponFireMontage;
 
+	UPROPERTY()
+	int32 PelletCount = 1;
+
+	UPROPERTY()
+	float PelletSpread = 0.0f;
+
+	UPROPERTY()
+	float ProjectileSpeed = 0.0f;
+
+	UPROPERTY()
+	float ProjectileGravityScale = 1.0f;
+
+	UPROPERTY()
+	float ProjectileLifetime = 3.0f;
+
 public:
 	/** 
 	* Provides access to weapon mesh for animations.
@@ -3,4 +3,6 @@
 #include "RiotWave.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogRiotWave);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, RiotWave, "RiotWave" );
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+/** Project-wide log category used by the gameplay subsystems */
+DECLARE_LOG_CATEGORY_EXTERN(LogRiotWave, Log, All);